@@ -12,6 +12,13 @@
 #include <array>
 
 #include "Utils.hpp"
+#include "CommandAllocator.hpp"
+#include "BindlessTextureTable.hpp"
+#include "SamplerCache.hpp"
+#include "HostImageCopy.hpp"
+#include "DynamicGeometry.hpp"
+#include "PipelineCache.hpp"
+#include "ComputeMipGenerator.hpp"
 
 /**
  * @struct VulkanContext
@@ -36,6 +43,33 @@
  *
  * @var VulkanContext::graphicsQueueFamilyIndex
  * The index of the queue family that supports graphics operations.
+ *
+ * @var VulkanContext::commandAllocator
+ * The frame-scoped transient command allocator shared by uploads and frame recording.
+ *
+ * @var VulkanContext::capabilities
+ * The optional device features enabled on the logical device.
+ *
+ * @var VulkanContext::bindlessTextureTable
+ * The bindless texture array, null when the device lacks descriptor indexing.
+ *
+ * @var VulkanContext::samplerCache
+ * The cache sharing samplers between textures sampled the same way.
+ *
+ * @var VulkanContext::hostImageCopy
+ * The host image copy helper, null when the device lacks VK_EXT_host_image_copy.
+ *
+ * @var VulkanContext::dynamicGeometry
+ * The ring streaming per-frame vertices and indices, null when the context has no frame loop.
+ *
+ * @var VulkanContext::pipelineCache
+ * The pipeline cache persisted across runs, given to every pipeline creation.
+ *
+ * @var VulkanContext::resourceStateTracker
+ * The layout and access state of the images, shared by every upload recording barriers.
+ *
+ * @var VulkanContext::computeMipGenerator
+ * The compute mip generator, null when its compiled shaders are missing.
  */
 #ifdef __VK__
     struct  VulkanContext{
@@ -47,6 +81,15 @@
         VkSurfaceKHR surface;
         GLFWwindow* window;
         VkSampleCountFlagBits msaaSamples;
+        std::shared_ptr<maverik::CommandAllocator> commandAllocator;
+        maverik::Utils::DeviceCapabilities capabilities;
+        std::shared_ptr<maverik::BindlessTextureTable> bindlessTextureTable;
+        std::shared_ptr<maverik::SamplerCache> samplerCache;
+        std::shared_ptr<maverik::HostImageCopy> hostImageCopy;
+        std::shared_ptr<maverik::DynamicGeometry> dynamicGeometry;
+        std::shared_ptr<maverik::PipelineCache> pipelineCache;
+        std::shared_ptr<maverik::ResourceStateTracker> resourceStateTracker;
+        std::shared_ptr<maverik::ComputeMipGenerator> computeMipGenerator;
     };
 #elif __XR__
     struct  VulkanContext{
@@ -56,8 +99,17 @@
         VkCommandPool commandPool;
         uint32_t graphicsQueueFamilyIndex;
         VkSampleCountFlagBits msaaSamples;
+        std::shared_ptr<maverik::CommandAllocator> commandAllocator;
+        maverik::Utils::DeviceCapabilities capabilities;
+        std::shared_ptr<maverik::BindlessTextureTable> bindlessTextureTable;
+        std::shared_ptr<maverik::SamplerCache> samplerCache;
+        std::shared_ptr<maverik::HostImageCopy> hostImageCopy;
+        std::shared_ptr<maverik::DynamicGeometry> dynamicGeometry;
+        std::shared_ptr<maverik::PipelineCache> pipelineCache;
+        std::shared_ptr<maverik::ResourceStateTracker> resourceStateTracker;
+        std::shared_ptr<maverik::ComputeMipGenerator> computeMipGenerator;
     };
-    
+
 #endif
 
 namespace maverik {
@@ -74,6 +126,15 @@ namespace maverik {
                 return _vulkanContext;
             }
 
+            /**
+             * @brief Retrieves the optional features enabled on the logical device.
+             *
+             * @return A constant reference to the capabilities of the device.
+             */
+            const Utils::DeviceCapabilities& getCapabilities() const {
+                return _capabilities;
+            }
+
         private:
             /**
              * @brief Chooses the most suitable surface format for the swapchain.
@@ -134,6 +195,83 @@ namespace maverik {
              */
             virtual void createCommandPool();
 
+            /**
+             * @brief Creates the frame-scoped transient command allocator.
+             *
+             * This function creates one transient command pool per frame in flight on the
+             * graphics queue family. Single-time uploads and per-frame command buffers are
+             * then handed out by the allocator instead of being allocated and freed each time.
+             *
+             * @param framesInFlight The number of frames that can be recorded concurrently.
+             *
+             * @note Must be called after the logical device has been created.
+             */
+            void createCommandAllocator(uint32_t framesInFlight);
+
+            /**
+             * @brief Creates the bindless texture table if the device supports descriptor indexing.
+             *
+             * The table holds up to 4096 textures, or fewer if the device limits are lower.
+             *
+             * @param framesInFlight The number of frames that can be recorded concurrently.
+             *
+             * @note Must be called after the logical device has been created with the
+             * descriptor indexing features of `_capabilities` enabled.
+             */
+            void createBindlessTextureTable(uint32_t framesInFlight);
+
+            /**
+             * @brief Creates the sampler cache shared by every texture of the device.
+             *
+             * @note Must be called after the logical device has been created.
+             */
+            void createSamplerCache();
+
+            /**
+             * @brief Creates the host image copy helper, when the device supports it.
+             *
+             * @note Must be called after the logical device has been created with the
+             * host image copy feature of `_capabilities` enabled.
+             */
+            void createHostImageCopy();
+
+            /**
+             * @brief Creates the ring streaming per-frame vertices and indices.
+             *
+             * @param framesInFlight The number of frames that can be recorded concurrently.
+             *
+             * @note The ring must then be given every frame index through DynamicGeometry::beginFrame().
+             */
+            void createDynamicGeometry(uint32_t framesInFlight);
+
+            /**
+             * @brief Creates the pipeline cache, seeded from the file written by a previous run on this device.
+             *
+             * @note Must be called after the logical device has been created.
+             */
+            void createPipelineCache();
+
+            /**
+             * @brief Creates the resource state tracker shared by the whole context.
+             *
+             * The tracker emits synchronization2 barriers when `_capabilities` has the feature enabled.
+             *
+             * @note Must be called after the logical device has been created.
+             */
+            void createResourceStateTracker();
+
+            /**
+             * @brief Creates the compute mip generator, when its compiled shaders are available.
+             *
+             * Without the shaders, mip chains are only generated with blits, so formats
+             * lacking linear-filter blit support are widened or rejected.
+             *
+             * @param shaderDirectory The directory containing the compiled `mipgen_<format>.spv` shaders.
+             *
+             * @note Must be called after the pipeline cache has been created.
+             */
+            void createComputeMipGenerator(const std::string& shaderDirectory = "shaders");
+
             /**
              * @brief Retrieves the maximum usable sample count for multisampling.
              *
@@ -149,6 +287,15 @@ namespace maverik {
             VkQueue _graphicsQueue;             // Graphics queue for submitting rendering commands
             VkCommandPool _commandPool;         // Command pool for managing command buffers
             VkSampleCountFlagBits _msaaSamples = VK_SAMPLE_COUNT_1_BIT;     // MSAA sample count
+            std::shared_ptr<CommandAllocator> _commandAllocator;            // Frame-scoped transient command allocator
+            Utils::DeviceCapabilities _capabilities;                        // Optional features enabled on the logical device
+            std::shared_ptr<BindlessTextureTable> _bindlessTextureTable;    // Bindless texture array, null without descriptor indexing
+            std::shared_ptr<SamplerCache> _samplerCache;                    // Samplers deduplicated by their state
+            std::shared_ptr<HostImageCopy> _hostImageCopy;                  // Host image copy helper, null without VK_EXT_host_image_copy
+            std::shared_ptr<DynamicGeometry> _dynamicGeometry;              // Per-frame vertices and indices, null without a frame loop
+            std::shared_ptr<PipelineCache> _pipelineCache;                  // Compiled pipelines persisted across runs
+            std::shared_ptr<ResourceStateTracker> _resourceStateTracker;    // Image states shared by every barrier recorded by the context
+            std::shared_ptr<ComputeMipGenerator> _computeMipGenerator;      // Compute mip generator, null without its shaders
 
             std::shared_ptr<VulkanContext> _vulkanContext;      // Shared pointer to Vulkan context
 
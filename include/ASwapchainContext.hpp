@@ -55,8 +55,6 @@ namespace maverik {
             VkExtent2D _swapchainExtent;                    // Dimensions of the swapchain images
             std::vector<VkFramebuffer> _swapchainFramebuffers;      // Framebuffers for the swapchain images
 
-            uint32_t _mipLevels;                       // Number of mipmap levels for textures
-
             VkFormat _swapchainColorFormat = VK_FORMAT_UNDEFINED;   // Format of the swapchain images
 
             VkRenderPass _renderPass = VK_NULL_HANDLE;        // Vulkan render pass
@@ -0,0 +1,145 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** BindlessTextureTable
+*/
+
+#pragma once
+
+#include <deque>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+namespace maverik {
+    /**
+     * @class BindlessTextureTable
+     * @brief A single descriptor set holding every texture in one large combined image sampler array.
+     *
+     * Textures are registered into stable slots, and shaders index the array with the slot
+     * of the material they draw, so drawing with another texture no longer requires binding
+     * another descriptor set. The set is bound once per command buffer and can be updated while
+     * bound (update-after-bind); unused slots are left unwritten (partially bound).
+     *
+     * Shaders declare the array as:
+     * @code
+     * #extension GL_EXT_nonuniform_qualifier : require
+     * layout(set = 1, binding = 0) uniform sampler2D textures[];
+     * ...
+     * texture(textures[nonuniformEXT(materialIndex)], uv);
+     * @endcode
+     *
+     * @note Requires the descriptor indexing features listed in Utils::DeviceCapabilities.
+     */
+    class BindlessTextureTable {
+        public:
+            /**
+             * @struct BindlessTextureTableCreationProperties
+             * @brief Holds the properties required to create a bindless texture table.
+             */
+            struct BindlessTextureTableCreationProperties {
+                /*
+                 * @brief The Vulkan logical device, created with the descriptor indexing features enabled.
+                */
+                VkDevice _logicalDevice;
+                /*
+                 * @brief The number of slots of the array.
+                */
+                uint32_t _capacity;
+                /*
+                 * @brief The number of frames that can be recorded concurrently, released slots stay unused for as many frames.
+                */
+                uint32_t _framesInFlight;
+            };
+
+            /**
+             * @brief Creates the descriptor set layout, pool and set of the table.
+             *
+             * @param properties The properties required to create the table.
+             *
+             * @throws std::runtime_error If a Vulkan object creation fails.
+             */
+            BindlessTextureTable(const BindlessTextureTableCreationProperties& properties);
+
+            /**
+             * @brief Destroys the descriptor pool and layout.
+             */
+            ~BindlessTextureTable();
+
+            BindlessTextureTable(const BindlessTextureTable& other) = delete;
+            BindlessTextureTable& operator=(const BindlessTextureTable& other) = delete;
+
+            /**
+             * @brief Writes a texture into a free slot.
+             *
+             * A released slot is only reused once _framesInFlight frames have begun since its
+             * release, so it is not rewritten while frames recorded before the release may
+             * still sample it.
+             *
+             * @param imageView The view of the texture, in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL.
+             * @param sampler The sampler used to sample the texture.
+             * @return uint32_t The slot shaders index the array with.
+             *
+             * @throws std::runtime_error If every slot is used.
+             */
+            uint32_t registerTexture(VkImageView imageView, VkSampler sampler);
+
+            /**
+             * @brief Replaces the texture of a slot, keeping the slot index.
+             *
+             * @param slot The slot returned by registerTexture.
+             * @param imageView The new view of the texture.
+             * @param sampler The new sampler of the texture.
+             */
+            void updateTexture(uint32_t slot, VkImageView imageView, VkSampler sampler);
+
+            /**
+             * @brief Releases a slot so it can be reused by a later registration.
+             *
+             * The slot is reused once every frame recorded until now has completed.
+             *
+             * @param slot The slot returned by registerTexture.
+             */
+            void unregisterTexture(uint32_t slot);
+
+            /**
+             * @brief Starts a new frame, making the slots released _framesInFlight frames ago reusable.
+             *
+             * @note Must be called once per frame, after waiting for the in-flight fence of the frame.
+             */
+            void beginFrame();
+
+            VkDescriptorSetLayout getDescriptorSetLayout() const {
+                return _descriptorSetLayout;
+            }
+
+            VkDescriptorSet getDescriptorSet() const {
+                return _descriptorSet;
+            }
+
+            uint32_t getCapacity() const {
+                return _capacity;
+            }
+
+        private:
+            /**
+             * @struct ReleasedSlot
+             * @brief A released slot waiting for the frames in flight to stop sampling it.
+             */
+            struct ReleasedSlot {
+                uint32_t _slot;             // Index of the slot
+                uint64_t _reuseFrame;       // Frame from which the slot can be written again
+            };
+
+            VkDevice _logicalDevice;                    // Logical device owning the descriptors
+            uint32_t _capacity;                         // Number of slots of the array
+            uint32_t _framesInFlight;                   // Frames a released slot stays unused for
+            VkDescriptorSetLayout _descriptorSetLayout; // Layout with a single update-after-bind array binding
+            VkDescriptorPool _descriptorPool;           // Pool the set is allocated from
+            VkDescriptorSet _descriptorSet;             // Set holding the array
+            uint32_t _nextSlot = 0;                     // First slot never handed out
+            std::deque<ReleasedSlot> _freeSlots;        // Released slots, in release order
+            uint64_t _frame = 0;                        // Number of frames begun so far
+    };
+}
@@ -0,0 +1,144 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** CommandAllocator
+*/
+
+#pragma once
+
+#include <vector>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+namespace maverik {
+    /**
+     * @class CommandAllocator
+     * @brief Frame-scoped transient command buffer allocator.
+     *
+     * This class hands out command buffers from two kinds of pools:
+     *
+     * - Frame command buffers, returned by allocate(), come from one
+     *   `VK_COMMAND_POOL_CREATE_TRANSIENT_BIT` pool per frame in flight. They are
+     *   handed out by bumping an index into the buffers already allocated from the
+     *   current frame's pool, and are all recycled together by beginFrame() with a
+     *   single `vkResetCommandPool` once the fence of that frame has signaled. They
+     *   are never freed or given back individually.
+     *
+     * - One-shot command buffers, returned by allocateImmediate(), are used for
+     *   uploads waited for on the spot, which may happen before the first frame or
+     *   without any frame loop. They come from a separate resettable pool, and are
+     *   given back one by one with recycle() as soon as their execution completed,
+     *   to be reused by the next one-shot submission.
+     *
+     * @note This class is not thread-safe, as Vulkan command pools must be
+     * externally synchronized.
+     */
+    class CommandAllocator {
+        public:
+            /**
+             * @struct CommandAllocatorCreationProperties
+             * @brief Holds the properties required to create a command allocator.
+             */
+            struct CommandAllocatorCreationProperties {
+                /*
+                 * @brief The Vulkan logical device used to create the command pools.
+                */
+                VkDevice _logicalDevice;
+                /*
+                 * @brief The index of the queue family the command buffers will be submitted to.
+                */
+                uint32_t _queueFamilyIndex;
+                /*
+                 * @brief The number of frames in flight, one command pool is created per frame.
+                */
+                uint32_t _framesInFlight;
+            };
+
+            /**
+             * @brief Constructs a CommandAllocator and creates one transient pool per frame in flight.
+             *
+             * @param properties The properties required to create the command allocator.
+             *
+             * @throws std::runtime_error If a command pool creation fails.
+             */
+            CommandAllocator(const CommandAllocatorCreationProperties& properties);
+
+            /**
+             * @brief Destroys every command pool owned by the allocator.
+             *
+             * @note The caller must ensure that no command buffer of the allocator
+             * is still pending execution.
+             */
+            ~CommandAllocator();
+
+            CommandAllocator(const CommandAllocator& other) = delete;
+            CommandAllocator& operator=(const CommandAllocator& other) = delete;
+
+            /**
+             * @brief Hands out the next primary command buffer of the current frame.
+             *
+             * When the current frame's pool has no free command buffer left, a new
+             * batch is allocated and kept for the following frames.
+             *
+             * @return VkCommandBuffer A command buffer in the initial state.
+             *
+             * @throws std::runtime_error If the command buffer allocation fails.
+             */
+            VkCommandBuffer allocate();
+
+            /**
+             * @brief Hands out a command buffer for a one-shot submission, outside of any frame.
+             *
+             * @return VkCommandBuffer A command buffer in the initial state, to be given back with recycle().
+             *
+             * @throws std::runtime_error If the command buffer allocation fails.
+             */
+            VkCommandBuffer allocateImmediate();
+
+            /**
+             * @brief Gives back a command buffer returned by allocateImmediate().
+             *
+             * @param commandBuffer The command buffer, whose execution must have completed.
+             */
+            void recycle(VkCommandBuffer commandBuffer);
+
+            /**
+             * @brief Starts a new frame and recycles its command pool.
+             *
+             * Waits on the given fence (if any), then resets the frame's pool with a
+             * single `vkResetCommandPool` and rewinds its bump index.
+             *
+             * @param frameIndex The index of the frame in flight that is starting.
+             * @param fence The fence signaled when the previous use of this frame completed.
+             */
+            void beginFrame(uint32_t frameIndex, VkFence fence = VK_NULL_HANDLE);
+
+            /**
+             * @brief Get the index of the frame command buffers are currently allocated from.
+             *
+             * @return The index of the current frame in flight.
+             */
+            uint32_t getCurrentFrame() const {
+                return _currentFrame;
+            }
+
+        private:
+            /**
+             * @struct FramePool
+             * @brief Command pool and recycled command buffers of a single frame in flight.
+             */
+            struct FramePool {
+                VkCommandPool _commandPool = VK_NULL_HANDLE;    // Transient command pool of the frame
+                std::vector<VkCommandBuffer> _commandBuffers;   // Command buffers allocated so far from the pool
+                uint32_t _nextIndex = 0;                        // Bump index of the next free command buffer
+            };
+
+            VkDevice _logicalDevice;                // Logical device owning the command pools
+            std::vector<FramePool> _framePools;     // One pool per frame in flight
+            VkCommandPool _immediatePool = VK_NULL_HANDLE;      // Resettable pool of the one-shot command buffers
+            std::vector<VkCommandBuffer> _immediateBuffers;     // One-shot command buffers given back, ready for reuse
+            uint32_t _currentFrame = 0;             // Frame command buffers are handed out from
+    };
+}
@@ -0,0 +1,198 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** ComputeMipGenerator
+*/
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Utils.hpp"
+
+namespace maverik {
+    /**
+     * @class ComputeMipGenerator
+     * @brief Generates mip chains with a single-pass compute shader.
+     *
+     * Each dispatch of `shaders/mipgen.comp` builds up to 12 levels at once: workgroups
+     * reduce 64x64 tiles through shared memory, and the last workgroup to finish reduces
+     * the remaining levels. Compared to Utils::generateMipmaps, there is no blit nor barrier
+     * per level, and formats without linear-filter blit support can be used as long as they
+     * can be stored to.
+     *
+     * Filtering happens in linear space: sRGB images are bound through UNORM views and
+     * decoded and encoded by the shader. Alpha weighting averages colors premultiplied by
+     * alpha, so transparent texels do not bleed into their neighbours.
+     *
+     * Images must be created with `VK_IMAGE_USAGE_STORAGE_BIT`, and sRGB images also with
+     * `VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT`; their sampled
+     * views then have to drop the storage usage (see Utils::createImageView).
+     *
+     * @note This class is not thread-safe.
+     */
+    class ComputeMipGenerator {
+        public:
+            /*
+             * Number of levels a single dispatch can generate.
+             */
+            static constexpr uint32_t MAX_LEVELS_PER_DISPATCH = 12;
+
+            /**
+             * @struct ComputeMipGeneratorCreationProperties
+             * @brief Holds the properties required to create a compute mip generator.
+             */
+            struct ComputeMipGeneratorCreationProperties {
+                /*
+                 * @brief The Vulkan physical device, used to query format support.
+                */
+                VkPhysicalDevice _physicalDevice;
+                /*
+                 * @brief The Vulkan logical device used to create the pipelines.
+                */
+                VkDevice _logicalDevice;
+                /*
+                 * @brief The directory containing the compiled `mipgen_<format>.spv` shaders.
+                */
+                std::string _shaderDirectory = "shaders";
+                /*
+                 * @brief The maximum number of generations recorded and not released yet.
+                */
+                uint32_t _maxPendingGenerations = 16;
+                /*
+                 * @brief The pipeline cache the compute pipelines are compiled through, if any.
+                */
+                VkPipelineCache _pipelineCache = VK_NULL_HANDLE;
+            };
+
+            /**
+             * @struct MipGenerationProperties
+             * @brief Describes the image whose mip chain is generated.
+             */
+            struct MipGenerationProperties {
+                /*
+                 * @brief The image, with its base level filled and every level in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL unless it is tracked by _resourceStateTracker.
+                */
+                VkImage _image;
+                /*
+                 * @brief The format the image was created with.
+                */
+                VkFormat _format;
+                /*
+                 * @brief The width of the base level in pixels.
+                */
+                uint32_t _width;
+                /*
+                 * @brief The height of the base level in pixels.
+                */
+                uint32_t _height;
+                /*
+                 * @brief The number of levels of the image.
+                */
+                uint32_t _mipLevels;
+                /*
+                 * @brief Whether colors are averaged weighted by their alpha.
+                */
+                bool _alphaWeighted = false;
+                /*
+                 * @brief The tracker the image is tracked by, which the barriers are recorded through, a temporary one is used when null.
+                */
+                ResourceStateTracker *_resourceStateTracker = nullptr;
+            };
+
+            /**
+             * @struct Generation
+             * @brief Resources used by a recorded generation, to be released once it has executed.
+             */
+            struct Generation {
+                std::vector<VkImageView> _views;                // Per-level storage views
+                std::vector<VkDescriptorSet> _descriptorSets;   // One set per dispatch
+            };
+
+            /**
+             * @brief Creates the layouts and the descriptor pool of the generator.
+             *
+             * Pipelines are created the first time a storage format is used.
+             *
+             * @param properties The properties required to create the generator.
+             *
+             * @throws std::runtime_error If a Vulkan object creation fails.
+             */
+            ComputeMipGenerator(const ComputeMipGeneratorCreationProperties& properties);
+
+            /**
+             * @brief Destroys the pipelines, layouts, descriptor pool and counter buffer.
+             */
+            ~ComputeMipGenerator();
+
+            ComputeMipGenerator(const ComputeMipGenerator& other) = delete;
+            ComputeMipGenerator& operator=(const ComputeMipGenerator& other) = delete;
+
+            /**
+             * @brief Get the format of the storage views used for an image format.
+             *
+             * @param format The format of the image.
+             * @return VkFormat The storage format, or VK_FORMAT_UNDEFINED if the format is not handled.
+             */
+            static VkFormat getStorageFormat(VkFormat format);
+
+            /**
+             * @brief Checks whether the mip chain of an image format can be generated by the device.
+             *
+             * @param physicalDevice The Vulkan physical device to query.
+             * @param format The format of the image.
+             * @return true if the format is handled and its storage format supports storage images.
+             */
+            static bool isFormatSupported(VkPhysicalDevice physicalDevice, VkFormat format);
+
+            /**
+             * @brief Checks whether the shaders of every storage format are present in a directory.
+             *
+             * @param shaderDirectory The directory the compiled `mipgen_<format>.spv` shaders would be loaded from.
+             * @return true if every shader file exists, false otherwise.
+             */
+            static bool hasShaders(const std::string& shaderDirectory);
+
+            /**
+             * @brief Records the generation of every level below the base level.
+             *
+             * Once the command buffer has executed, every level is in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL.
+             *
+             * @param commandBuffer The command buffer, in the recording state.
+             * @param properties The image to generate the mip chain of.
+             * @return Generation The resources to release once the command buffer has executed.
+             *
+             * @throws std::runtime_error If the format is not supported or no descriptor set is left.
+             */
+            Generation record(VkCommandBuffer commandBuffer, const MipGenerationProperties& properties);
+
+            /**
+             * @brief Releases the resources of a generation that has executed.
+             *
+             * @param generation The generation returned by record().
+             */
+            void release(const Generation& generation);
+
+        private:
+            /**
+             * @brief Get the pipeline writing a storage format, creating it on first use.
+             */
+            VkPipeline getPipeline(VkFormat storageFormat);
+
+            /**
+             * @brief Creates a view over a single level of an image.
+             */
+            VkImageView createLevelView(VkImage image, VkFormat format, uint32_t level);
+
+            ComputeMipGeneratorCreationProperties _properties;  // Vulkan objects and settings
+            VkDescriptorSetLayout _descriptorSetLayout;         // Source level, destination levels and counter
+            VkPipelineLayout _pipelineLayout;                   // Descriptor set layout and push constants
+            VkDescriptorPool _descriptorPool;                   // Pool the per-dispatch sets are allocated from
+            std::map<VkFormat, VkPipeline> _pipelines;          // Pipelines mapped by storage format
+            VkBuffer _counterBuffer;                            // Workgroup counter electing the last workgroup
+            VkDeviceMemory _counterBufferMemory;                // Memory of the counter buffer
+    };
+}
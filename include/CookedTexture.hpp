@@ -0,0 +1,169 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** CookedTexture
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+
+#include "MipGenerator.hpp"
+#include "FileAsset.hpp"
+
+namespace maverik {
+    /**
+     * @class CookedTexture
+     * @brief Memory-mapped reader and writer of cooked `.mvktex` textures.
+     *
+     * A cooked texture stores a whole mip chain already in its GPU format, so that
+     * loading it is a single memcpy from the mapped file, or from the asset it was read
+ * into, to a staging buffer.
+     *
+     * File layout (little-endian):
+     * - header: magic `MVKT`, version, Vulkan format, width, height, level count
+     * - level table: offset, size, width and height of each level
+     * - level payloads, each starting on a 4096-byte page boundary
+     *
+     * @note This class has no Vulkan dependency so it can be used by offline tools,
+     * formats are stored as the numeric value of their `VkFormat`.
+     */
+    class CookedTexture {
+        public:
+            /*
+             * Value of VK_FORMAT_R8G8B8A8_UNORM and VK_FORMAT_R8G8B8A8_SRGB.
+             */
+            static constexpr uint32_t FORMAT_R8G8B8A8_UNORM = 37;
+            static constexpr uint32_t FORMAT_R8G8B8A8_SRGB = 43;
+
+            /*
+             * Alignment of every level payload in the file.
+             */
+            static constexpr uint64_t PAGE_ALIGNMENT = 4096;
+
+            /**
+             * @struct Level
+             * @brief Location and size of a mip level inside the file.
+             */
+            struct Level {
+                uint64_t _offset;   // Offset of the level from the start of the file
+                uint64_t _size;     // Size of the level in bytes
+                uint32_t _width;    // Width of the level in pixels
+                uint32_t _height;   // Height of the level in pixels
+            };
+
+            /**
+             * @brief Maps a cooked texture file in memory and validates it.
+             *
+             * @param path The path to the `.mvktex` file.
+             *
+             * @throws std::runtime_error If the file cannot be mapped or is not a valid cooked texture.
+             */
+            CookedTexture(const std::string& path);
+
+            /**
+             * @brief Validates a cooked texture held by an asset, without copying it.
+             *
+             * @param asset The asset holding the whole content of the file, kept alive by the texture.
+             * @param name The name of the texture, used in error messages.
+             *
+             * @throws std::runtime_error If the asset is null or is not a valid cooked texture.
+             */
+            CookedTexture(std::shared_ptr<FileAsset> asset, const std::string& name);
+
+            /**
+             * @brief Unmaps the file or releases the asset.
+             */
+            ~CookedTexture();
+
+            CookedTexture(const CookedTexture& other) = delete;
+            CookedTexture& operator=(const CookedTexture& other) = delete;
+
+            /**
+             * @brief Writes a mip chain as a cooked texture file.
+             *
+             * @param path The path of the file to write.
+             * @param format The numeric value of the `VkFormat` of the levels.
+             * @param levels The mip chain, from the base level to the smallest.
+             *
+             * @throws std::runtime_error If the file cannot be written.
+             */
+            static void write(const std::string& path, uint32_t format, const std::vector<MipGenerator::MipLevel>& levels);
+
+            /**
+             * @brief Checks whether a path designates a cooked texture, based on its extension.
+             *
+             * @param path The path to check.
+             * @return true if the path ends with `.mvktex`, false otherwise.
+             */
+            static bool isCookedPath(const std::string& path);
+
+            uint32_t getFormat() const {
+                return _format;
+            }
+
+            uint32_t getWidth() const {
+                return _levels.front()._width;
+            }
+
+            uint32_t getHeight() const {
+                return _levels.front()._height;
+            }
+
+            uint32_t getLevelCount() const {
+                return static_cast<uint32_t>(_levels.size());
+            }
+
+            const std::vector<Level>& getLevels() const {
+                return _levels;
+            }
+
+            /**
+             * @brief Get the content of the file, mapped or held by the asset.
+             *
+             * @return const char* The first byte of the file.
+             */
+            const char *getData() const {
+                return _data;
+            }
+
+            size_t getSize() const {
+                return _size;
+            }
+
+        private:
+            /**
+             * @brief Validates the header and reads the level table.
+             *
+             * Every level must lie inside the file and hold exactly the bytes of its
+             * width and height in the format of the texture, as it is copied to staging
+             * without further checks.
+             *
+             * @param name The name of the texture, used in error messages.
+             *
+             * @throws std::runtime_error If the content is not a valid cooked texture.
+             */
+            void parse(const std::string& name);
+
+            /**
+             * @brief Releases the mapping and the file handles, or the asset, if any.
+             */
+            void unmap();
+
+            const char *_data = nullptr;            // Content of the file, mapped or held by the asset
+            size_t _size = 0;                       // Size of the file in bytes
+            uint32_t _format = 0;                   // Numeric VkFormat of the levels
+            std::vector<Level> _levels;             // Mip levels, from the base level to the smallest
+            std::shared_ptr<FileAsset> _asset;      // Asset holding the content of the file, if not mapped
+#ifdef _WIN32
+            void *_fileHandle = nullptr;    // Handle of the opened file
+            void *_mappingHandle = nullptr; // Handle of the file mapping
+#endif
+    };
+}
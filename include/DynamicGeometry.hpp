@@ -0,0 +1,184 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** DynamicGeometry
+*/
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Utils.hpp"
+
+namespace maverik {
+    /**
+     * @brief Data written to a DynamicGeometry ring, ready to be bound.
+     */
+    struct DynamicBufferRange {
+        VkBuffer _buffer = VK_NULL_HANDLE;      // Buffer holding the data
+        VkDeviceSize _offset = 0;               // Offset of the data in the buffer, in bytes
+        VkDeviceSize _size = 0;                 // Size of the data, in bytes
+        void *_data = nullptr;                  // Mapped address of the data, to fill it in place
+    };
+
+    /**
+     * @class DynamicGeometry
+     * @brief Streams vertices and indices rewritten every frame through a persistently mapped ring.
+     *
+     * The ring is a single host-visible buffer usable as vertex and index buffer, split
+     * into one partition per frame in flight. Writes of a frame are appended to its
+     * partition, which is only reused once the frame completed, so geometry such as
+     * particles, debug lines or UI costs a memcpy instead of a buffer creation.
+     *
+     * Memory is device-local when Utils::findDirectWriteMemoryType() allows it, and
+     * host-coherent in every case, so no flush is needed.
+     *
+     * When a partition fills up, the ring is replaced by one with partitions twice as
+     * large. The previous ring stays alive until every frame that may still read it completed.
+     *
+     * @note This class is not thread-safe.
+     */
+    class DynamicGeometry {
+        public:
+            /**
+             * @struct DynamicGeometryCreationProperties
+             * @brief Holds the properties required to create a dynamic geometry ring.
+             */
+            struct DynamicGeometryCreationProperties {
+                /*
+                 * @brief The Vulkan physical device the ring is allocated from.
+                */
+                VkPhysicalDevice _physicalDevice;
+                /*
+                 * @brief The Vulkan logical device used to create the ring.
+                */
+                VkDevice _logicalDevice;
+                /*
+                 * @brief The number of frames that can be recorded concurrently, one partition each.
+                */
+                uint32_t _framesInFlight;
+                /*
+                 * @brief The initial size of each partition, in bytes.
+                */
+                VkDeviceSize _frameCapacity = 4 * 1024 * 1024;
+            };
+
+            /**
+             * @brief Creates and maps the ring.
+             *
+             * @param properties The properties required to create the ring.
+             *
+             * @throws std::runtime_error If the buffer creation or memory allocation fails.
+             */
+            DynamicGeometry(const DynamicGeometryCreationProperties& properties);
+
+            /**
+             * @brief Destroys the ring and the retired ones, the device must be done with them.
+             */
+            ~DynamicGeometry();
+
+            DynamicGeometry(const DynamicGeometry& other) = delete;
+            DynamicGeometry& operator=(const DynamicGeometry& other) = delete;
+
+            /**
+             * @brief Starts writing the partition of a frame, discarding its previous content.
+             *
+             * @param frameIndex The index of the frame in flight, in [0, _framesInFlight).
+             *
+             * @note Must be called once the previous use of the frame completed, after
+             * waiting for its in-flight fence.
+             */
+            void beginFrame(uint32_t frameIndex);
+
+            /**
+             * @brief Reserves space in the partition of the current frame.
+             *
+             * @param size The size to reserve, in bytes.
+             * @param alignment The alignment of the offset, a power of two.
+             * @return DynamicBufferRange The reserved range, to be filled through `_data`.
+             */
+            DynamicBufferRange allocate(VkDeviceSize size, VkDeviceSize alignment = DEFAULT_ALIGNMENT);
+
+            /**
+             * @brief Copies data into the partition of the current frame.
+             *
+             * @param data The data to copy.
+             * @param size The size of the data, in bytes.
+             * @param alignment The alignment of the offset, a power of two.
+             * @return DynamicBufferRange The range the data was written to.
+             */
+            DynamicBufferRange write(const void *data, VkDeviceSize size, VkDeviceSize alignment = DEFAULT_ALIGNMENT);
+
+            template <typename VertexType>
+            DynamicBufferRange writeVertices(const std::vector<VertexType>& vertices) {
+                return this->write(vertices.data(), vertices.size() * sizeof(VertexType));
+            }
+
+            DynamicBufferRange writeIndices(const std::vector<uint16_t>& indices) {
+                return this->write(indices.data(), indices.size() * sizeof(uint16_t));
+            }
+
+            DynamicBufferRange writeIndices(const std::vector<uint32_t>& indices) {
+                return this->write(indices.data(), indices.size() * sizeof(uint32_t));
+            }
+
+            /**
+             * @brief Binds a range as a vertex buffer.
+             *
+             * @param commandBuffer The command buffer being recorded.
+             * @param binding The vertex input binding to bind the range to.
+             * @param range The range returned by writeVertices().
+             */
+            static void bindVertexBuffer(VkCommandBuffer commandBuffer, uint32_t binding, const DynamicBufferRange& range);
+
+            /**
+             * @brief Binds a range as the index buffer.
+             *
+             * @param commandBuffer The command buffer being recorded.
+             * @param range The range returned by writeIndices().
+             * @param indexType The type of the indices written to the range.
+             */
+            static void bindIndexBuffer(VkCommandBuffer commandBuffer, const DynamicBufferRange& range, VkIndexType indexType);
+
+            VkDeviceSize getFrameCapacity() const {
+                return _ring._frameCapacity;
+            }
+
+            VkDeviceSize getFrameUsage() const {
+                return _frameOffset;
+            }
+
+            static constexpr VkDeviceSize DEFAULT_ALIGNMENT = 16;  // Offset alignment of writes, enough for any vertex attribute or index type
+
+        private:
+            /**
+             * @brief A ring buffer and its mapping.
+             */
+            struct Ring {
+                VkBuffer _buffer = VK_NULL_HANDLE;
+                VkDeviceMemory _memory = VK_NULL_HANDLE;
+                char *_mapped = nullptr;
+                VkDeviceSize _frameCapacity = 0;    // Size of each partition
+            };
+
+            /**
+             * @brief A replaced ring, destroyed once no frame in flight can read it.
+             */
+            struct RetiredRing {
+                Ring _ring;
+                uint32_t _framesLeft;               // Frames to begin before the ring is unused
+            };
+
+            Ring createRing(VkDeviceSize frameCapacity) const;
+
+            void destroyRing(Ring& ring) const;
+
+            DynamicGeometryCreationProperties _properties;  // Vulkan objects and settings
+            Ring _ring;                                     // Ring written to
+            std::vector<RetiredRing> _retiredRings;         // Rings replaced while frames in flight read them
+            uint32_t _frameIndex = 0;                       // Frame whose partition is written to
+            VkDeviceSize _frameOffset = 0;                  // Bytes written to the partition of the frame
+    };
+}
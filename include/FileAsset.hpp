@@ -38,9 +38,9 @@ namespace maverik {
 
             /**
              * @brief Constructs a FileAsset object with its content and size.
-             * @param content The content of the file.
+             * @param content The content of the file, moved into the asset.
              */
-            FileAsset(const std::string& content);
+            FileAsset(std::string content);
 
             /**
              * @brief Destructs the FileAsset object.
@@ -0,0 +1,271 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** GeometryPool
+*/
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include <optional>
+
+#include "Utils.hpp"
+
+namespace maverik {
+    /**
+     * @brief A range of the shared vertex and index buffers holding one mesh.
+     */
+    struct MeshRange {
+        uint32_t _firstIndex = 0;       // First index of the mesh in the index buffer
+        uint32_t _indexCount = 0;       // Number of indices of the mesh
+        int32_t _vertexOffset = 0;      // Added to the indices of the mesh before fetching vertices
+    };
+
+    /**
+     * @class RangeAllocator
+     * @brief Sub-allocates ranges of elements from a fixed capacity with a free list.
+     *
+     * Free blocks are kept sorted by offset and merged with their neighbours when
+     * released, allocations take the first block large enough.
+     */
+    class RangeAllocator {
+        public:
+            RangeAllocator(uint32_t capacity = 0);
+
+            ~RangeAllocator() = default;
+
+            /**
+             * @brief Allocates a range of elements.
+             *
+             * @param count The number of elements, 0 always succeeds at offset 0.
+             * @return std::optional<uint32_t> The offset of the range, empty if no free block is large enough.
+             */
+            std::optional<uint32_t> allocate(uint32_t count);
+
+            /**
+             * @brief Releases a range returned by allocate().
+             */
+            void free(uint32_t offset, uint32_t count);
+
+            /**
+             * @brief Forgets every allocation, the first usedCount elements are left allocated, the others free.
+             */
+            void reset(uint32_t capacity, uint32_t usedCount = 0);
+
+            uint32_t getCapacity() const {
+                return _capacity;
+            }
+
+            uint32_t getFreeCount() const {
+                return _freeCount;
+            }
+
+            /**
+             * @brief Get the size of the largest free block.
+             */
+            uint32_t getLargestFreeBlock() const;
+
+        private:
+            std::map<uint32_t, uint32_t> _freeBlocks;   // Size of each free block, by offset
+            uint32_t _capacity;                         // Total number of elements
+            uint32_t _freeCount;                        // Number of free elements
+    };
+
+    /**
+     * @class GeometryPool
+     * @brief Holds many meshes of a vertex layout in one vertex buffer and one index buffer.
+     *
+     * Meshes are sub-allocated as ranges of both buffers and drawn with the `_firstIndex`
+     * and `_vertexOffset` of their range, so binding the buffers once is enough for every
+     * mesh of the pool. Indices stay local to their mesh.
+     *
+     * The buffers are written directly when they land in device-local host-visible memory,
+     * see Utils::findDirectWriteMemoryType, and through a staging buffer otherwise.
+     *
+     * When no free block fits a mesh, the pool is compacted into buffers twice as large.
+     * compact() moves every mesh to the start of the buffers, merging the free blocks
+     * left by freed meshes; ranges change but mesh identifiers stay valid.
+     *
+     * @note Freed ranges are reused right away: free meshes once the frames drawing them
+     * have completed.
+     */
+    class GeometryPool {
+        public:
+            /**
+             * @struct GeometryPoolCreationProperties
+             * @brief Holds the properties required to create a geometry pool.
+             */
+            struct GeometryPoolCreationProperties {
+                /*
+                 * @brief The Vulkan physical device the buffers are allocated from.
+                */
+                VkPhysicalDevice _physicalDevice;
+                /*
+                 * @brief The Vulkan logical device used to create the buffers.
+                */
+                VkDevice _logicalDevice;
+                /*
+                 * @brief The Vulkan command pool used to allocate the copy command buffers.
+                */
+                VkCommandPool _commandPool;
+                /*
+                 * @brief The Vulkan graphics queue the copies are submitted to.
+                */
+                VkQueue _graphicsQueue;
+                /*
+                 * @brief The size of a vertex of the layout, in bytes.
+                */
+                uint32_t _vertexStride;
+                /*
+                 * @brief The type of the indices, UINT16 limits each mesh to 65535 vertices.
+                */
+                VkIndexType _indexType = VK_INDEX_TYPE_UINT32;
+                /*
+                 * @brief The initial number of vertices of the vertex buffer.
+                */
+                uint32_t _vertexCapacity = 1 << 16;
+                /*
+                 * @brief The initial number of indices of the index buffer.
+                */
+                uint32_t _indexCapacity = 1 << 18;
+                /*
+                 * @brief Optional frame-scoped allocator used instead of allocating from the command pool.
+                */
+                CommandAllocator *_commandAllocator = nullptr;
+            };
+
+            /**
+             * @brief Creates the vertex and index buffers of the pool.
+             *
+             * @param properties The properties required to create the pool.
+             *
+             * @throws std::runtime_error If a buffer creation or memory allocation fails.
+             */
+            GeometryPool(const GeometryPoolCreationProperties& properties);
+
+            /**
+             * @brief Destroys the buffers, the device must be done with them.
+             */
+            ~GeometryPool();
+
+            GeometryPool(const GeometryPool& other) = delete;
+            GeometryPool& operator=(const GeometryPool& other) = delete;
+
+            /**
+             * @brief Uploads a mesh into the pool.
+             *
+             * @param vertices The vertices, `_vertexStride` bytes each.
+             * @param vertexCount The number of vertices.
+             * @param indices The indices, local to the vertices of the mesh.
+             * @return uint32_t The identifier of the mesh.
+             *
+             * @throws std::runtime_error If the mesh has too many vertices for the index type of the pool.
+             */
+            uint32_t allocate(const void *vertices, uint32_t vertexCount, const std::vector<uint32_t>& indices);
+
+            /**
+             * @brief Uploads a mesh into the pool.
+             *
+             * @param vertices The vertices, of the layout of the pool.
+             * @param indices The indices, local to the vertices.
+             * @return uint32_t The identifier of the mesh.
+             *
+             * @throws std::runtime_error If the vertices do not match the stride of the pool.
+             */
+            template <typename VertexType>
+            uint32_t allocate(const std::vector<VertexType>& vertices, const std::vector<uint32_t>& indices) {
+                if (sizeof(VertexType) != _properties._vertexStride) {
+                    throw std::runtime_error("Vertices do not match the layout of the geometry pool !");
+                }
+                return this->allocate(vertices.data(), static_cast<uint32_t>(vertices.size()), indices);
+            }
+
+            /**
+             * @brief Releases the ranges of a mesh, its identifier may be returned again.
+             *
+             * @throws std::runtime_error If no mesh has that identifier.
+             */
+            void free(uint32_t mesh);
+
+            /**
+             * @brief Get the range a mesh is drawn with, valid until the next compaction.
+             *
+             * @throws std::runtime_error If no mesh has that identifier.
+             */
+            MeshRange getRange(uint32_t mesh) const;
+
+            /**
+             * @brief Moves every mesh to the start of the buffers, leaving a single free block.
+             *
+             * Waits for the device to be idle before releasing the previous buffers.
+             */
+            void compact();
+
+            /**
+             * @brief Binds the vertex buffer to binding 0 and the index buffer.
+             *
+             * @param commandBuffer The command buffer being recorded.
+             */
+            void bind(VkCommandBuffer commandBuffer) const;
+
+            /**
+             * @brief Get the share of free vertices and indices outside of the largest free blocks.
+             *
+             * @return float 0 after compaction, close to 1 when free space is scattered in small blocks.
+             */
+            float getFragmentation() const;
+
+            VkIndexType getIndexType() const {
+                return _properties._indexType;
+            }
+
+        private:
+            /**
+             * @brief A buffer of the pool, mapped when written directly.
+             */
+            struct PoolBuffer {
+                VkBuffer _buffer = VK_NULL_HANDLE;
+                VkDeviceMemory _memory = VK_NULL_HANDLE;
+                void *_mapped = nullptr;
+            };
+
+            /**
+             * @brief The ranges of a mesh, in elements.
+             */
+            struct Allocation {
+                uint32_t _firstVertex = 0;
+                uint32_t _vertexCount = 0;
+                uint32_t _firstIndex = 0;
+                uint32_t _indexCount = 0;
+                bool _live = false;
+            };
+
+            PoolBuffer createBuffer(VkDeviceSize size, VkBufferUsageFlags usage) const;
+
+            void destroyBuffer(PoolBuffer& buffer) const;
+
+            /**
+             * @brief Writes host data into a buffer of the pool.
+             */
+            void upload(const PoolBuffer& buffer, VkDeviceSize offset, const void *data, VkDeviceSize size) const;
+
+            /**
+             * @brief Moves every mesh into new buffers of the given capacities, packed from their start.
+             */
+            void relocate(uint32_t vertexCapacity, uint32_t indexCapacity);
+
+            uint32_t getIndexSize() const {
+                return _properties._indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+            }
+
+            GeometryPoolCreationProperties _properties;     // Vulkan objects and settings
+            PoolBuffer _vertexBuffer;                       // Vertices of every mesh
+            PoolBuffer _indexBuffer;                        // Indices of every mesh
+            RangeAllocator _vertexAllocator;                // Free ranges of the vertex buffer, in vertices
+            RangeAllocator _indexAllocator;                 // Free ranges of the index buffer, in indices
+            std::vector<Allocation> _allocations;           // Ranges of each mesh, by identifier
+            std::vector<uint32_t> _freeMeshes;              // Identifiers of freed meshes, reused first
+    };
+}
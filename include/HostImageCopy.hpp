@@ -0,0 +1,86 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** HostImageCopy
+*/
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+namespace maverik {
+    /**
+     * @class HostImageCopy
+     * @brief Copies pixels from host memory straight into images with VK_EXT_host_image_copy.
+     *
+     * The CPU writes the image itself, so uploads need neither a staging buffer nor a
+     * command buffer nor a queue submission. Layout transitions of images being filled
+     * this way are done on the host as well.
+     *
+     * Images must be created with `VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT`. Some devices
+     * lay such images out less efficiently for the GPU, isSupported() reports them as
+     * unsupported so that callers keep using staging buffers there.
+     *
+     * @note Requires the `hostImageCopy` feature listed in Utils::DeviceCapabilities.
+     */
+    class HostImageCopy {
+        public:
+            /**
+             * @brief Loads the entry points of the extension and the layouts it can copy to.
+             *
+             * @param logicalDevice The Vulkan logical device, created with the host image copy feature enabled.
+             * @param physicalDevice The Vulkan physical device of the logical device.
+             *
+             * @throws std::runtime_error If the entry points of the extension cannot be loaded.
+             */
+            HostImageCopy(VkDevice logicalDevice, VkPhysicalDevice physicalDevice);
+
+            ~HostImageCopy() = default;
+
+            /**
+             * @brief Checks whether images of a format can be filled from the host in a layout.
+             *
+             * @param format The format of the image.
+             * @param usage The usage of the image, `VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT` is added to it.
+             * @param layout The layout the image is copied to.
+             * @return true if the copy is supported and does not degrade device access to the image.
+             */
+            bool isSupported(VkFormat format, VkImageUsageFlags usage, VkImageLayout layout) const;
+
+            /**
+             * @brief Transitions every mip level of an image from the host.
+             *
+             * @param image The image, not in use by the device.
+             * @param mipLevels The number of mip levels of the image.
+             * @param oldLayout The current layout of the image.
+             * @param newLayout The layout to transition to.
+             *
+             * @throws std::runtime_error If the transition fails.
+             */
+            void transitionLayout(VkImage image, uint32_t mipLevels, VkImageLayout oldLayout, VkImageLayout newLayout) const;
+
+            /**
+             * @brief Copies pixels from host memory into an image.
+             *
+             * @param image The image, in a layout accepted by isSupported().
+             * @param layout The current layout of the image.
+             * @param payload The pixels of every region.
+             * @param regions The regions to copy, buffer offsets being relative to the payload.
+             *
+             * @throws std::runtime_error If the copy fails.
+             */
+            void copyToImage(VkImage image, VkImageLayout layout, const char *payload, const std::vector<VkBufferImageCopy>& regions) const;
+
+        private:
+            VkDevice _logicalDevice;                                            // Logical device the images belong to
+            VkPhysicalDevice _physicalDevice;                                   // Physical device queried for format support
+            PFN_vkCopyMemoryToImageEXT _copyMemoryToImage = nullptr;            // Entry point of vkCopyMemoryToImageEXT
+            PFN_vkTransitionImageLayoutEXT _transitionImageLayout = nullptr;    // Entry point of vkTransitionImageLayoutEXT
+            std::vector<VkImageLayout> _copyDstLayouts;                         // Layouts images can be copied to from the host
+    };
+}
@@ -0,0 +1,184 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** IndirectRenderer
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Utils.hpp"
+
+namespace maverik {
+    /**
+     * @brief An object drawn by the GPU-driven path, as stored in its storage buffer (std430).
+     */
+    struct IndirectObject {
+        glm::vec4 _boundingSphere = glm::vec4(0.0f);    // Center in world space, radius in w
+        uint32_t _firstIndex = 0;                       // First index of the mesh in the index buffer
+        uint32_t _indexCount = 0;                       // Number of indices of the mesh
+        int32_t _vertexOffset = 0;                      // Added to the indices of the mesh before fetching vertices
+        uint32_t _firstInstance = 0;                    // Instance the draw starts at, such as the InstanceData of the object
+    };
+
+    static_assert(sizeof(IndirectObject) == 32, "IndirectObject must match the Object struct of shaders/cull.comp");
+
+    /**
+     * @class IndirectRenderer
+     * @brief Culls and draws objects on the GPU, at a CPU cost independent of their number.
+     *
+     * The bounds and draw parameters of every object live in a storage buffer, updated
+     * only when objects change. Each frame, `shaders/cull.comp` tests the objects against
+     * the view frustum and writes a VkDrawIndexedIndirectCommand per visible object, and
+     * a single vkCmdDrawIndexedIndirectCount then draws them.
+     *
+     * Without VK_KHR_draw_indirect_count, every object keeps a command at its own index,
+     * culled ones drawing no instance, and all of them are issued with vkCmdDrawIndexedIndirect.
+     *
+     * Each command draws a single instance starting at the `_firstInstance` of its object,
+     * so the instanced pipeline of SwapchainContext can read the transform of the object
+     * from an instance buffer holding one InstanceData per object.
+     *
+     * @note This class is not thread-safe.
+     */
+    class IndirectRenderer {
+        public:
+            /*
+             * Number of objects culled by a workgroup of the culling shader.
+             */
+            static constexpr uint32_t WORKGROUP_SIZE = 64;
+
+            /**
+             * @struct IndirectRendererCreationProperties
+             * @brief Holds the properties required to create an indirect renderer.
+             */
+            struct IndirectRendererCreationProperties {
+                /*
+                 * @brief The Vulkan physical device the buffers are allocated from.
+                */
+                VkPhysicalDevice _physicalDevice;
+                /*
+                 * @brief The Vulkan logical device used to create the buffers and the pipeline.
+                */
+                VkDevice _logicalDevice;
+                /*
+                 * @brief The optional features enabled on the logical device.
+                */
+                Utils::DeviceCapabilities _capabilities;
+                /*
+                 * @brief The maximum number of objects, the size of every buffer.
+                */
+                uint32_t _maxObjects = 65536;
+                /*
+                 * @brief The directory containing the compiled `cull.comp.spv` shader.
+                */
+                std::string _shaderDirectory = "shaders";
+                /*
+                 * @brief The pipeline cache the culling pipeline is compiled through, if any.
+                */
+                VkPipelineCache _pipelineCache = VK_NULL_HANDLE;
+            };
+
+            /**
+             * @brief Creates the buffers, the descriptor set and the culling pipeline.
+             *
+             * @param properties The properties required to create the renderer.
+             *
+             * @throws std::runtime_error If the device lacks multi-draw indirect, or if a Vulkan object creation fails.
+             */
+            IndirectRenderer(const IndirectRendererCreationProperties& properties);
+
+            /**
+             * @brief Destroys the pipeline, layouts, descriptor pool and buffers.
+             */
+            ~IndirectRenderer();
+
+            IndirectRenderer(const IndirectRenderer& other) = delete;
+            IndirectRenderer& operator=(const IndirectRenderer& other) = delete;
+
+            /**
+             * @brief Adds an object, uploaded with the next culling pass.
+             *
+             * @param object The bounds and draw parameters of the object.
+             * @return uint32_t The index of the object, reused once the object is removed.
+             *
+             * @throws std::runtime_error If the renderer already holds its maximum number of objects.
+             */
+            uint32_t addObject(const IndirectObject& object);
+
+            /**
+             * @brief Replaces an object, for instance after it moved.
+             *
+             * @param index The index returned by addObject().
+             * @param object The new bounds and draw parameters of the object.
+             *
+             * @throws std::runtime_error If no object has that index.
+             */
+            void updateObject(uint32_t index, const IndirectObject& object);
+
+            /**
+             * @brief Removes an object, it is culled from the next culling pass on.
+             *
+             * @param index The index returned by addObject().
+             *
+             * @throws std::runtime_error If no object has that index.
+             */
+            void removeObject(uint32_t index);
+
+            /**
+             * @brief Records the upload of the changed objects and the culling pass.
+             *
+             * @param commandBuffer The command buffer, in the recording state, outside of any render pass.
+             * @param viewProjection The view-projection matrix of the camera, for a [0, 1] depth range.
+             */
+            void recordCulling(VkCommandBuffer commandBuffer, const glm::mat4& viewProjection);
+
+            /**
+             * @brief Records the draws of the objects left by the last culling pass.
+             *
+             * The graphics pipeline, vertex and index buffers and descriptor sets must already be bound.
+             *
+             * @param commandBuffer The command buffer recordCulling() was recorded to, inside a render pass.
+             */
+            void recordDraws(VkCommandBuffer commandBuffer) const;
+
+            uint32_t getObjectCount() const {
+                return _objectCount - static_cast<uint32_t>(_freeIndices.size());
+            }
+
+        private:
+            /**
+             * @brief Extends the range of objects uploaded by the next culling pass.
+             */
+            void markDirty(uint32_t index);
+
+            void createBuffers();
+
+            void createPipeline();
+
+            IndirectRendererCreationProperties _properties;         // Vulkan objects and settings
+            PFN_vkCmdDrawIndexedIndirectCountKHR _drawIndexedIndirectCount = nullptr;   // Null without VK_KHR_draw_indirect_count
+
+            std::vector<IndirectObject> _objects;                   // Copy of the object buffer
+            std::vector<uint32_t> _freeIndices;                     // Indices of removed objects, reused first
+            uint32_t _objectCount = 0;                              // Number of object slots in use, removed ones included
+            uint32_t _dirtyBegin = 0;                               // First object to upload
+            uint32_t _dirtyEnd = 0;                                 // Past the last object to upload
+
+            VkBuffer _objectBuffer;                                 // Bounds and draw parameters of the objects
+            VkDeviceMemory _objectBufferMemory;
+            VkBuffer _drawBuffer;                                   // Draw commands written by the culling pass
+            VkDeviceMemory _drawBufferMemory;
+            VkBuffer _countBuffer;                                  // Number of draw commands written by the culling pass
+            VkDeviceMemory _countBufferMemory;
+
+            VkDescriptorSetLayout _descriptorSetLayout;             // Object, draw and count buffers
+            VkPipelineLayout _pipelineLayout;                       // Descriptor set layout and push constants
+            VkDescriptorPool _descriptorPool;                       // Pool the descriptor set is allocated from
+            VkDescriptorSet _descriptorSet;                         // Object, draw and count buffers
+            VkPipeline _pipeline;                                   // Pipeline of shaders/cull.comp
+    };
+}
@@ -0,0 +1,167 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** InstanceBatcher
+*/
+
+#pragma once
+
+#include "maverik.hpp"
+#include "VertexLayout.hpp"
+#include "GeometryPool.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+namespace maverik {
+    /**
+     * @brief Per-instance attributes, read from the second vertex binding at instance rate.
+     *
+     * The transform takes four consecutive locations, one per column, as a `mat4`
+     * vertex input does in GLSL. See shaders/instanced.vert.
+     */
+    struct InstanceData {
+        glm::mat4 _transform = glm::mat4(1.0f);     // Model matrix of the instance
+        glm::vec4 _color = glm::vec4(1.0f);         // Tint multiplied with the vertex color, alpha is the LOD dither coverage (see LodSelection)
+
+        using Layout = VertexLayout<vertex::InstanceF32x4, vertex::InstanceF32x4, vertex::InstanceF32x4, vertex::InstanceF32x4,
+            vertex::InstanceF32x4>;
+
+        static constexpr uint32_t BINDING = 1;          // Binding the instance buffer is bound to, Vertex uses 0
+        static constexpr uint32_t FIRST_LOCATION = 3;   // Location of the first column of the transform, after the attributes of Vertex
+
+        static VkVertexInputBindingDescription getBindingDescription() {
+            return Layout::getBindingDescription(BINDING, VK_VERTEX_INPUT_RATE_INSTANCE);
+        }
+
+        static std::array<VkVertexInputAttributeDescription, Layout::ATTRIBUTE_COUNT> getAttributeDescriptions() {
+            return Layout::getAttributeDescriptions(BINDING, FIRST_LOCATION);
+        }
+    };
+
+    static_assert(InstanceData::Layout::STRIDE == sizeof(InstanceData), "InstanceData::Layout must describe every member of InstanceData");
+    static_assert(InstanceData::Layout::OFFSETS[4] == offsetof(InstanceData, _color), "InstanceData::Layout must follow the member order of InstanceData");
+
+    /**
+     * @class InstanceBatcher
+     * @brief Groups the objects submitted during a frame into one instanced draw per mesh and material.
+     *
+     * Objects are submitted in any order with their mesh, material and instance data.
+     * build() gathers the instances of every mesh/material pair contiguously into the
+     * instance buffer of the frame, and draw() records a single vkCmdDrawIndexed per
+     * pair, sorted by material so that materials change as rarely as possible.
+     *
+     * Instance buffers are host-visible, persistently mapped and kept per frame in
+     * flight, so that writing the instances of a frame never races with the GPU still
+     * reading those of the previous one. They grow when a frame needs more room.
+     */
+    class InstanceBatcher {
+        public:
+            /**
+             * @brief A single instanced draw.
+             */
+            struct Batch {
+                uint32_t _mesh;             // Mesh drawn, as returned by addMesh()
+                uint32_t _material;         // Material of the instances, such as a bindless texture slot
+                uint32_t _firstInstance;    // First instance of the batch in the instance buffer
+                uint32_t _instanceCount;    // Number of instances drawn
+            };
+
+            /**
+             * @brief Creates the batcher, instance buffers are created on first use.
+             *
+             * @param logicalDevice The Vulkan logical device owning the instance buffers.
+             * @param physicalDevice The physical device the memory of the instance buffers is allocated from.
+             * @param frameCount The number of frames in flight, one instance buffer is kept for each.
+             */
+            InstanceBatcher(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, uint32_t frameCount);
+
+            ~InstanceBatcher();
+
+            /**
+             * @brief Registers a mesh living in the bound vertex and index buffers.
+             *
+             * @param range The indices of the mesh.
+             * @return uint32_t The identifier the mesh is submitted with.
+             */
+            uint32_t addMesh(const MeshRange& range);
+
+            /**
+             * @brief Forgets the objects submitted so far, to be called at the start of each frame.
+             */
+            void clear();
+
+            /**
+             * @brief Queues an instance of a mesh to be drawn with a material.
+             *
+             * @param mesh The identifier returned by addMesh().
+             * @param material The material, such as a bindless texture slot.
+             * @param instance The per-instance attributes.
+             *
+             * @throws std::runtime_error If the mesh was not registered.
+             */
+            void submit(uint32_t mesh, uint32_t material, const InstanceData& instance);
+
+            /**
+             * @brief Groups the submitted instances and writes them into the instance buffer of a frame.
+             *
+             * @param currentFrame The index of the frame in flight, whose previous use the GPU has completed.
+             * @return const std::vector<Batch>& The batches, sorted by material then mesh.
+             */
+            const std::vector<Batch>& build(uint32_t currentFrame);
+
+            /**
+             * @brief Records the batches built for a frame.
+             *
+             * The instance buffer is bound to InstanceData::BINDING. The pipeline, the vertex
+             * and index buffers and the descriptor sets must already be bound.
+             *
+             * @param commandBuffer The command buffer, in the recording state, inside a render pass.
+             * @param currentFrame The index of the frame in flight given to build().
+             * @param setMaterial Called before the first batch of each material, for instance to push its texture slot.
+             */
+            void draw(VkCommandBuffer commandBuffer, uint32_t currentFrame, const std::function<void(VkCommandBuffer, uint32_t)>& setMaterial) const;
+
+            const std::vector<Batch>& getBatches() const {
+                return _batches;
+            }
+
+            size_t getInstanceCount() const {
+                return _instances.size();
+            }
+
+        private:
+            /**
+             * @brief A persistently mapped instance buffer.
+             */
+            struct FrameBuffer {
+                VkBuffer _buffer = VK_NULL_HANDLE;
+                VkDeviceMemory _memory = VK_NULL_HANDLE;
+                void *_mapped = nullptr;
+                size_t _capacity = 0;       // Number of instances the buffer holds
+            };
+
+            /**
+             * @brief Recreates the instance buffer of a frame if it cannot hold the given number of instances.
+             */
+            void reserve(FrameBuffer& frame, size_t instanceCount);
+
+            void destroy(FrameBuffer& frame);
+
+            VkDevice _logicalDevice;
+            VkPhysicalDevice _physicalDevice;
+            std::vector<FrameBuffer> _frames;                       // Instance buffer of each frame in flight
+
+            std::vector<MeshRange> _meshes;                         // Registered meshes, indexed by identifier
+            std::vector<uint32_t> _submittedMeshes;                 // Mesh of each submitted instance
+            std::vector<uint32_t> _submittedMaterials;              // Material of each submitted instance
+            std::vector<InstanceData> _submittedInstances;          // Attributes of each submitted instance
+
+            std::unordered_map<uint64_t, uint32_t> _batchIndices;   // Batch of each mesh/material pair, while building
+            std::vector<Batch> _batches;                            // Batches of the last build
+            std::vector<InstanceData> _instances;                   // Instances of the last build, grouped by batch
+    };
+}
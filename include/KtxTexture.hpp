@@ -0,0 +1,149 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** KtxTexture
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+#include "FileAsset.hpp"
+
+namespace maverik {
+    /**
+     * @class KtxTexture
+     * @brief Minimal KTX2 container reader for 2D textures.
+     *
+     * This class parses the header and level index of a KTX2 file and exposes the
+     * payload of each mip level as stored in the file, so that GPU-compressed data
+     * (BC1-7, ETC2, ASTC) and its precomputed mip chain can be uploaded as-is.
+     *
+     * Only non-supercompressed 2D textures are supported: Basis Universal and
+     * zstd supercompressed files, cubemaps, arrays and 3D textures are rejected.
+     *
+     * @note The file is expected to be little-endian, as mandated by the KTX2 specification.
+     */
+    class KtxTexture {
+        public:
+            /**
+             * @struct Level
+             * @brief Location of a mip level payload inside the file.
+             */
+            struct Level {
+                uint64_t _byteOffset;   // Offset of the level from the start of the file
+                uint64_t _byteLength;   // Size of the level in bytes
+            };
+
+            /**
+             * @brief Parses a KTX2 file already loaded in memory.
+             *
+             * @param data The whole content of the file, the texture takes ownership of it.
+             *
+             * @throws std::runtime_error If the data is not a supported KTX2 texture.
+             */
+            KtxTexture(std::vector<char> data);
+
+            /**
+             * @brief Parses a KTX2 file held by an asset, without copying it.
+             *
+             * The level payloads are read straight from the content of the asset, which the
+             * texture keeps alive.
+             *
+             * @param asset The asset holding the whole content of the file.
+             *
+             * @throws std::runtime_error If the asset is null or is not a supported KTX2 texture.
+             */
+            KtxTexture(std::shared_ptr<FileAsset> asset);
+
+            ~KtxTexture() = default;
+
+            /**
+             * @brief Loads and parses a KTX2 file from disk.
+             *
+             * @param path The path to the `.ktx2` file.
+             * @return KtxTexture The parsed texture.
+             *
+             * @throws std::runtime_error If the file cannot be read or is not a supported KTX2 texture.
+             */
+            static KtxTexture fromFile(const std::string& path);
+
+            /**
+             * @brief Checks whether a path designates a KTX2 file, based on its extension.
+             *
+             * @param path The path to check.
+             * @return true if the path ends with `.ktx2`, false otherwise.
+             */
+            static bool isKtx2Path(const std::string& path);
+
+            /**
+             * @brief Checks whether a format is block-compressed (BC, ETC2, EAC or ASTC).
+             *
+             * @param format The format to check.
+             * @return true if the format is block-compressed, false otherwise.
+             */
+            static bool isCompressedFormat(VkFormat format);
+
+            VkFormat getFormat() const {
+                return _format;
+            }
+
+            uint32_t getWidth() const {
+                return _width;
+            }
+
+            uint32_t getHeight() const {
+                return _height;
+            }
+
+            uint32_t getLevelCount() const {
+                return static_cast<uint32_t>(_levels.size());
+            }
+
+            const std::vector<Level>& getLevels() const {
+                return _levels;
+            }
+
+            /**
+             * @brief Get a pointer to the payload of a mip level.
+             *
+             * @param level The mip level, 0 being the full resolution image.
+             * @return const char* The level data, `getLevels()[level]._byteLength` bytes long.
+             */
+            const char *getLevelData(uint32_t level) const {
+                return this->getBytes() + _levels.at(level)._byteOffset;
+            }
+
+        private:
+            /**
+             * @brief Parses the header and the level index of the file.
+             *
+             * @param bytes The content of the file.
+             * @param size The size of the file in bytes.
+             *
+             * @throws std::runtime_error If the content is not a supported KTX2 texture.
+             */
+            void parse(const char *bytes, size_t size);
+
+            /**
+             * @brief Get the content of the file, whether owned or held by an asset.
+             */
+            const char *getBytes() const {
+                return _asset != nullptr ? _asset->content().data() : _data.data();
+            }
+
+            std::vector<char> _data;                // Content of the file, when owned
+            std::shared_ptr<FileAsset> _asset;      // Asset holding the content of the file, if any
+            VkFormat _format;               // Vulkan format of the payload
+            uint32_t _width;                // Width of the base level in pixels
+            uint32_t _height;               // Height of the base level in pixels
+            std::vector<Level> _levels;     // Mip levels, from the base level to the smallest
+    };
+}
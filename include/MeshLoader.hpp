@@ -0,0 +1,120 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** MeshLoader
+*/
+
+#pragma once
+
+#include "Vertex.hpp"
+#include "FileAsset.hpp"
+#include "ThreadPool.hpp"
+#include "AAssetManager.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+
+namespace maverik {
+    /**
+     * @brief Vertex and index arrays of a mesh, ready to be uploaded.
+     */
+    struct MeshData {
+        std::vector<Vertex> _vertices;      // Unique vertices of the mesh
+        std::vector<uint32_t> _indices;     // Triangle list indexing _vertices
+    };
+
+    /**
+     * @class MeshLoader
+     * @brief Imports Wavefront OBJ and binary glTF 2.0 meshes as indexed triangle lists.
+     *
+     * Files are split into chunks parsed on the workers of a thread pool. Vertices are
+     * then welded: every triangle corner is looked up by value in open-addressing hash
+     * tables, first per chunk in parallel, then once more across chunks, so that equal
+     * vertices end up sharing a single index. The order of the output only depends on
+     * the file, not on the scheduling of the workers.
+     *
+     * Normals are not imported, as Vertex has no room for them. Vertices without a
+     * color are white.
+     */
+    class MeshLoader {
+        public:
+            /**
+             * @brief Creates a loader running its tasks on a thread pool.
+             *
+             * @param threadPool The pool parsing and welding the meshes, it must outlive the loader.
+             */
+            MeshLoader(ThreadPool& threadPool);
+
+            ~MeshLoader() = default;
+
+            /**
+             * @brief Checks whether a path names a mesh this loader can import.
+             *
+             * @param path The path of the mesh.
+             * @return true if the path ends with `.obj` or `.glb`.
+             */
+            static bool isMeshPath(const std::string& path);
+
+            /**
+             * @brief Reads a mesh through an asset manager, then imports it.
+             *
+             * @param path The path of the mesh, its extension selects the format.
+             * @param assetManager The asset manager reading the file.
+             * @return MeshData The welded vertices and indices of the mesh.
+             *
+             * @throws std::runtime_error If the file cannot be read, its format is unknown or it is malformed.
+             */
+            MeshData load(const std::string& path, AAssetManager& assetManager);
+
+            /**
+             * @brief Imports a Wavefront OBJ mesh.
+             *
+             * Faces are triangulated as fans, relative (negative) indices are supported,
+             * as are vertex colors written after the position (`v x y z r g b`).
+             *
+             * @param asset The asset holding the text of the file.
+             * @return MeshData The welded vertices and indices of the mesh.
+             *
+             * @throws std::runtime_error If a face references an element that does not exist.
+             */
+            MeshData loadObj(const FileAsset& asset);
+
+            /**
+             * @brief Imports every triangle primitive of the default scene of a binary glTF 2.0 file.
+             *
+             * Nodes are flattened with their world transform applied to the positions.
+             * Only the embedded binary buffer is supported, external buffers are rejected.
+             *
+             * @param asset The asset holding the content of the file.
+             * @return MeshData The welded vertices and indices of the mesh.
+             *
+             * @throws std::runtime_error If the file is not a valid binary glTF 2.0 file or uses an unsupported feature.
+             */
+            MeshData loadGlb(const FileAsset& asset);
+
+        private:
+            /**
+             * @brief Welds the triangle corners of a mesh into unique vertices.
+             *
+             * @param cornerCount The number of corners, three per triangle.
+             * @param getCorner Returns the vertex of a corner, called concurrently from the workers.
+             * @return MeshData The unique vertices and one index per corner.
+             */
+            template <typename GetCorner>
+            MeshData weld(size_t cornerCount, const GetCorner& getCorner);
+
+            /**
+             * @brief Splits a range into one contiguous chunk per task.
+             *
+             * @param count The size of the range.
+             * @param minimumChunkSize The size below which chunks are not split further.
+             * @return std::vector<size_t> The chunk boundaries, from 0 to count.
+             */
+            std::vector<size_t> splitRange(size_t count, size_t minimumChunkSize) const;
+
+            ThreadPool& _threadPool;        // Pool running the parsing and welding tasks
+    };
+}
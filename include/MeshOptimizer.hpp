@@ -0,0 +1,105 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** MeshOptimizer
+*/
+
+#pragma once
+
+#include "MeshLoader.hpp"
+
+#include <vector>
+#include <cstdint>
+
+namespace maverik {
+    /**
+     * @class MeshOptimizer
+     * @brief Reorders the triangles and vertices of indexed meshes for faster rendering.
+     *
+     * The passes are meant to run in order, as optimize() does:
+     *  - optimizeVertexCache() sorts triangles with Tipsify (Sander et al. 2007) so
+     *    that vertices are reused while still in the post-transform cache,
+     *  - optimizeOverdraw() then sorts clusters of those triangles so that the ones
+     *    facing outwards are drawn first and occlude the others, without giving up
+     *    more than a bounded share of cache hits,
+     *  - optimizeVertexFetch() finally renumbers vertices in order of first use so
+     *    that vertex fetches walk memory linearly, and drops unreferenced vertices.
+     *
+     * Meshes with fewer than 65536 vertices are drawn with 16-bit indices, see
+     * selectIndexType().
+     */
+    class MeshOptimizer {
+        public:
+            /**
+             * @brief Runs the vertex cache, overdraw and vertex fetch passes on a mesh.
+             *
+             * @param mesh The mesh to optimize in place.
+             */
+            static void optimize(MeshData& mesh);
+
+            /**
+             * @brief Reorders triangles for post-transform vertex cache reuse with Tipsify.
+             *
+             * @param indices The triangle list to reorder in place.
+             * @param vertexCount The number of vertices indexed by the triangle list.
+             * @param cacheSize The number of entries of the simulated cache.
+             * @return std::vector<size_t> The first triangle of every cluster, clusters starting where the traversal hit a dead end.
+             */
+            static std::vector<size_t> optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+
+            /**
+             * @brief Reorders clusters of triangles so that outward-facing ones are drawn first.
+             *
+             * Clusters are split further as long as each piece keeps its cache miss ratio
+             * within threshold times the one of the whole cluster, then sorted.
+             *
+             * @param indices The triangle list, as reordered by optimizeVertexCache().
+             * @param vertices The vertices indexed by the triangle list.
+             * @param clusters The clusters returned by optimizeVertexCache().
+             * @param threshold The cache miss ratio the overdraw ordering may cost, relative to the vertex cache ordering.
+             * @param cacheSize The number of entries of the simulated cache.
+             */
+            static void optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, const std::vector<size_t>& clusters,
+                float threshold = DEFAULT_OVERDRAW_THRESHOLD, uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+
+            /**
+             * @brief Renumbers vertices in order of first use and drops the unreferenced ones.
+             *
+             * @param vertices The vertices to reorder in place.
+             * @param indices The triangle list, remapped to the new vertex order.
+             */
+            static void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+            /**
+             * @brief Computes the average number of cache misses per triangle of a triangle list.
+             *
+             * @param indices The triangle list.
+             * @param vertexCount The number of vertices indexed by the triangle list.
+             * @param cacheSize The number of entries of the simulated FIFO cache.
+             * @return float The average cache miss ratio, between 0.5 at best and 3.
+             */
+            static float computeAcmr(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+
+            /**
+             * @brief Selects the smallest index type able to address every vertex.
+             *
+             * 0xFFFF is kept free as it is the primitive restart value of 16-bit indices.
+             *
+             * @param vertexCount The number of vertices of the mesh.
+             * @return VkIndexType `VK_INDEX_TYPE_UINT16` when possible, `VK_INDEX_TYPE_UINT32` otherwise.
+             */
+            static VkIndexType selectIndexType(size_t vertexCount);
+
+            /**
+             * @brief Converts indices to 16 bits.
+             *
+             * @param indices The indices, all below 0xFFFF.
+             * @return std::vector<uint16_t> The narrowed indices.
+             */
+            static std::vector<uint16_t> narrowIndices(const std::vector<uint32_t>& indices);
+
+            static constexpr uint32_t DEFAULT_CACHE_SIZE = 16;          // Post-transform cache entries assumed by default
+            static constexpr float DEFAULT_OVERDRAW_THRESHOLD = 1.05f;  // Cache efficiency traded for overdraw by default
+    };
+}
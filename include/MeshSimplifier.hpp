@@ -0,0 +1,133 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** MeshSimplifier
+*/
+
+#pragma once
+
+#include "MeshLoader.hpp"
+
+#include <cfloat>
+#include <vector>
+#include <cstdint>
+
+namespace maverik {
+    /**
+     * @brief A level of detail of a mesh, a range of its index buffer.
+     *
+     * Every level indexes the vertices of the mesh, so all of them share its vertex buffer.
+     */
+    struct LodLevel {
+        uint32_t _firstIndex = 0;       // First index of the level, relative to the indices of the mesh
+        uint32_t _indexCount = 0;       // Number of indices, three per triangle
+        float _error = 0.0f;            // Upper bound of the distance to the full mesh, in object space
+    };
+
+    /**
+     * @brief The level of detail to draw an object with, and the one it fades to.
+     *
+     * While `_fade` is 0, only `_level` is drawn, with a coverage of 1. Otherwise both levels
+     * are drawn with complementary dither patterns: `_level` with a coverage of `-_fade` and
+     * `_fadeLevel` with a coverage of `_fade`, see shaders/lod_dither.glsl. Every pixel is then
+     * covered by exactly one of them, and the switch to the coarser level happens without popping.
+     *
+     * Use getLevelCoverage() rather than negating `_fade`: -0.0 compares equal to 0 in the
+     * shader, which would discard every pixel of `_level` when not fading.
+     */
+    struct LodSelection {
+        uint32_t _level = 0;            // Level to draw
+        uint32_t _fadeLevel = 0;        // Coarser level fading in, equal to _level when not fading
+        float _fade = 0.0f;             // Share of the pixels already drawn with _fadeLevel, in [0, 1)
+
+        /**
+         * @brief Get whether `_fadeLevel` must be drawn too.
+         */
+        bool isFading() const {
+            return _fade > 0.0f;
+        }
+
+        /**
+         * @brief Get the dither coverage `_level` is drawn with.
+         */
+        float getLevelCoverage() const {
+            return this->isFading() ? -_fade : 1.0f;
+        }
+
+        /**
+         * @brief Get the dither coverage `_fadeLevel` is drawn with, only meaningful while fading.
+         */
+        float getFadeLevelCoverage() const {
+            return _fade;
+        }
+    };
+
+    /**
+     * @class MeshSimplifier
+     * @brief Generates levels of detail of indexed meshes with quadric error metrics.
+     *
+     * Meshes are simplified with half-edge collapses ordered by the quadric error of
+     * Garland and Heckbert (1997): a vertex is merged into a neighbour, so no vertex is
+     * moved or created and simplified meshes only need a new index buffer. Collapses
+     * flipping a triangle are rejected.
+     *
+     * Vertices on open borders and on attribute seams, where vertices share a position
+     * but not a color or texture coordinate, are kept so that neither holes nor texture
+     * cracks appear.
+     */
+    class MeshSimplifier {
+        public:
+            /**
+             * @brief Simplifies a triangle list without changing its vertices.
+             *
+             * @param vertices The vertices indexed by the triangle list.
+             * @param indices The triangle list to simplify.
+             * @param targetIndexCount The number of indices to reach, more remain when the error limit or the locked vertices prevent it.
+             * @param maxError The largest distance to the input the collapses may introduce, in object space.
+             * @param resultError If not null, receives the distance actually introduced.
+             * @return std::vector<uint32_t> The simplified triangle list, indexing the same vertices.
+             */
+            static std::vector<uint32_t> simplify(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                size_t targetIndexCount, float maxError = FLT_MAX, float *resultError = nullptr);
+
+            /**
+             * @brief Appends coarser levels of detail to the index buffer of a mesh.
+             *
+             * Each level is simplified from the previous one to `reduction` times its
+             * triangle count, then reordered for the vertex cache. Generation stops early
+             * once a level barely shrinks. The indices of the mesh stay the first level.
+             *
+             * @param mesh The mesh, its index buffer grows with the indices of every level.
+             * @param maxLevels The maximum number of levels, the full mesh included.
+             * @param reduction The triangle count of each level relative to the previous one.
+             * @return std::vector<LodLevel> The levels, finest first, with increasing errors.
+             */
+            static std::vector<LodLevel> generateLods(MeshData& mesh, uint32_t maxLevels = DEFAULT_LOD_COUNT, float reduction = DEFAULT_LOD_REDUCTION);
+
+            /**
+             * @brief Selects the coarsest level whose error stays below a number of pixels on screen.
+             *
+             * @param levels The levels returned by generateLods().
+             * @param distance The distance from the camera to the object, in object space units.
+             * @param projectionScale The number of pixels covered by one unit at distance 1, see getProjectionScale().
+             * @param pixelError The largest error allowed on screen, in pixels.
+             * @param fadeRange How far above pixelError the next level starts fading in, relative to pixelError. 0 disables fading.
+             * @return LodSelection The level to draw, and the one fading in.
+             */
+            static LodSelection selectLod(const std::vector<LodLevel>& levels, float distance, float projectionScale,
+                float pixelError = DEFAULT_PIXEL_ERROR, float fadeRange = 0.0f);
+
+            /**
+             * @brief Get the number of pixels covered by one unit at distance 1 with a perspective projection.
+             *
+             * @param fovY The vertical field of view, in radians.
+             * @param viewportHeight The height of the viewport, in pixels.
+             */
+            static float getProjectionScale(float fovY, float viewportHeight);
+
+            static constexpr uint32_t DEFAULT_LOD_COUNT = 4;            // Levels generated by default, the full mesh included
+            static constexpr float DEFAULT_LOD_REDUCTION = 0.5f;        // Triangles kept from one level to the next by default
+            static constexpr float DEFAULT_PIXEL_ERROR = 1.0f;          // Screen-space error tolerated by default, in pixels
+    };
+}
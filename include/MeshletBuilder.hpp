@@ -0,0 +1,71 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** MeshletBuilder
+*/
+
+#pragma once
+
+#include "Vertex.hpp"
+
+#include <vector>
+#include <cstdint>
+
+namespace maverik {
+    /**
+     * @brief A cluster of neighbouring triangles, culled as a whole.
+     *
+     * Its triangles are contiguous in the index buffer of the mesh, so a visible
+     * meshlet is drawn as a single range of indices.
+     */
+    struct Meshlet {
+        uint32_t _firstIndex;       // First index of the meshlet in the index buffer
+        uint32_t _indexCount;       // Number of indices, three per triangle
+        uint32_t _vertexCount;      // Number of distinct vertices referenced
+        glm::vec3 _center;          // Center of the bounding sphere
+        float _radius;              // Radius of the bounding sphere
+        glm::vec3 _coneAxis;        // Average direction of the triangle normals
+        float _coneCutoff;          // Sine of the half angle of the normal cone, 1 if the cone cannot be culled
+    };
+
+    /**
+     * @class MeshletBuilder
+     * @brief Splits indexed meshes into meshlets of bounded vertex and triangle counts.
+     *
+     * Meshlets are grown greedily from a seed triangle, always adding the neighbouring
+     * triangle bringing the fewest new vertices, closest to the meshlet first. This keeps
+     * them compact, which tightens their bounding spheres and normal cones.
+     *
+     * Normal cones assume counter-clockwise front faces, as the Vulkan pipelines use.
+     */
+    class MeshletBuilder {
+        public:
+            /**
+             * @brief Splits a mesh into meshlets, reordering its triangles so each meshlet is contiguous.
+             *
+             * @param vertices The vertices of the mesh.
+             * @param indices The triangle list of the mesh, reordered in place.
+             * @param maxVertices The maximum number of distinct vertices per meshlet.
+             * @param maxTriangles The maximum number of triangles per meshlet.
+             * @return std::vector<Meshlet> The meshlets, in index buffer order.
+             *
+             * @throws std::runtime_error If a limit is too small to hold a triangle.
+             */
+            static std::vector<Meshlet> build(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                uint32_t maxVertices = DEFAULT_MAX_VERTICES, uint32_t maxTriangles = DEFAULT_MAX_TRIANGLES);
+
+            static constexpr uint32_t DEFAULT_MAX_VERTICES = 64;        // Vertices per meshlet, as mesh shading hardware favours
+            static constexpr uint32_t DEFAULT_MAX_TRIANGLES = 124;      // Triangles per meshlet, 124 keeps 8-bit local indices 4-byte aligned
+
+        private:
+            /**
+             * @brief Computes the bounding sphere and normal cone of a meshlet.
+             *
+             * @param vertices The vertices of the mesh.
+             * @param indices The triangle list of the mesh, the meshlet range already in place.
+             * @param meshlet The meshlet whose bounds are filled.
+             */
+            static void computeBounds(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, Meshlet& meshlet);
+    };
+}
@@ -0,0 +1,84 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** MeshletCuller
+*/
+
+#pragma once
+
+#include "MeshletBuilder.hpp"
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+namespace maverik {
+    /**
+     * @class MeshletCuller
+     * @brief Rejects the meshlets of a mesh lying outside the view frustum or facing away from the camera.
+     *
+     * The bounds of the meshlets are copied as a structure of arrays when the culler is
+     * created, so that each frame tests four meshlets at a time with SSE2 or NEON, with a
+     * scalar fallback otherwise. Visible meshlets are then merged into as few index ranges
+     * as possible, since meshlets are contiguous in the index buffer.
+     */
+    class MeshletCuller {
+        public:
+            /**
+             * @brief A range of the index buffer to draw with vkCmdDrawIndexed.
+             */
+            struct DrawRange {
+                uint32_t _firstIndex;       // First index of the range
+                uint32_t _indexCount;       // Number of indices of the range
+            };
+
+            /**
+             * @brief Copies the bounds of the meshlets of a mesh.
+             *
+             * @param meshlets The meshlets, as returned by MeshletBuilder::build().
+             */
+            MeshletCuller(const std::vector<Meshlet>& meshlets);
+
+            ~MeshletCuller() = default;
+
+            /**
+             * @brief Collects the index ranges of the visible meshlets.
+             *
+             * @param viewProjection The view-projection matrix of the camera, for a [0, 1] depth range.
+             * @param cameraPosition The position of the camera, in the space of the meshlets.
+             * @param ranges The index ranges to draw, cleared first.
+             *
+             * @note Meshlet bounds are in model space: for a transformed mesh, pass the
+             * model-view-projection matrix and the camera position in model space.
+             */
+            void cull(const glm::mat4& viewProjection, const glm::vec3& cameraPosition, std::vector<DrawRange>& ranges) const;
+
+            size_t getMeshletCount() const {
+                return _firstIndices.size();
+            }
+
+            /**
+             * @brief Extracts the six normalized frustum planes of a view-projection matrix.
+             *
+             * @param viewProjection The view-projection matrix, for a [0, 1] depth range.
+             * @return std::array<glm::vec4, 6> The planes, as normal and distance, their normals pointing inwards.
+             */
+            static std::array<glm::vec4, 6> extractFrustumPlanes(const glm::mat4& viewProjection);
+
+        private:
+
+            // Bounds of the meshlets, padded to a multiple of four with meshlets never visible
+            std::vector<float> _centerX;
+            std::vector<float> _centerY;
+            std::vector<float> _centerZ;
+            std::vector<float> _radius;
+            std::vector<float> _coneAxisX;
+            std::vector<float> _coneAxisY;
+            std::vector<float> _coneAxisZ;
+            std::vector<float> _coneCutoff;
+
+            std::vector<uint32_t> _firstIndices;    // First index of each meshlet
+            std::vector<uint32_t> _indexCounts;     // Number of indices of each meshlet
+    };
+}
@@ -0,0 +1,80 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** MipGenerator
+*/
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace maverik {
+    /**
+     * @class MipGenerator
+     * @brief CPU mip chain generation for RGBA8 images.
+     *
+     * Each level is filtered in linear space: sRGB color channels are decoded
+     * before filtering and encoded back afterwards, while alpha is filtered as-is.
+     * Pixels are processed as four-float vectors, using SSE2 or NEON when available
+     * and a scalar fallback otherwise.
+     *
+     * @note This class has no Vulkan dependency so it can be used by offline tools.
+     */
+    class MipGenerator {
+        public:
+            /**
+             * @enum Filter
+             * @brief The downsampling filter used between two levels.
+             */
+            enum class Filter {
+                BOX,        ///> 2x2 average, fast but slightly blurry and prone to aliasing
+                KAISER      ///> Separable Kaiser-windowed sinc, sharper levels with less aliasing
+            };
+
+            /**
+             * @struct MipLevel
+             * @brief One level of a mip chain.
+             */
+            struct MipLevel {
+                uint32_t _width;                // Width of the level in pixels
+                uint32_t _height;               // Height of the level in pixels
+                std::vector<uint8_t> _pixels;   // Tightly packed RGBA8 pixels
+            };
+
+            /**
+             * @brief Generates the full mip chain of an RGBA8 image, down to 1x1.
+             *
+             * @param pixels The tightly packed RGBA8 pixels of the base level.
+             * @param width The width of the base level in pixels.
+             * @param height The height of the base level in pixels.
+             * @param filter The downsampling filter.
+             * @param srgb Whether the color channels are sRGB encoded.
+             * @return std::vector<MipLevel> Every level, the first one being a copy of the base level.
+             */
+            static std::vector<MipLevel> generate(const uint8_t *pixels, uint32_t width, uint32_t height, Filter filter = Filter::KAISER, bool srgb = true);
+
+        private:
+            /**
+             * @brief Halves a linear RGBA float image with a 2x2 box filter.
+             */
+            static void downsampleBox(const std::vector<float>& src, uint32_t srcWidth, uint32_t srcHeight, std::vector<float>& dst, uint32_t dstWidth, uint32_t dstHeight);
+
+            /**
+             * @brief Halves a linear RGBA float image with a separable Kaiser-windowed sinc filter.
+             */
+            static void downsampleKaiser(const std::vector<float>& src, uint32_t srcWidth, uint32_t srcHeight, std::vector<float>& dst, uint32_t dstWidth, uint32_t dstHeight);
+
+            /**
+             * @brief Converts RGBA8 pixels to linear RGBA floats.
+             */
+            static void decode(const uint8_t *pixels, size_t pixelCount, bool srgb, std::vector<float>& out);
+
+            /**
+             * @brief Converts linear RGBA floats back to RGBA8 pixels.
+             */
+            static void encode(const std::vector<float>& linear, bool srgb, std::vector<uint8_t>& out);
+    };
+}
@@ -0,0 +1,85 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** PipelineCache
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+namespace maverik {
+    /**
+     * @class PipelineCache
+     * @brief A VkPipelineCache persisted to disk, so pipelines compiled by a run are reused by the next ones.
+     *
+     * The cache is seeded from its file when the file was written for the same device:
+     * the vendor and device identifiers, the driver version and the pipeline cache UUID
+     * of the driver must match, and the data must be intact. Otherwise the cache starts
+     * empty, as drivers are not required to reject foreign or corrupted data safely.
+     *
+     * The cache is written back when destroyed. The data goes to a temporary file first,
+     * which then replaces the previous file, so a crash mid-write never leaves a truncated cache.
+     */
+    class PipelineCache {
+        public:
+            /**
+             * @brief Creates the cache, seeded from its file when the file matches the device.
+             *
+             * @param logicalDevice The Vulkan logical device the pipelines are created on.
+             * @param physicalDevice The Vulkan physical device the file must have been written for.
+             * @param path The file the cache is read from and written to.
+             *
+             * @throws std::runtime_error If the cache creation fails.
+             */
+            PipelineCache(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, const std::string& path);
+
+            /**
+             * @brief Writes the cache back to its file, then destroys it.
+             *
+             * Failures to write are reported on the standard error output.
+             */
+            ~PipelineCache();
+
+            PipelineCache(const PipelineCache& other) = delete;
+            PipelineCache& operator=(const PipelineCache& other) = delete;
+
+            /**
+             * @brief Writes the cache to its file, replacing the previous one atomically.
+             *
+             * @throws std::runtime_error If the data cannot be retrieved or the file cannot be written.
+             */
+            void save() const;
+
+            VkPipelineCache getHandle() const {
+                return _cache;
+            }
+
+            /**
+             * @brief Get whether the cache was seeded from its file.
+             */
+            bool isSeeded() const {
+                return _seeded;
+            }
+
+        private:
+            /**
+             * @brief Get the pipeline data of a cache file, if the file was written for the device.
+             *
+             * @param file The content of the file.
+             * @return std::vector<char> The data to seed the cache with, empty when the file is rejected.
+             */
+            std::vector<char> validate(const std::vector<char>& file) const;
+
+            VkDevice _logicalDevice;                        // Device the cache belongs to
+            VkPhysicalDeviceProperties _deviceProperties;   // Identifiers the file must match
+            std::string _path;                              // File the cache is persisted to
+            VkPipelineCache _cache = VK_NULL_HANDLE;        // Cache passed to pipeline creations
+            bool _seeded = false;                           // Whether the file was accepted
+    };
+}
@@ -0,0 +1,253 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** PipelineStateCache
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <future>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <vulkan/vulkan.h>
+
+#include "ThreadPool.hpp"
+
+namespace maverik {
+    /**
+     * @struct PipelineDescription
+     * @brief The state a graphics pipeline is compiled from.
+     *
+     * Viewport and scissor are always dynamic. The defaults describe opaque, back-face
+     * culled triangles with depth test and depth write enabled.
+     */
+    struct PipelineDescription {
+        /*
+         * @brief The path of the compiled vertex shader.
+        */
+        std::string _vertexShader;
+        /*
+         * @brief The path of the compiled fragment shader.
+        */
+        std::string _fragmentShader;
+        /*
+         * @brief The vertex input bindings, see VertexLayout::getBindingDescription().
+        */
+        std::vector<VkVertexInputBindingDescription> _bindings;
+        /*
+         * @brief The vertex attributes read from the bindings, see VertexLayout::getAttributeDescriptions().
+        */
+        std::vector<VkVertexInputAttributeDescription> _attributes;
+        /*
+         * @brief The primitive topology of the draws.
+        */
+        VkPrimitiveTopology _topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        /*
+         * @brief How the primitives are rasterized.
+        */
+        VkPolygonMode _polygonMode = VK_POLYGON_MODE_FILL;
+        /*
+         * @brief The faces that are culled.
+        */
+        VkCullModeFlags _cullMode = VK_CULL_MODE_BACK_BIT;
+        /*
+         * @brief The winding of front faces.
+        */
+        VkFrontFace _frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        /*
+         * @brief Whether fragments are tested against the depth buffer.
+        */
+        VkBool32 _depthTest = VK_TRUE;
+        /*
+         * @brief Whether fragments passing the test write their depth.
+        */
+        VkBool32 _depthWrite = VK_TRUE;
+        /*
+         * @brief The comparison of the depth test.
+        */
+        VkCompareOp _depthCompareOp = VK_COMPARE_OP_LESS;
+        /*
+         * @brief The blending of the color attachment, opaque by default.
+        */
+        VkPipelineColorBlendAttachmentState _blend = {
+            VK_FALSE,
+            VK_BLEND_FACTOR_SRC_ALPHA, VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA, VK_BLEND_OP_ADD,
+            VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD,
+            VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+        };
+        /*
+         * @brief The number of samples of the attachments.
+        */
+        VkSampleCountFlagBits _samples = VK_SAMPLE_COUNT_1_BIT;
+        /*
+         * @brief The minimum fraction of samples shaded individually, 0 disables sample shading.
+        */
+        float _minSampleShading = 0.0f;
+        /*
+         * @brief The layout of the descriptor sets and push constants of the pipeline.
+        */
+        VkPipelineLayout _layout = VK_NULL_HANDLE;
+        /*
+         * @brief The render pass the pipeline draws in.
+        */
+        VkRenderPass _renderPass = VK_NULL_HANDLE;
+        /*
+         * @brief The subpass of the render pass the pipeline draws in.
+        */
+        uint32_t _subpass = 0;
+    };
+
+    /**
+     * @enum PipelineStatus
+     * @brief Where the compilation of a pipeline stands.
+     */
+    enum class PipelineStatus {
+        MISSING,    ///> Never requested
+        COMPILING,  ///> Queued or being compiled by a worker
+        READY,      ///> Compiled, ready to be bound
+        FAILED      ///> The compilation failed, the description will not be compiled again
+    };
+
+    /**
+     * @class PipelineStateCache
+     * @brief Deduplicates graphics pipelines by their description and compiles them on worker threads.
+     *
+     * Each distinct PipelineDescription is compiled once. request() never blocks: the first
+     * request of a description queues its compilation on the thread pool and returns the
+     * fallback pipeline, later requests return the fallback until the pipeline is ready.
+     * Material variants therefore appear a few frames late instead of stalling the frame
+     * for the duration of a driver compilation. acquire() waits for the pipeline instead,
+     * for load time.
+     *
+     * Shaders are read and compiled on the workers too, through the VkPipelineCache given
+     * at creation, which Vulkan allows to be used from several threads at once.
+     *
+     * The cache owns its pipelines and destroys them with it.
+     *
+     * @note The methods of this class must be called from a single thread, only the
+     * compilations run on the workers.
+     */
+    class PipelineStateCache {
+        public:
+            /**
+             * @struct PipelineStateCacheCreationProperties
+             * @brief Holds the properties required to create a pipeline state cache.
+             */
+            struct PipelineStateCacheCreationProperties {
+                /*
+                 * @brief The Vulkan logical device the pipelines are created on.
+                */
+                VkDevice _logicalDevice;
+                /*
+                 * @brief The pipeline cache the pipelines are compiled through, if any.
+                */
+                VkPipelineCache _pipelineCache = VK_NULL_HANDLE;
+                /*
+                 * @brief The pool running the compilations, the cache starts its own when null.
+                */
+                ThreadPool *_threadPool = nullptr;
+            };
+
+            /**
+             * @brief Constructs an empty cache.
+             *
+             * @param properties The properties required to create the cache.
+             */
+            PipelineStateCache(const PipelineStateCacheCreationProperties& properties);
+
+            /**
+             * @brief Waits for the pending compilations, then destroys every pipeline.
+             */
+            ~PipelineStateCache();
+
+            PipelineStateCache(const PipelineStateCache& other) = delete;
+            PipelineStateCache& operator=(const PipelineStateCache& other) = delete;
+
+            /**
+             * @brief Get the pipeline of a description without waiting for its compilation.
+             *
+             * @param description The state of the pipeline.
+             * @param fallback The pipeline to draw with while the pipeline is not ready.
+             * @return VkPipeline The pipeline if it is ready, the fallback otherwise.
+             */
+            VkPipeline request(const PipelineDescription& description, VkPipeline fallback = VK_NULL_HANDLE);
+
+            /**
+             * @brief Get the pipeline of a description, compiling it on the calling thread if needed.
+             *
+             * @param description The state of the pipeline.
+             * @return VkPipeline The compiled pipeline.
+             *
+             * @throws std::runtime_error If the shaders cannot be read or the compilation fails.
+             */
+            VkPipeline acquire(const PipelineDescription& description);
+
+            /**
+             * @brief Get where the compilation of a description stands.
+             *
+             * @param description The state of the pipeline.
+             * @return PipelineStatus The status of the pipeline.
+             */
+            PipelineStatus getStatus(const PipelineDescription& description);
+
+            size_t getPipelineCount() const {
+                return _entries.size();
+            }
+
+            static constexpr size_t DEFAULT_COMPILE_THREADS = 2;   // Workers of the owned pool, leaving the other cores to the frame
+
+        private:
+            /**
+             * @brief The fields of a PipelineDescription, flattened into words that compare and hash exactly.
+             */
+            using PipelineKey = std::vector<uint32_t>;
+
+            /**
+             * @struct PipelineKeyHash
+             * @brief Hash functor of PipelineKey.
+             */
+            struct PipelineKeyHash {
+                size_t operator()(const PipelineKey& key) const;
+            };
+
+            /**
+             * @struct Entry
+             * @brief A cached pipeline and its compilation.
+             */
+            struct Entry {
+                PipelineStatus _status = PipelineStatus::MISSING;
+                std::future<VkPipeline> _compilation;           // Result of the worker, valid while compiling
+                VkPipeline _pipeline = VK_NULL_HANDLE;          // The pipeline, once ready
+            };
+
+            /**
+             * @brief Builds the key of a pipeline description.
+             */
+            static PipelineKey makeKey(const PipelineDescription& description);
+
+            /**
+             * @brief Compiles a pipeline, callable from any thread.
+             *
+             * @throws std::runtime_error If the shaders cannot be read or the compilation fails.
+             */
+            static VkPipeline compile(VkDevice logicalDevice, VkPipelineCache pipelineCache, const PipelineDescription& description);
+
+            /**
+             * @brief Collects the result of the compilation of an entry, if the worker finished it.
+             *
+             * @param entry The entry to update.
+             * @param wait Whether to wait for the worker.
+             */
+            void poll(Entry& entry, bool wait);
+
+            PipelineStateCacheCreationProperties _properties;                   // Vulkan objects and settings
+            std::unique_ptr<ThreadPool> _ownedThreadPool;                       // Pool started when none was given
+            std::unordered_map<PipelineKey, Entry, PipelineKeyHash> _entries;   // Pipelines mapped by their description
+    };
+}
@@ -0,0 +1,246 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** ResourceStateTracker
+*/
+
+#pragma once
+
+#include <map>
+#include <vector>
+#include <stdexcept>
+
+#include <vulkan/vulkan.h>
+
+namespace maverik {
+    /**
+     * @class ResourceStateTracker
+     * @brief Tracks the layout, access and stage of images and buffers and emits minimal barriers.
+     *
+     * Each tracked image (per mip level) and buffer remembers its current layout,
+     * the stages and accesses of its last write, and the stages and accesses that
+     * have already been made visible since that write. Requesting a new usage only
+     * queues a barrier when there is an actual hazard (write after anything, read
+     * after write not yet visible, or a layout change), and every queued barrier is
+     * merged into a single `vkCmdPipelineBarrier2` when the batch is flushed.
+     *
+     * When synchronization2 is not enabled on the device, the batch is emitted with
+     * a single legacy `vkCmdPipelineBarrier` call instead.
+     *
+     * @note Resources must be required in submission order, as the tracker has no
+     * knowledge of how command buffers are submitted.
+     */
+    class ResourceStateTracker {
+        public:
+            /**
+             * @enum Usage
+             * @brief The ways a resource can be accessed by the GPU or the host.
+             */
+            enum class Usage {
+                UNDEFINED,                  ///> Content is discarded
+                TRANSFER_SRC,               ///> Source of a copy or blit
+                TRANSFER_DST,               ///> Destination of a copy, blit or clear
+                VERTEX_BUFFER,              ///> Bound as a vertex buffer
+                INDEX_BUFFER,               ///> Bound as an index buffer
+                INDIRECT_BUFFER,            ///> Source of indirect draw or dispatch parameters
+                UNIFORM_BUFFER,             ///> Read as a uniform buffer by graphics shaders
+                VERTEX_SHADER_READ,         ///> Sampled or read by the vertex shader
+                FRAGMENT_SHADER_READ,       ///> Sampled or read by the fragment shader
+                COMPUTE_SHADER_READ,        ///> Sampled or read by a compute shader
+                COMPUTE_SHADER_WRITE,       ///> Read and written as storage by a compute shader
+                COLOR_ATTACHMENT,           ///> Rendered to as a color attachment
+                DEPTH_STENCIL_ATTACHMENT,   ///> Rendered to as a depth/stencil attachment
+                DEPTH_STENCIL_READ,         ///> Read-only depth/stencil, also sampled by the fragment shader
+                PRESENT,                    ///> Handed to the presentation engine
+                HOST_READ,                  ///> Read back by the host
+                HOST_WRITE                  ///> Written by the host
+            };
+
+            /**
+             * @struct ResourceState
+             * @brief Stages, accesses and layout describing one access to a resource.
+             */
+            struct ResourceState {
+                VkPipelineStageFlags2 _stages = VK_PIPELINE_STAGE_2_NONE;   // Pipeline stages of the access
+                VkAccessFlags2 _access = VK_ACCESS_2_NONE;                  // Memory accesses performed
+                VkImageLayout _layout = VK_IMAGE_LAYOUT_UNDEFINED;          // Image layout required (ignored for buffers)
+            };
+
+            /**
+             * @brief Constructs a ResourceStateTracker.
+             *
+             * @param logicalDevice The Vulkan logical device, used to load `vkCmdPipelineBarrier2`.
+             * @param synchronization2 Whether the synchronization2 feature is enabled on the device.
+             */
+            ResourceStateTracker(VkDevice logicalDevice, bool synchronization2);
+
+            ~ResourceStateTracker() = default;
+
+            /**
+             * @brief Returns the stages, accesses and layout corresponding to a usage.
+             *
+             * @param usage The usage to translate.
+             * @return ResourceState The state a resource must be in for that usage.
+             */
+            static ResourceState getUsageState(Usage usage);
+
+            /**
+             * @brief Returns the stages and accesses that typically go with an image layout.
+             *
+             * This is used where only layouts are known (e.g. legacy layout transitions).
+             * Unknown layouts fall back to a conservative all-commands dependency.
+             *
+             * @param layout The image layout.
+             * @return ResourceState The state associated with the layout.
+             */
+            static ResourceState getLayoutState(VkImageLayout layout);
+
+            /**
+             * @brief Starts tracking an image.
+             *
+             * The image is assumed to have last been accessed the way its initial
+             * layout implies (e.g. a transfer write for TRANSFER_DST_OPTIMAL).
+             * Registering an image that is already tracked replaces its state, which
+             * is how transitions made outside the tracker (e.g. on the host) are recorded.
+             *
+             * @param image The image to track.
+             * @param aspectMask The aspects used by the barriers of the image.
+             * @param mipLevels The number of mip levels of the image.
+             * @param arrayLayers The number of array layers of the image.
+             * @param initialLayout The layout the image is currently in.
+             */
+            void registerImage(VkImage image, VkImageAspectFlags aspectMask, uint32_t mipLevels, uint32_t arrayLayers = 1, VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED);
+
+            /**
+             * @brief Starts tracking a buffer.
+             *
+             * @param buffer The buffer to track.
+             */
+            void registerBuffer(VkBuffer buffer);
+
+            /**
+             * @brief Get whether an image is tracked.
+             *
+             * @param image The image.
+             * @return true if the image has been registered and not forgotten, false otherwise.
+             */
+            bool isTracked(VkImage image) const;
+
+            /**
+             * @brief Stops tracking an image, typically right before it is destroyed.
+             *
+             * @param image The image to forget.
+             */
+            void forget(VkImage image);
+
+            /**
+             * @brief Stops tracking a buffer, typically right before it is destroyed.
+             *
+             * @param buffer The buffer to forget.
+             */
+            void forget(VkBuffer buffer);
+
+            /**
+             * @brief Requests a usage for a range of mip levels of an image.
+             *
+             * A barrier is queued only if the usage conflicts with the current state.
+             *
+             * @param image The tracked image.
+             * @param usage The usage about to happen.
+             * @param baseMipLevel The first mip level concerned.
+             * @param levelCount The number of mip levels concerned, or VK_REMAINING_MIP_LEVELS.
+             *
+             * @throws std::runtime_error If the image is not tracked.
+             * @throws std::out_of_range If the range is empty or goes past the mip levels of the image.
+             * @throws std::logic_error If a level already has a barrier pending in the current batch.
+             */
+            void require(VkImage image, Usage usage, uint32_t baseMipLevel = 0, uint32_t levelCount = VK_REMAINING_MIP_LEVELS);
+
+            /**
+             * @brief Requests an arbitrary state for a range of mip levels of an image.
+             *
+             * @see require(VkImage, Usage, uint32_t, uint32_t)
+             */
+            void require(VkImage image, const ResourceState& state, uint32_t baseMipLevel = 0, uint32_t levelCount = VK_REMAINING_MIP_LEVELS);
+
+            /**
+             * @brief Requests a usage for a whole buffer.
+             *
+             * @param buffer The tracked buffer.
+             * @param usage The usage about to happen.
+             *
+             * @throws std::runtime_error If the buffer is not tracked.
+             * @throws std::logic_error If the buffer already has a barrier pending in the current batch.
+             */
+            void require(VkBuffer buffer, Usage usage);
+
+            /**
+             * @brief Emits every queued barrier with a single pipeline barrier command.
+             *
+             * Does nothing when no barrier is pending.
+             *
+             * @param commandBuffer The command buffer being recorded.
+             */
+            void flush(VkCommandBuffer commandBuffer);
+
+            /**
+             * @brief Get the layout a mip level of an image is currently in.
+             *
+             * @param image The tracked image.
+             * @param mipLevel The mip level.
+             * @return VkImageLayout The current layout, including transitions still pending.
+             */
+            VkImageLayout getLayout(VkImage image, uint32_t mipLevel = 0) const;
+
+        private:
+            /**
+             * @struct TrackedState
+             * @brief Hazard tracking information of one subresource.
+             */
+            struct TrackedState {
+                VkImageLayout _layout = VK_IMAGE_LAYOUT_UNDEFINED;              // Current layout
+                VkPipelineStageFlags2 _writeStages = VK_PIPELINE_STAGE_2_NONE;  // Stages of the last write or transition
+                VkAccessFlags2 _writeAccess = VK_ACCESS_2_NONE;                 // Accesses of the last write
+                VkPipelineStageFlags2 _readStages = VK_PIPELINE_STAGE_2_NONE;   // Stages that accessed it since the last write
+                VkAccessFlags2 _readAccess = VK_ACCESS_2_NONE;                  // Accesses already made visible since the last write
+                bool _pending = false;                                          // Whether a barrier is queued in the current batch
+
+                bool operator==(const TrackedState& other) const {
+                    return _layout == other._layout && _writeStages == other._writeStages && _writeAccess == other._writeAccess
+                        && _readStages == other._readStages && _readAccess == other._readAccess && _pending == other._pending;
+                }
+            };
+
+            /**
+             * @struct TrackedImage
+             * @brief Tracking information of an image, one state per mip level.
+             */
+            struct TrackedImage {
+                VkImageAspectFlags _aspectMask;         // Aspects of the barriers
+                uint32_t _arrayLayers;                  // Number of array layers
+                std::vector<TrackedState> _levels;      // State of each mip level
+            };
+
+            /**
+             * @brief Computes the barrier needed to move a subresource to a new state.
+             *
+             * @param state The tracked state, updated to reflect the new usage.
+             * @param next The state requested.
+             * @param isImage Whether the subresource belongs to an image (layouts are ignored for buffers).
+             * @param srcStages Filled with the source stages of the barrier.
+             * @param srcAccess Filled with the source accesses of the barrier.
+             * @return true if a barrier is required, false otherwise.
+             */
+            static bool transition(TrackedState& state, const ResourceState& next, bool isImage, VkPipelineStageFlags2& srcStages, VkAccessFlags2& srcAccess);
+
+            VkDevice _logicalDevice;                                // Logical device the resources belong to
+            PFN_vkCmdPipelineBarrier2 _cmdPipelineBarrier2 = nullptr;   // Synchronization2 barrier entry point, if enabled
+
+            std::map<VkImage, TrackedImage> _images;                // Tracked images
+            std::map<VkBuffer, TrackedState> _buffers;              // Tracked buffers
+
+            std::vector<VkImageMemoryBarrier2> _imageBarriers;      // Image barriers of the current batch
+            std::vector<VkBufferMemoryBarrier2> _bufferBarriers;    // Buffer barriers of the current batch
+    };
+}
@@ -0,0 +1,121 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** SamplerCache
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <vulkan/vulkan.h>
+
+namespace maverik {
+    /**
+     * @class SamplerCache
+     * @brief Deduplicates samplers by their creation state.
+     *
+     * Textures sampled the same way share a single `VkSampler`, so the number of samplers
+     * depends on the number of distinct sampler states instead of the number of textures,
+     * keeping scenes far below `maxSamplerAllocationCount`. Samplers are reference-counted:
+     * each acquire() must be matched by a release(), and a sampler is destroyed when its last
+     * user releases it.
+     *
+     * @note This class is not thread-safe.
+     */
+    class SamplerCache {
+        public:
+            /**
+             * @brief Constructs an empty cache.
+             *
+             * @param logicalDevice The Vulkan logical device the samplers are created on.
+             */
+            SamplerCache(VkDevice logicalDevice);
+
+            /**
+             * @brief Destroys every sampler still in the cache.
+             */
+            ~SamplerCache();
+
+            SamplerCache(const SamplerCache& other) = delete;
+            SamplerCache& operator=(const SamplerCache& other) = delete;
+
+            /**
+             * @brief Get the sampler matching a creation state, creating it on first use.
+             *
+             * @param samplerInfo The creation state of the sampler, without extension structures.
+             * @return VkSampler The shared sampler, to be released with release().
+             *
+             * @throws std::runtime_error If the state has a pNext chain or the sampler creation fails.
+             */
+            VkSampler acquire(const VkSamplerCreateInfo& samplerInfo);
+
+            /**
+             * @brief Drops a reference to a sampler, destroying it when it was the last one.
+             *
+             * @param sampler A sampler returned by acquire().
+             */
+            void release(VkSampler sampler);
+
+            size_t getSamplerCount() const {
+                return _entries.size();
+            }
+
+        private:
+            /**
+             * @struct SamplerKey
+             * @brief The fields of a VkSamplerCreateInfo that define a sampler state.
+             *
+             * Floats are stored as their bit patterns, so that keys compare and hash exactly.
+             */
+            struct SamplerKey {
+                VkSamplerCreateFlags _flags;
+                VkFilter _magFilter;
+                VkFilter _minFilter;
+                VkSamplerMipmapMode _mipmapMode;
+                VkSamplerAddressMode _addressModeU;
+                VkSamplerAddressMode _addressModeV;
+                VkSamplerAddressMode _addressModeW;
+                uint32_t _mipLodBias;
+                VkBool32 _anisotropyEnable;
+                uint32_t _maxAnisotropy;
+                VkBool32 _compareEnable;
+                VkCompareOp _compareOp;
+                uint32_t _minLod;
+                uint32_t _maxLod;
+                VkBorderColor _borderColor;
+                VkBool32 _unnormalizedCoordinates;
+
+                bool operator==(const SamplerKey& other) const = default;
+            };
+
+            /**
+             * @struct SamplerKeyHash
+             * @brief Hash functor of SamplerKey.
+             */
+            struct SamplerKeyHash {
+                size_t operator()(const SamplerKey& key) const;
+            };
+
+            /**
+             * @struct Entry
+             * @brief A cached sampler and the number of its users.
+             */
+            struct Entry {
+                VkSampler _sampler;     // The shared sampler
+                uint32_t _refCount;     // Number of acquire() not released yet
+            };
+
+            /**
+             * @brief Builds the key of a sampler creation state.
+             */
+            static SamplerKey makeKey(const VkSamplerCreateInfo& samplerInfo);
+
+            VkDevice _logicalDevice;                                        // Logical device owning the samplers
+            std::unordered_map<SamplerKey, Entry, SamplerKeyHash> _entries; // Samplers mapped by their state
+            std::unordered_map<VkSampler, SamplerKey> _keys;                // States mapped by their sampler
+    };
+}
@@ -0,0 +1,122 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** TextureFormat
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <vulkan/vulkan.h>
+
+namespace maverik {
+    /**
+     * @class TextureFormat
+     * @brief Picks the Vulkan format of a decoded texture and converts its pixels to it.
+     *
+     * The format depends on the number of channels of the source image and on what
+     * the texture is used for, so that masks take one channel and normal maps two
+     * instead of always expanding to RGBA. Single and two-channel color textures are
+     * sampled through a swizzled view so shaders still read grey and alpha as RGBA.
+     *
+     * Conversions from RGB to RGBA and from floats to half floats are vectorized with
+     * SSSE3/F16C or NEON when available, with a scalar fallback otherwise.
+     */
+    class TextureFormat {
+        public:
+            /**
+             * @enum Usage
+             * @brief What the texels of a texture represent.
+             */
+            enum class Usage {
+                COLOR,      ///> sRGB-encoded color, filtered in linear space
+                DATA,       ///> Linear data (roughness, metalness, heights...), stored as-is
+                NORMAL,     ///> Tangent-space normal map, X and Y only, Z is reconstructed by shaders
+                MASK        ///> Single-channel mask, taken from the first channel of the source
+            };
+
+            /**
+             * @enum Precision
+             * @brief The storage precision of each channel.
+             */
+            enum class Precision {
+                UNORM8,     ///> 8-bit normalized integers
+                UNORM16,    ///> 16-bit normalized integers
+                FLOAT       ///> 16-bit floats
+            };
+
+            /**
+             * @struct Selection
+             * @brief The format chosen for a texture and how to view it.
+             */
+            struct Selection {
+                VkFormat _format;               // Format of the image
+                Precision _precision;           // Precision of each channel
+                uint32_t _channels;             // Number of channels stored, 1, 2 or 4
+                VkComponentMapping _swizzle;    // Component mapping of the sampled view
+
+                uint32_t getBytesPerPixel() const {
+                    return _channels * (_precision == Precision::UNORM8 ? 1 : 2);
+                }
+            };
+
+            /**
+             * @brief Selects the format of a texture.
+             *
+             * Color textures are stored as sRGB 8-bit unless the source holds floats, as
+             * 16-bit sources gain nothing in sRGB space. Three-channel sources are stored with
+             * four channels since RGB formats are rarely supported with optimal tiling.
+             *
+             * @param sourceChannels The number of channels of the source image, from 1 to 4.
+             * @param usage What the texture is used for.
+             * @param sourcePrecision The precision of the source image.
+             * @return Selection The format, its precision and channel count, and the view swizzle.
+             */
+            static Selection select(uint32_t sourceChannels, Usage usage, Precision sourcePrecision);
+
+            /**
+             * @brief Get the four-channel selection of the same precision, for devices lacking a smaller format.
+             *
+             * @param selection A selection returned by select().
+             * @return Selection The selection widened to four channels, viewed the same way by shaders.
+             */
+            static Selection widen(const Selection& selection);
+
+            /**
+             * @brief Converts decoded pixels to the layout of a selection.
+             *
+             * The source holds 8-bit integers, 16-bit integers or 32-bit floats depending on the
+             * precision of the selection. Missing color channels replicate grey sources, missing
+             * alpha is opaque and extra channels are dropped.
+             *
+             * @param source The decoded pixels, tightly packed.
+             * @param sourceChannels The number of channels of the decoded pixels.
+             * @param selection The selection to convert to.
+             * @param pixelCount The number of pixels.
+             * @param destination The converted pixels, `pixelCount * selection.getBytesPerPixel()` bytes.
+             */
+            static void convert(const void *source, uint32_t sourceChannels, const Selection& selection, size_t pixelCount, void *destination);
+
+            /**
+             * @brief Expands RGB8 pixels to RGBA8.
+             *
+             * @param source The RGB pixels, `pixelCount * 3` bytes.
+             * @param destination The RGBA pixels, `pixelCount * 4` bytes.
+             * @param pixelCount The number of pixels.
+             * @param alpha The alpha written to every pixel.
+             */
+            static void expandRgbToRgba(const uint8_t *source, uint8_t *destination, size_t pixelCount, uint8_t alpha = 0xFF);
+
+            /**
+             * @brief Converts floats to IEEE half floats, rounding to nearest even.
+             *
+             * @param source The floats.
+             * @param destination The half floats, as their bit patterns.
+             * @param count The number of values.
+             */
+            static void floatToHalf(const float *source, uint16_t *destination, size_t count);
+    };
+}
@@ -0,0 +1,161 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** TextureRegistry
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <vulkan/vulkan.h>
+
+namespace maverik {
+    /**
+     * @struct TextureHandle
+     * @brief Generational reference to a texture of a TextureRegistry.
+     *
+     * The index selects a slot of the registry and the generation tells which texture
+     * of that slot the handle was given for, so a handle to a removed texture never
+     * resolves to the texture that reuses its slot.
+     */
+    struct TextureHandle {
+        static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+        uint32_t _index = INVALID_INDEX;    // Slot of the texture in the registry
+        uint32_t _generation = 0;           // Generation of the slot when the handle was given
+
+        bool isValid() const {
+            return _index != INVALID_INDEX;
+        }
+
+        bool operator==(const TextureHandle& other) const = default;
+    };
+
+    /**
+     * @struct Texture
+     * @brief A texture image and its metadata.
+     */
+    struct Texture {
+        std::string _name;                              // Name of the texture, usually its path
+        VkImage _image = VK_NULL_HANDLE;                // Texture image
+        VkDeviceMemory _memory = VK_NULL_HANDLE;        // Memory of the image
+        VkImageView _view = VK_NULL_HANDLE;             // Sampled view over every mip level
+        VkSampler _sampler = VK_NULL_HANDLE;            // Sampler of the texture
+        VkFormat _format = VK_FORMAT_UNDEFINED;         // Format of the image
+        uint32_t _width = 0;                            // Width of the base level in pixels
+        uint32_t _height = 0;                           // Height of the base level in pixels
+        uint32_t _mipLevels = 0;                        // Number of mip levels of the image
+        uint32_t _bindlessSlot = UINT32_MAX;            // Slot in the bindless texture table, if registered
+        VkComponentMapping _swizzle = {};               // Component mapping of the sampled view
+    };
+
+    /**
+     * @class TextureRegistry
+     * @brief Stores textures in a dense array referenced by generational handles.
+     *
+     * Handles resolve in constant time through a slot table, and textures are kept
+     * packed in one array whatever the order they are added and removed in, so that
+     * iterating over them walks contiguous memory. Names are only hashed when looking
+     * a texture up by name, never when resolving a handle.
+     *
+     * The registry only stores textures: the Vulkan objects of a removed texture are
+     * returned to the caller, which destroys them.
+     *
+     * @note This class is not thread-safe.
+     */
+    class TextureRegistry {
+        public:
+            TextureRegistry() = default;
+            ~TextureRegistry() = default;
+
+            /**
+             * @brief Adds a texture to the registry.
+             *
+             * @param texture The texture, whose name must not be registered yet.
+             * @return TextureHandle The handle of the texture.
+             *
+             * @throws std::runtime_error If a texture with the same name is already registered.
+             */
+            TextureHandle add(const Texture& texture);
+
+            /**
+             * @brief Removes a texture from the registry, invalidating its handle.
+             *
+             * The last texture of the dense array moves to the removed one's place.
+             *
+             * @param handle The handle of the texture.
+             * @return Texture The removed texture, whose Vulkan objects the caller destroys.
+             *
+             * @throws std::runtime_error If the handle does not refer to a registered texture.
+             */
+            Texture remove(TextureHandle handle);
+
+            /**
+             * @brief Checks whether a handle refers to a registered texture.
+             */
+            bool contains(TextureHandle handle) const;
+
+            /**
+             * @brief Get the texture a handle refers to.
+             *
+             * The reference is invalidated by the next add() or remove().
+             *
+             * @throws std::runtime_error If the handle does not refer to a registered texture.
+             */
+            Texture& get(TextureHandle handle);
+            const Texture& get(TextureHandle handle) const;
+
+            /**
+             * @brief Get the handle of a texture by its name.
+             *
+             * @return TextureHandle The handle, invalid if no texture has that name.
+             */
+            TextureHandle find(const std::string& name) const;
+
+            /**
+             * @brief Get the handle of the texture at a position of the dense array.
+             */
+            TextureHandle getHandle(size_t denseIndex) const;
+
+            std::vector<Texture>& getTextures() {
+                return _textures;
+            }
+
+            const std::vector<Texture>& getTextures() const {
+                return _textures;
+            }
+
+            size_t size() const {
+                return _textures.size();
+            }
+
+        private:
+            /**
+             * @struct Slot
+             * @brief Entry of the slot table, pointing into the dense array.
+             */
+            struct Slot {
+                uint32_t _denseIndex;   // Position of the texture in the dense array, INVALID_INDEX if free
+                uint32_t _generation;   // Incremented each time the slot is freed
+            };
+
+            /**
+             * @brief Get the position in the dense array of the texture a handle refers to.
+             *
+             * @throws std::runtime_error If the handle does not refer to a registered texture.
+             */
+            uint32_t resolve(TextureHandle handle) const;
+
+            std::vector<Texture> _textures;                             // Textures, packed
+            std::vector<uint32_t> _denseToSlot;                         // Slot of each texture of the dense array
+            std::vector<Slot> _slots;                                   // Slot table indexed by handles
+            std::vector<uint32_t> _freeSlots;                           // Slots available for new textures
+            std::unordered_map<std::string, uint32_t> _slotsByName;     // Slots mapped by texture names
+    };
+}
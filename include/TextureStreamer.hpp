@@ -0,0 +1,282 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** TextureStreamer
+*/
+
+#pragma once
+
+#include <map>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include <optional>
+
+#include "Utils.hpp"
+#include "KtxTexture.hpp"
+#include "CookedTexture.hpp"
+
+namespace maverik {
+    /**
+     * @class TextureStreamer
+     * @brief Streams the mip levels of textures in and out of VRAM under a memory budget.
+     *
+     * Each texture keeps a resident window of its mip chain, from a "resident level" down
+     * to the smallest level. The smallest levels (the tail) are uploaded as soon as the
+     * texture is added, so it can be sampled right away. More detailed levels are streamed
+     * in when they are requested, either from sampled-LOD feedback or from a distance
+     * heuristic, and the least recently requested textures are shrunk back to their tail
+     * when the budget is exceeded.
+     *
+     * Without sparse residency, the window is stored in an image holding exactly the
+     * resident levels. Growing or shrinking it creates a new image, uploads the window from
+     * the source file, and swaps it in once the upload has completed; the previous image is
+     * released once no frame in flight can use it anymore. Since level 0 of the image is
+     * the most detailed resident level, sampling is clamped to the resident window without
+     * any sampler or view `minLod`.
+     *
+     * Sources are `.mvktex` and `.ktx2` files, whose levels are already in their GPU format.
+     *
+     * @note update() must be called once per frame, from the thread submitting to the queue.
+     */
+    class TextureStreamer {
+        public:
+            /**
+             * @struct TextureStreamerProperties
+             * @brief Holds the Vulkan objects and settings used by the streamer.
+             */
+            struct TextureStreamerProperties {
+                /*
+                 * @brief The Vulkan physical device used for resource creation.
+                */
+                VkPhysicalDevice _physicalDevice;
+                /*
+                 * @brief The Vulkan logical device used for operations.
+                */
+                VkDevice _logicalDevice;
+                /*
+                 * @brief The Vulkan command pool the upload command buffers are allocated from, when no command allocator is given.
+                */
+                VkCommandPool _commandPool;
+                /*
+                 * @brief The Vulkan queue the uploads are submitted to.
+                */
+                VkQueue _graphicsQueue;
+                /*
+                 * @brief The maximum number of bytes the resident windows may use.
+                */
+                VkDeviceSize _budget;
+                /*
+                 * @brief Levels whose width and height are both at most this size are always resident.
+                */
+                uint32_t _tailSize = 64;
+                /*
+                 * @brief The number of frames that may still use an image after it has been replaced.
+                */
+                uint32_t _framesInFlight = 2;
+                /*
+                 * @brief The maximum number of stream-ins started by a single update.
+                */
+                uint32_t _maxUploadsPerUpdate = 2;
+                /*
+                 * @brief The tracker of the rendering context the upload barriers are recorded through, the streamer owns one when null.
+                */
+                ResourceStateTracker *_resourceStateTracker = nullptr;
+                /*
+                 * @brief The command allocator of the rendering context, whose one-shot command buffers record the uploads.
+                */
+                CommandAllocator *_commandAllocator = nullptr;
+            };
+
+            TextureStreamer(const TextureStreamerProperties& properties);
+
+            /**
+             * @brief Waits for the pending uploads and destroys every image.
+             *
+             * @note The device must not be using any of the streamed images anymore.
+             */
+            ~TextureStreamer();
+
+            TextureStreamer(const TextureStreamer& other) = delete;
+            TextureStreamer& operator=(const TextureStreamer& other) = delete;
+
+            /**
+             * @brief Opens a texture and uploads its tail, waiting for the upload to complete.
+             *
+             * @param name The name the texture is registered under.
+             * @param path The path to a `.mvktex` or `.ktx2` file.
+             *
+             * @throws std::runtime_error If the file cannot be loaded or its format cannot be sampled.
+             */
+            void addTexture(const std::string& name, const std::string& path);
+
+            /**
+             * @brief Stops streaming a texture and releases its images once they are no longer in use.
+             *
+             * @param name The name of the texture.
+             */
+            void removeTexture(const std::string& name);
+
+            /**
+             * @brief Requests a level to be resident, typically from sampled-LOD feedback.
+             *
+             * Requests are gathered until the next update, the most detailed one being kept.
+             *
+             * @param name The name of the texture.
+             * @param level The most detailed level the texture is sampled at.
+             */
+            void requestLevel(const std::string& name, uint32_t level);
+
+            /**
+             * @brief Requests the level matching the on-screen size of a textured object.
+             *
+             * @param name The name of the texture.
+             * @param distance The distance from the camera to the object.
+             * @param worldSize The size in world units the whole texture is mapped onto.
+             * @param fovY The vertical field of view of the camera, in radians.
+             * @param viewportHeight The height of the viewport in pixels.
+             */
+            void requestLevelForDistance(const std::string& name, float distance, float worldSize, float fovY, uint32_t viewportHeight);
+
+            /**
+             * @brief Advances streaming by one frame.
+             *
+             * Completed uploads are swapped in, images released long enough ago are destroyed,
+             * and new uploads are started for the requested levels, evicting the least recently
+             * requested textures when the budget would be exceeded.
+             *
+             * @return std::vector<std::string> The textures whose image view changed, so
+             * descriptors referencing them must be updated.
+             */
+            std::vector<std::string> update();
+
+            /**
+             * @brief Get the image view of the resident window of a texture.
+             *
+             * @param name The name of the texture.
+             * @return VkImageView The view, valid until update() reports the texture as changed.
+             */
+            VkImageView getImageView(const std::string& name) const;
+
+            /**
+             * @brief Get the most detailed resident level of a texture, in its full mip chain.
+             *
+             * @param name The name of the texture.
+             * @return uint32_t The index of the level stored as level 0 of the current image.
+             */
+            uint32_t getResidentLevel(const std::string& name) const;
+
+            /**
+             * @brief Get the number of bytes used by the resident windows and the ones being streamed in.
+             *
+             * @return VkDeviceSize The number of bytes accounted against the budget.
+             */
+            VkDeviceSize getCommittedBytes() const {
+                return _committedBytes;
+            }
+
+        private:
+            /**
+             * @struct Allocation
+             * @brief An image holding a window of a mip chain.
+             */
+            struct Allocation {
+                VkImage _image = VK_NULL_HANDLE;            // Image holding the window
+                VkDeviceMemory _memory = VK_NULL_HANDLE;    // Memory bound to the image
+                VkImageView _view = VK_NULL_HANDLE;         // View over every level of the image
+            };
+
+            /**
+             * @struct Upload
+             * @brief A window upload submitted to the queue and not completed yet.
+             */
+            struct Upload {
+                VkFence _fence;                         // Signaled once the upload has executed
+                VkCommandBuffer _commandBuffer;         // Command buffer recording the upload
+                VkBuffer _stagingBuffer;                // Staging buffer holding the levels
+                VkDeviceMemory _stagingBufferMemory;    // Memory of the staging buffer
+                Allocation _allocation;                 // Image receiving the window
+                uint32_t _baseLevel;                    // Most detailed level of the window
+            };
+
+            /**
+             * @struct StreamedTexture
+             * @brief Streaming state of a texture.
+             */
+            struct StreamedTexture {
+                std::unique_ptr<CookedTexture> _cooked; // Source of a cooked texture
+                std::unique_ptr<KtxTexture> _ktx;       // Source of a KTX2 texture
+                VkFormat _format;                       // Format of the levels
+                uint32_t _levelCount;                   // Number of levels of the full chain
+                uint32_t _tailLevel;                    // Most detailed level that is always resident
+                Allocation _allocation;                 // Image holding the resident window
+                uint32_t _residentLevel;                // Most detailed resident level
+                uint32_t _targetLevel;                  // Most detailed level once the pending upload completes
+                std::optional<Upload> _upload;          // Pending upload, if any
+                uint32_t _requestedLevel;               // Most detailed level requested since the last update
+                uint64_t _lastRequestFrame = 0;         // Last frame the texture was requested in
+            };
+
+            /**
+             * @struct RetiredAllocation
+             * @brief A replaced image waiting for the frames in flight to stop using it.
+             */
+            struct RetiredAllocation {
+                Allocation _allocation;     // The replaced image
+                uint64_t _releaseFrame;     // Frame from which the image can be destroyed
+            };
+
+            /**
+             * @brief Get the data, size and extent of a level of the source of a texture.
+             */
+            static const char *getLevel(const StreamedTexture& texture, uint32_t level, VkDeviceSize& size, VkExtent3D& extent);
+
+            /**
+             * @brief Get the number of bytes used by the levels of a window.
+             */
+            static VkDeviceSize getWindowBytes(const StreamedTexture& texture, uint32_t baseLevel);
+
+            /**
+             * @brief Get a command buffer for an upload, from the command allocator or the command pool.
+             *
+             * @throws std::runtime_error If the command buffer allocation fails.
+             */
+            VkCommandBuffer allocateCommandBuffer();
+
+            /**
+             * @brief Gives back a command buffer returned by allocateCommandBuffer().
+             */
+            void releaseCommandBuffer(VkCommandBuffer commandBuffer);
+
+            /**
+             * @brief Creates the image of a window and submits the upload of its levels.
+             */
+            void beginUpload(StreamedTexture& texture, uint32_t baseLevel);
+
+            /**
+             * @brief Swaps in the image of a completed upload and releases its staging resources.
+             */
+            void completeUpload(StreamedTexture& texture);
+
+            /**
+             * @brief Shrinks the least recently requested textures until the given bytes fit the budget.
+             *
+             * @return true if enough bytes could be freed, false otherwise.
+             */
+            bool makeRoom(VkDeviceSize bytes, const StreamedTexture *requester);
+
+            /**
+             * @brief Destroys the retired images whose release frame has been reached.
+             */
+            void releaseRetired(bool all);
+
+            TextureStreamerProperties _properties;              // Vulkan objects and settings
+            std::unique_ptr<ResourceStateTracker> _ownedResourceStateTracker;  // Tracker used when the properties give none
+            std::map<std::string, StreamedTexture> _textures;   // Streamed textures mapped by their names
+            std::deque<RetiredAllocation> _retired;             // Replaced images, in release order
+            VkDeviceSize _committedBytes = 0;                   // Bytes of every target window
+            uint64_t _frame = 0;                                // Number of updates so far
+    };
+}
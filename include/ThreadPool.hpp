@@ -0,0 +1,84 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** ThreadPool
+*/
+
+#pragma once
+
+#include <deque>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <type_traits>
+#include <condition_variable>
+
+namespace maverik {
+    /**
+     * @class ThreadPool
+     * @brief Fixed-size pool of worker threads consuming a FIFO task queue.
+     *
+     * Tasks are arbitrary callables, their result (or exception) is delivered
+     * through the std::future returned by submit().
+     *
+     * @note Tasks must not touch Vulkan objects that require external
+     * synchronization (queues, command pools) without their own locking.
+     */
+    class ThreadPool {
+        public:
+            /**
+             * @brief Starts the worker threads.
+             *
+             * @param threadCount The number of workers, defaults to the number of hardware threads.
+             */
+            ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
+
+            /**
+             * @brief Finishes every queued task, then joins the worker threads.
+             */
+            ~ThreadPool();
+
+            ThreadPool(const ThreadPool& other) = delete;
+            ThreadPool& operator=(const ThreadPool& other) = delete;
+
+            /**
+             * @brief Queues a task for execution on a worker thread.
+             *
+             * @param task The callable to run, taking no argument.
+             * @return std::future The future receiving the result of the task.
+             */
+            template <typename Task>
+            auto submit(Task&& task) -> std::future<std::invoke_result_t<Task>>
+            {
+                using Result = std::invoke_result_t<Task>;
+
+                auto packagedTask = std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+                std::future<Result> future = packagedTask->get_future();
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _tasks.emplace_back([packagedTask] { (*packagedTask)(); });
+                }
+                _condition.notify_one();
+                return future;
+            }
+
+            size_t getThreadCount() const {
+                return _workers.size();
+            }
+
+        private:
+            /**
+             * @brief Main loop of a worker: pops and runs tasks until the pool stops.
+             */
+            void workerLoop();
+
+            std::vector<std::thread> _workers;              // Worker threads
+            std::deque<std::function<void()>> _tasks;       // Tasks waiting for a worker
+            std::mutex _mutex;                              // Protects the task queue and the stop flag
+            std::condition_variable _condition;             // Signaled when a task is queued or the pool stops
+            bool _stopping = false;                         // Whether the pool is being destroyed
+    };
+}
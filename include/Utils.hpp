@@ -16,6 +16,9 @@
 
 #include <vulkan/vulkan.h>
 
+#include "CommandAllocator.hpp"
+#include "ResourceStateTracker.hpp"
+
 namespace maverik {
     class Utils {
         public:
@@ -85,6 +88,67 @@ namespace maverik {
                 }
             };
 
+            /**
+             * @brief Optional device features detected and enabled at device creation.
+             *
+             * Code paths relying on one of these features must check it and keep a
+             * fallback, as older drivers may not expose them.
+             *
+             * @struct DeviceCapabilities
+             */
+            struct DeviceCapabilities {
+                /*
+                * @brief The Vulkan version supported by the physical device.
+                */
+                uint32_t _apiVersion = VK_API_VERSION_1_0;
+
+                /*
+                * @brief Whether synchronization2 (`vkCmdPipelineBarrier2`) is available.
+                */
+                bool _synchronization2 = false;
+
+                /*
+                * @brief Whether BC1-7 compressed formats can be sampled.
+                */
+                bool _textureCompressionBC = false;
+
+                /*
+                * @brief Whether ETC2 and EAC compressed formats can be sampled.
+                */
+                bool _textureCompressionETC2 = false;
+
+                /*
+                * @brief Whether ASTC LDR compressed formats can be sampled.
+                */
+                bool _textureCompressionASTC = false;
+
+                /*
+                * @brief Whether bindless sampled image arrays are available through descriptor
+                * indexing: runtime-sized, partially bound, update-after-bind and non-uniformly indexed.
+                */
+                bool _descriptorIndexing = false;
+
+                /*
+                * @brief The maximum number of combined image samplers of an update-after-bind descriptor set.
+                */
+                uint32_t _maxBindlessTextures = 0;
+
+                /*
+                * @brief Whether images can be copied to from host memory (VK_EXT_host_image_copy).
+                */
+                bool _hostImageCopy = false;
+
+                /*
+                * @brief Whether indirect draws can start at a non-zero instance and be issued several at once.
+                */
+                bool _multiDrawIndirect = false;
+
+                /*
+                * @brief Whether indirect draws can read their count from a buffer (VK_KHR_draw_indirect_count).
+                */
+                bool _drawIndirectCount = false;
+            };
+
             static std::vector<char> readFile(const std::string& filename);
 
             static SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device, VkSurfaceKHR surface);
@@ -93,6 +157,7 @@ namespace maverik {
             static QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device);
 
             static uint32_t findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties);
+            static bool findDirectWriteMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkDeviceSize size, uint32_t& memoryTypeIndex);
             static VkFormat findDepthFormat(VkPhysicalDevice physicalDevice);
 
             /**
@@ -153,6 +218,10 @@ namespace maverik {
                     * @brief A reference to the VkDeviceMemory object that will be allocated for the image.
                 */
                 VkDeviceMemory& _imageMemory;
+                /*
+                    * @brief The creation flags for the image (e.g., VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT).
+                */
+                VkImageCreateFlags _flags = 0;
             };
 
             static void createImage(const CreateImageProperties& properties);
@@ -188,7 +257,7 @@ namespace maverik {
                 */
                 VkFormat _format;
                 /*
-                    * @brief The old layout of the image before the transition.
+                    * @brief The old layout of the image before the transition, ignored when the image is already tracked by _resourceStateTracker.
                 */
                 VkImageLayout _oldLayout;
                 /*
@@ -199,10 +268,24 @@ namespace maverik {
                     * @brief The number of mipmap levels in the image.
                 */
                 uint32_t _mipLevels;
+                /*
+                    * @brief Optional frame-scoped allocator used instead of allocating from the command pool.
+                */
+                CommandAllocator *_commandAllocator = nullptr;
+                /*
+                    * @brief Optional tracker holding the state of the image, the image is registered in it with _oldLayout when not tracked yet.
+                */
+                ResourceStateTracker *_resourceStateTracker = nullptr;
             };
 
             static void transitionImageLayout(const TransitionImageLayoutProperties& properties);
 
+            static VkImageAspectFlags getImageAspectMask(VkFormat format);
+
+            static DeviceCapabilities queryDeviceCapabilities(VkPhysicalDevice physicalDevice);
+            static bool isFormatSampleable(VkPhysicalDevice physicalDevice, VkFormat format);
+            static bool isDeviceExtensionSupported(VkPhysicalDevice device, const char *extensionName);
+
             static bool isDeviceSuitable(VkPhysicalDevice device, VkSurfaceKHR surface, std::vector<const char*> deviceExtensions);
 
             /**
@@ -282,6 +365,14 @@ namespace maverik {
                     * @brief The layout of the image before the copy operation.
                 */
                 uint32_t _height;
+                /*
+                    * @brief Optional frame-scoped allocator used instead of allocating from the command pool.
+                */
+                CommandAllocator *_commandAllocator = nullptr;
+                /*
+                    * @brief Optional copy regions, e.g. one per mip level. The base level is copied when empty.
+                */
+                std::vector<VkBufferImageCopy> _regions = {};
             };
 
             static void copyBufferToImage(const CopyBufferToImageProperties& properties);
@@ -331,9 +422,14 @@ namespace maverik {
                     * @brief The number of mipmap levels to generate.
                 */
                 uint32_t _mipLevels;
+                /*
+                    * @brief Optional frame-scoped allocator used instead of allocating from the command pool.
+                */
+                CommandAllocator *_commandAllocator = nullptr;
             };
 
             static void generateMipmaps(const GenerateMipmapsProperties& properties);
+            static void recordGenerateMipmaps(VkCommandBuffer commandBuffer, const GenerateMipmapsProperties& properties);
 
             /**
              * @struct CopyBufferProperties
@@ -369,10 +465,70 @@ namespace maverik {
                     * @brief The size of the data to copy in bytes.
                 */
                 VkDeviceSize _size;
+                /*
+                    * @brief Optional frame-scoped allocator used instead of allocating from the command pool.
+                */
+                CommandAllocator *_commandAllocator = nullptr;
+                /*
+                    * @brief Optional copy regions, the first _size bytes are copied when empty.
+                */
+                std::vector<VkBufferCopy> _regions = {};
             };
 
             static void copyBuffer(const CopyBufferProperties& properties);
 
+            /**
+             * @brief Properties required to create a device-local buffer filled with host data.
+             *
+             * The buffer is written directly when it lands in device-local host-visible memory,
+             * through a staging buffer and a copy submitted to the graphics queue otherwise.
+             *
+             */
+            struct CreateDeviceLocalBufferProperties {
+                /*
+                    * @brief The Vulkan logical device used for buffer creation and memory allocation.
+                */
+                VkDevice _logicalDevice;
+                /*
+                    * @brief The Vulkan physical device used to determine memory properties.
+                */
+                VkPhysicalDevice _physicalDevice;
+                /*
+                    * @brief The Vulkan command pool used to allocate the copy command buffer.
+                */
+                VkCommandPool _commandPool;
+                /*
+                    * @brief The Vulkan graphics queue the copy is submitted to.
+                */
+                VkQueue _graphicsQueue;
+                /*
+                    * @brief The data the buffer is filled with.
+                */
+                const void *_data;
+                /*
+                    * @brief The size of the data and of the buffer in bytes.
+                */
+                VkDeviceSize _size;
+                /*
+                    * @brief The usage flags for the buffer (e.g., VK_BUFFER_USAGE_VERTEX_BUFFER_BIT).
+                */
+                VkBufferUsageFlags _usage;
+                /*
+                    * @brief A reference to the VkBuffer object that will be created.
+                */
+                VkBuffer& _buffer;
+                /*
+                    * @brief A reference to the VkDeviceMemory object that will be allocated for the buffer.
+                */
+                VkDeviceMemory& _bufferMemory;
+                /*
+                    * @brief Optional frame-scoped allocator used instead of allocating from the command pool.
+                */
+                CommandAllocator *_commandAllocator = nullptr;
+            };
+
+            static void createDeviceLocalBuffer(const CreateDeviceLocalBufferProperties& properties);
+
             static VkSampleCountFlagBits getMaxUsableSampleCount(const VkPhysicalDevice& physicalDevice);
       
             static VkShaderModule createShaderModule(VkDevice logicalDevice, const std::vector<char>& code);
@@ -382,15 +538,22 @@ namespace maverik {
             static VkResult createDebugUtilsMessengerEXT(VkInstance instance, const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDebugUtilsMessengerEXT* pDebugMessenger);
 
             static VkFormat findSupportedDepthFormat(VkPhysicalDevice physicalDevice);
-            static VkImageView createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, VkDevice logicalDevice, uint32_t mipLevels);
+            /**
+             * @brief Creates a view over the mip levels of an image.
+             *
+             * @param usage When not 0, restricts the usages the view inherits from its image, which
+             * is required to view an image created with usages its view format does not support.
+             * @param components The component mapping of the view, identity by default.
+             */
+            static VkImageView createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, VkDevice logicalDevice, uint32_t mipLevels, VkImageUsageFlags usage = 0, VkComponentMapping components = {});
 
         private:
             static VkFormat findSupportedFormat(VkPhysicalDevice physicalDevice, const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
 
             static bool hasStencilComponent(VkFormat format);
 
-            static VkCommandBuffer beginSingleTimeCommands(VkDevice logicalDevice, VkCommandPool commandPool);
-            static void endSingleTimeCommands(VkDevice logicalDevice, VkCommandPool commandPool, VkQueue graphicsQueue, VkCommandBuffer commandBuffer);
+            static VkCommandBuffer beginSingleTimeCommands(VkDevice logicalDevice, VkCommandPool commandPool, CommandAllocator *commandAllocator = nullptr);
+            static void endSingleTimeCommands(VkDevice logicalDevice, VkCommandPool commandPool, VkQueue graphicsQueue, VkCommandBuffer commandBuffer, CommandAllocator *commandAllocator = nullptr);
 
             static bool checkDeviceExtensionSupport(VkPhysicalDevice device, std::vector<const char*> deviceExtensions);
 
@@ -9,6 +9,7 @@
 #define VERTEX_HPP_
 
 #include "maverik.hpp"
+#include "VertexLayout.hpp"
 
 namespace maverik {
     /**
@@ -24,6 +25,9 @@ namespace maverik {
         glm::vec3 color;        // Color of the vertex    (TODO: change to vec4 for alpha)
         glm::vec2 texCoord;     // Texture coordinates of the vertex
 
+        // Unquantized layout matching the members above, packed layouts are built with VertexLayout::pack()
+        using Layout = VertexLayout<vertex::PositionF32, vertex::ColorF32, vertex::TexCoordF32>;
+
         /*
           * @brief Get the binding description for the vertex.
           *
@@ -35,12 +39,7 @@ namespace maverik {
           *
         */
         static VkVertexInputBindingDescription getBindingDescription() {
-            VkVertexInputBindingDescription bindingDescription{};
-            bindingDescription.binding = 0;
-            bindingDescription.stride = sizeof(Vertex);
-            bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-            return bindingDescription;
+            return Layout::getBindingDescription();
         }
 
         /*
@@ -55,24 +54,7 @@ namespace maverik {
           *
         */
         static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions() {
-            std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions{};
-
-            attributeDescriptions[0].binding = 0;
-            attributeDescriptions[0].location = 0;
-            attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-            attributeDescriptions[0].offset = offsetof(Vertex, pos);
-
-            attributeDescriptions[1].binding = 0;
-            attributeDescriptions[1].location = 1;
-            attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
-            attributeDescriptions[1].offset = offsetof(Vertex, color);
-
-            attributeDescriptions[2].binding = 0;
-            attributeDescriptions[2].location = 2;
-            attributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
-            attributeDescriptions[2].offset = offsetof(Vertex, texCoord);
-
-            return attributeDescriptions;
+            return Layout::getAttributeDescriptions();
         }
 
         /*
@@ -89,6 +71,10 @@ namespace maverik {
             return pos == other.pos && color == other.color && texCoord == other.texCoord;
         }
     };
+
+    static_assert(Vertex::Layout::STRIDE == sizeof(Vertex), "Vertex::Layout must describe every member of Vertex");
+    static_assert(Vertex::Layout::OFFSETS[1] == offsetof(Vertex, color) && Vertex::Layout::OFFSETS[2] == offsetof(Vertex, texCoord),
+        "Vertex::Layout must follow the member order of Vertex");
 }
 
 #endif /* !VERTEX_HPP_ */
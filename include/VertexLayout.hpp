@@ -0,0 +1,402 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** VertexLayout
+*/
+
+#pragma once
+
+#include "maverik.hpp"
+
+#include <array>
+#include <tuple>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+
+namespace maverik {
+    /**
+     * @class VertexQuantization
+     * @brief Converts attribute values to the packed encodings vertex layouts store.
+     */
+    class VertexQuantization {
+        public:
+            /**
+             * @brief Converts a float to an IEEE half float, rounding to nearest even.
+             */
+            static uint16_t toHalf(float value);
+
+            /**
+             * @brief Converts a value in [-1, 1] to a 16-bit signed normalized integer.
+             */
+            static int16_t toSnorm16(float value);
+
+            /**
+             * @brief Converts a value in [0, 1] to an 8-bit unsigned normalized integer.
+             */
+            static uint8_t toUnorm8(float value);
+
+            /**
+             * @brief Maps a unit vector onto the octahedron unfolded into [-1, 1]².
+             *
+             * @param normal The unit vector.
+             * @return glm::vec2 The coordinates of the vector on the unfolded octahedron.
+             */
+            static glm::vec2 encodeOctahedral(const glm::vec3& normal);
+
+            /**
+             * @brief Reconstructs a unit vector from its octahedral encoding, as vertex shaders do.
+             *
+             * @param encoded The coordinates of the vector on the unfolded octahedron.
+             * @return glm::vec3 The normalized vector.
+             */
+            static glm::vec3 decodeOctahedral(const glm::vec2& encoded);
+    };
+
+    /**
+     * @namespace maverik::vertex
+     * @brief Attribute formats vertex layouts are declared with.
+     *
+     * Each format gives the storage of an attribute, its Vulkan format and how a value,
+     * passed as a vec4, is encoded into it. The semantic tells VertexLayout::pack() which
+     * member of the source vertices feeds the attribute.
+     */
+    namespace vertex {
+        /**
+         * @enum Semantic
+         * @brief The member of a source vertex an attribute is read from.
+         */
+        enum class Semantic {
+            POSITION,   ///> `pos`
+            COLOR,      ///> `color`, alpha is 1 when it has three components
+            TEXCOORD,   ///> `texCoord`
+            NORMAL,     ///> `normal`, a unit vector
+            INSTANCE    ///> Per-instance data, written with VertexLayout::write() only
+        };
+
+        /** @brief Four 32-bit floats, 16 bytes. */
+        template <Semantic S>
+        struct Float4 {
+            using Storage = std::array<float, 4>;
+            static constexpr Semantic SEMANTIC = S;
+            static constexpr VkFormat FORMAT = VK_FORMAT_R32G32B32A32_SFLOAT;
+            static constexpr bool NORMALIZED = false;
+
+            static Storage encode(const glm::vec4& value) {
+                return {value.x, value.y, value.z, value.w};
+            }
+        };
+
+        /** @brief Three 32-bit floats, 12 bytes. */
+        template <Semantic S>
+        struct Float3 {
+            using Storage = std::array<float, 3>;
+            static constexpr Semantic SEMANTIC = S;
+            static constexpr VkFormat FORMAT = VK_FORMAT_R32G32B32_SFLOAT;
+            static constexpr bool NORMALIZED = false;
+
+            static Storage encode(const glm::vec4& value) {
+                return {value.x, value.y, value.z};
+            }
+        };
+
+        /** @brief Two 32-bit floats, 8 bytes. */
+        template <Semantic S>
+        struct Float2 {
+            using Storage = std::array<float, 2>;
+            static constexpr Semantic SEMANTIC = S;
+            static constexpr VkFormat FORMAT = VK_FORMAT_R32G32_SFLOAT;
+            static constexpr bool NORMALIZED = false;
+
+            static Storage encode(const glm::vec4& value) {
+                return {value.x, value.y};
+            }
+        };
+
+        /**
+         * @brief Four half floats, 8 bytes.
+         *
+         * Three-component 16-bit formats are rarely supported for vertex input, the
+         * fourth component carries the w of positions or the alpha of colors.
+         */
+        template <Semantic S>
+        struct Half4 {
+            using Storage = std::array<uint16_t, 4>;
+            static constexpr Semantic SEMANTIC = S;
+            static constexpr VkFormat FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+            static constexpr bool NORMALIZED = false;
+
+            static Storage encode(const glm::vec4& value) {
+                return {
+                    VertexQuantization::toHalf(value.x), VertexQuantization::toHalf(value.y),
+                    VertexQuantization::toHalf(value.z), VertexQuantization::toHalf(value.w)
+                };
+            }
+        };
+
+        /** @brief Two half floats, 4 bytes. */
+        template <Semantic S>
+        struct Half2 {
+            using Storage = std::array<uint16_t, 2>;
+            static constexpr Semantic SEMANTIC = S;
+            static constexpr VkFormat FORMAT = VK_FORMAT_R16G16_SFLOAT;
+            static constexpr bool NORMALIZED = false;
+
+            static Storage encode(const glm::vec4& value) {
+                return {VertexQuantization::toHalf(value.x), VertexQuantization::toHalf(value.y)};
+            }
+        };
+
+        /**
+         * @brief Four 16-bit signed normalized integers, 8 bytes.
+         *
+         * Values must lie in [-1, 1]. VertexLayout::pack() remaps positions into that
+         * range from the bounds of the mesh, see PackedVertices.
+         */
+        template <Semantic S>
+        struct Snorm16x4 {
+            using Storage = std::array<int16_t, 4>;
+            static constexpr Semantic SEMANTIC = S;
+            static constexpr VkFormat FORMAT = VK_FORMAT_R16G16B16A16_SNORM;
+            static constexpr bool NORMALIZED = true;
+
+            static Storage encode(const glm::vec4& value) {
+                return {
+                    VertexQuantization::toSnorm16(value.x), VertexQuantization::toSnorm16(value.y),
+                    VertexQuantization::toSnorm16(value.z), VertexQuantization::toSnorm16(value.w)
+                };
+            }
+        };
+
+        /** @brief Four 8-bit unsigned normalized integers, 4 bytes, for values in [0, 1]. */
+        template <Semantic S>
+        struct Unorm8x4 {
+            using Storage = std::array<uint8_t, 4>;
+            static constexpr Semantic SEMANTIC = S;
+            static constexpr VkFormat FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+            static constexpr bool NORMALIZED = false;
+
+            static Storage encode(const glm::vec4& value) {
+                return {
+                    VertexQuantization::toUnorm8(value.x), VertexQuantization::toUnorm8(value.y),
+                    VertexQuantization::toUnorm8(value.z), VertexQuantization::toUnorm8(value.w)
+                };
+            }
+        };
+
+        /**
+         * @brief A unit vector folded onto an octahedron, as two 16-bit signed normalized integers, 4 bytes.
+         *
+         * Shaders rebuild the vector as VertexQuantization::decodeOctahedral() does.
+         */
+        template <Semantic S>
+        struct Octahedral16 {
+            using Storage = std::array<int16_t, 2>;
+            static constexpr Semantic SEMANTIC = S;
+            static constexpr VkFormat FORMAT = VK_FORMAT_R16G16_SNORM;
+            static constexpr bool NORMALIZED = false;
+
+            static Storage encode(const glm::vec4& value) {
+                glm::vec2 encoded = VertexQuantization::encodeOctahedral(glm::vec3(value));
+
+                return {VertexQuantization::toSnorm16(encoded.x), VertexQuantization::toSnorm16(encoded.y)};
+            }
+        };
+
+        using PositionF32 = Float3<Semantic::POSITION>;
+        using PositionHalf = Half4<Semantic::POSITION>;
+        using PositionSnorm16 = Snorm16x4<Semantic::POSITION>;
+        using ColorF32 = Float3<Semantic::COLOR>;
+        using ColorUnorm8 = Unorm8x4<Semantic::COLOR>;
+        using TexCoordF32 = Float2<Semantic::TEXCOORD>;
+        using TexCoordHalf = Half2<Semantic::TEXCOORD>;
+        using NormalF32 = Float3<Semantic::NORMAL>;
+        using NormalOctahedral = Octahedral16<Semantic::NORMAL>;
+        using InstanceF32x4 = Float4<Semantic::INSTANCE>;
+    }
+
+    /**
+     * @brief Vertices encoded with a VertexLayout, ready to be uploaded.
+     *
+     * Normalized positions are stored relative to the bounds of the mesh; they are
+     * brought back to model space by `position * _positionScale + _positionOffset`,
+     * which getDequantizationMatrix() folds into a matrix to premultiply the model
+     * matrix with.
+     */
+    struct PackedVertices {
+        std::vector<std::byte> _data;                   // Encoded vertices, _stride bytes each
+        uint32_t _stride = 0;                           // Size of a vertex, in bytes
+        size_t _count = 0;                              // Number of vertices
+        glm::vec3 _positionScale = glm::vec3(1.0f);     // Half extent of the bounds of normalized positions
+        glm::vec3 _positionOffset = glm::vec3(0.0f);    // Center of the bounds of normalized positions
+
+        glm::mat4 getDequantizationMatrix() const {
+            return glm::scale(glm::translate(glm::mat4(1.0f), _positionOffset), _positionScale);
+        }
+    };
+
+    /**
+     * @class VertexLayout
+     * @brief Vertex format declared as a list of attribute formats, resolved at compile time.
+     *
+     * Attributes are tightly packed in declaration order and bound at consecutive
+     * locations. For example, `VertexLayout<vertex::PositionHalf, vertex::ColorUnorm8,
+     * vertex::TexCoordHalf>` takes 16 bytes per vertex where Vertex takes 32, and still
+     * feeds the `vec3`/`vec3`/`vec2` inputs of the default shaders.
+     *
+     * @tparam Attributes The formats of the attributes, from the maverik::vertex namespace.
+     */
+    template <typename... Attributes>
+    class VertexLayout {
+        public:
+            template <size_t Index>
+            using Attribute = std::tuple_element_t<Index, std::tuple<Attributes...>>;
+
+            static constexpr uint32_t ATTRIBUTE_COUNT = sizeof...(Attributes);
+            static constexpr uint32_t STRIDE = (0 + ... + static_cast<uint32_t>(sizeof(typename Attributes::Storage)));
+
+            static_assert(ATTRIBUTE_COUNT > 0, "A vertex layout needs at least one attribute");
+            static_assert(((sizeof(typename Attributes::Storage) % 4 == 0) && ...), "Attributes must keep 4-byte alignment");
+
+            /**
+             * @brief Offsets of the attributes inside a vertex, in declaration order.
+             */
+            static constexpr std::array<uint32_t, ATTRIBUTE_COUNT> OFFSETS = [] {
+                std::array<uint32_t, ATTRIBUTE_COUNT> offsets{};
+                uint32_t offset = 0;
+                size_t index = 0;
+
+                ((offsets[index++] = offset, offset += static_cast<uint32_t>(sizeof(typename Attributes::Storage))), ...);
+                return offsets;
+            }();
+
+            /**
+             * @brief Get the binding description of the layout.
+             *
+             * @param binding The binding number the vertex buffer is bound to.
+             * @param inputRate Whether the buffer advances per vertex or per instance.
+             * @return VkVertexInputBindingDescription The binding description.
+             */
+            static constexpr VkVertexInputBindingDescription getBindingDescription(uint32_t binding = 0, VkVertexInputRate inputRate = VK_VERTEX_INPUT_RATE_VERTEX) {
+                VkVertexInputBindingDescription bindingDescription{};
+                bindingDescription.binding = binding;
+                bindingDescription.stride = STRIDE;
+                bindingDescription.inputRate = inputRate;
+
+                return bindingDescription;
+            }
+
+            /**
+             * @brief Get the attribute descriptions of the layout.
+             *
+             * @param binding The binding number the vertex buffer is bound to.
+             * @param firstLocation The shader location of the first attribute, the others follow it.
+             * @return std::array<VkVertexInputAttributeDescription, ATTRIBUTE_COUNT> The attribute descriptions.
+             */
+            static constexpr std::array<VkVertexInputAttributeDescription, ATTRIBUTE_COUNT> getAttributeDescriptions(uint32_t binding = 0, uint32_t firstLocation = 0) {
+                std::array<VkVertexInputAttributeDescription, ATTRIBUTE_COUNT> attributeDescriptions{};
+                constexpr VkFormat formats[] = {Attributes::FORMAT...};
+
+                for (uint32_t i = 0; i < ATTRIBUTE_COUNT; i++) {
+                    attributeDescriptions[i].binding = binding;
+                    attributeDescriptions[i].location = firstLocation + i;
+                    attributeDescriptions[i].format = formats[i];
+                    attributeDescriptions[i].offset = OFFSETS[i];
+                }
+                return attributeDescriptions;
+            }
+
+            /**
+             * @brief Encodes the value of an attribute into a vertex.
+             *
+             * @tparam Index The index of the attribute in the layout.
+             * @param vertex The first byte of the vertex.
+             * @param value The value of the attribute, unused components being ignored.
+             */
+            template <size_t Index>
+            static void write(std::byte *vertex, const glm::vec4& value) {
+                typename Attribute<Index>::Storage storage = Attribute<Index>::encode(value);
+
+                std::memcpy(vertex + OFFSETS[Index], &storage, sizeof(storage));
+            }
+
+            /**
+             * @brief Encodes vertices, reading each attribute from the member its semantic names.
+             *
+             * @param vertices The source vertices, such as Vertex. NORMAL attributes need a `normal` member.
+             * @return PackedVertices The encoded vertices and the transform of their normalized positions.
+             */
+            template <typename Source>
+            static PackedVertices pack(const std::vector<Source>& vertices) {
+                static_assert(((Attributes::SEMANTIC != vertex::Semantic::INSTANCE) && ...), "Per-instance layouts cannot be packed from vertices");
+                PackedVertices packed;
+
+                packed._stride = STRIDE;
+                packed._count = vertices.size();
+                packed._data.resize(vertices.size() * STRIDE);
+                if constexpr (((Attributes::NORMALIZED && Attributes::SEMANTIC == vertex::Semantic::POSITION) || ...)) {
+                    computePositionBounds(vertices, packed);
+                }
+                for (size_t i = 0; i < vertices.size(); i++) {
+                    writeVertex(packed._data.data() + i * STRIDE, vertices[i], packed, std::index_sequence_for<Attributes...>{});
+                }
+                return packed;
+            }
+
+        private:
+            template <typename Source>
+            static void computePositionBounds(const std::vector<Source>& vertices, PackedVertices& packed) {
+                if (vertices.empty()) {
+                    return;
+                }
+
+                glm::vec3 minimum = vertices[0].pos;
+                glm::vec3 maximum = vertices[0].pos;
+                for (const Source& source : vertices) {
+                    for (int axis = 0; axis < 3; axis++) {
+                        minimum[axis] = std::min(minimum[axis], source.pos[axis]);
+                        maximum[axis] = std::max(maximum[axis], source.pos[axis]);
+                    }
+                }
+                packed._positionOffset = (minimum + maximum) * 0.5f;
+                packed._positionScale = (maximum - minimum) * 0.5f;
+                // Flat meshes keep a unit scale on their flat axis instead of dividing by zero
+                for (int axis = 0; axis < 3; axis++) {
+                    if (packed._positionScale[axis] <= 0.0f) {
+                        packed._positionScale[axis] = 1.0f;
+                    }
+                }
+            }
+
+            template <typename Attr, typename Source>
+            static glm::vec4 fetch(const Source& source, const PackedVertices& packed) {
+                if constexpr (Attr::SEMANTIC == vertex::Semantic::POSITION) {
+                    if constexpr (Attr::NORMALIZED) {
+                        return glm::vec4((source.pos - packed._positionOffset) / packed._positionScale, 1.0f);
+                    } else {
+                        return glm::vec4(source.pos, 1.0f);
+                    }
+                } else if constexpr (Attr::SEMANTIC == vertex::Semantic::COLOR) {
+                    if constexpr (requires { source.color.w; }) {
+                        return glm::vec4(source.color);
+                    } else {
+                        return glm::vec4(source.color, 1.0f);
+                    }
+                } else if constexpr (Attr::SEMANTIC == vertex::Semantic::TEXCOORD) {
+                    return glm::vec4(source.texCoord, 0.0f, 0.0f);
+                } else {
+                    static_assert(requires { source.normal; }, "NORMAL attributes need source vertices with a normal member");
+                    return glm::vec4(source.normal, 0.0f);
+                }
+            }
+
+            template <typename Source, size_t... Indices>
+            static void writeVertex(std::byte *vertex, const Source& source, const PackedVertices& packed, std::index_sequence<Indices...>) {
+                (write<Indices>(vertex, fetch<Attribute<Indices>>(source, packed)), ...);
+            }
+    };
+}
@@ -11,6 +11,10 @@
     #include "ARenderingContext.hpp"
 
     #include "Vertex.hpp"
+    #include "MeshLoader.hpp"
+    #include "MeshOptimizer.hpp"
+    #include "MeshSimplifier.hpp"
+    #include "GeometryPool.hpp"
 
     #include "Utils.hpp"
 
@@ -118,61 +122,108 @@ namespace maverik {
                 // Destructor
                 ~RenderingContext();
 
-            protected:
-                GLFWwindow *_window;                    // Pointer to the GLFW window
-                VkSurfaceKHR _surface;                  // Vulkan surface for rendering
-                VkQueue _presentQueue;                  // Vulkan queue for presentation
+                /**
+                 * @brief Starts recording a new frame in flight.
+                 *
+                 * Waits for the in-flight fence of the frame, then recycles every transient
+                 * command buffer handed out during its previous use with a single pool reset,
+                 * and the partition of the frame in the dynamic geometry ring. Bindless slots
+                 * released MAX_FRAMES_IN_FLIGHT frames ago become reusable.
+                 *
+                 * @param currentFrame The index of the frame in flight, in [0, MAX_FRAMES_IN_FLIGHT).
+                 *
+                 * @return VkCommandBuffer The primary command buffer of the frame, handed out
+                 * by the command allocator and recycled with it on the next use of the frame.
+                 *
+                 * @note Must be called at the beginning of each frame, before any command
+                 * buffer is requested from the command allocator or geometry written to the
+                 * dynamic geometry ring for that frame.
+                 */
+                VkCommandBuffer beginFrame(uint32_t currentFrame);
 
-                std::vector<Vertex> _vertices;          // Vector of vertices for rendering
-                std::vector<uint32_t> _indices;         // Vector of indices for rendering
+                /**
+                 * @brief Replaces the vertices and indices rendered by the context.
+                 *
+                 * Waits for the device to be idle, frees the current mesh from its geometry
+                 * pool, then uploads the new arrays, as produced by MeshLoader, to the pool of
+                 * the index type selected by MeshOptimizer::selectIndexType(). Other meshes of
+                 * the pools are left untouched.
+                 *
+                 * @param mesh The vertices and indices to upload, moved into the context.
+                 * @param optimize Whether to reorder the mesh with MeshOptimizer::optimize() first.
+                 * @param lodCount The number of levels of detail to generate with MeshSimplifier, the full mesh included.
+                 */
+                void setMesh(MeshData mesh, bool optimize = true, uint32_t lodCount = 1);
 
                 /**
-                 * @brief Creates and initializes the vertex buffer required for rendering.
+                 * @brief Binds the vertex and index buffers of the geometry pool of the mesh to a command buffer.
                  *
-                 * This function allocates GPU memory and sets up the vertex buffer
-                 * to store vertex data used in rendering operations. It should be called
-                 * during the initialization phase before issuing any draw commands that
-                 * require vertex input.
+                 * The index buffer is bound with the index type of the mesh, every mesh of the
+                 * same pool is then drawn with the `_firstIndex` and `_vertexOffset` of its range.
                  *
-                 * @note Ensure that the necessary Vulkan resources and device context
-                 *       are properly initialized before calling this function.
+                 * @param commandBuffer The command buffer being recorded.
                  */
-                void createVertexBuffer();
+                void bindGeometryBuffers(VkCommandBuffer commandBuffer) const;
 
-                VkBuffer _vertexBuffer;                                 // Vulkan buffer for vertex data
-                VkDeviceMemory _vertexBufferMemory;                     // Vulkan memory for vertex buffer
+                uint32_t getIndexCount() const {
+                    return _lods[0]._indexCount;
+                }
 
-                VkBuffer _indexBuffer;                                  // Vulkan buffer for index data
-                VkDeviceMemory _indexBufferMemory;                      // Vulkan memory for index buffer
+                const std::vector<LodLevel>& getLods() const {
+                    return _lods;
+                }
 
                 /**
-                 * @brief Creates and initializes the index buffer for rendering.
+                 * @brief Get the range a level of detail of the mesh is drawn with.
                  *
-                 * This function allocates GPU memory and sets up the index buffer
-                 * required for indexed drawing operations. It typically uploads
-                 * index data to the buffer and prepares it for use in the rendering
-                 * pipeline.
+                 * Levels share the vertices of the mesh and only differ by their indices.
                  *
-                 * @note Must be called before issuing draw commands that use indexed rendering.
+                 * @param level The level, 0 being the full mesh, see MeshSimplifier::selectLod().
                  */
-                void createIndexBuffer();
+                MeshRange getLodRange(uint32_t level) const {
+                    MeshRange range = this->getGeometryPool()->getRange(_mesh);
+                    return {range._firstIndex + _lods.at(level)._firstIndex, _lods.at(level)._indexCount, range._vertexOffset};
+                }
 
-                std::vector<VkCommandBuffer> _commandBuffers;           // Vector of Vulkan command buffers for rendering
+                /**
+                 * @brief Get the range the full mesh is drawn with, without the coarser levels stored after it.
+                 */
+                MeshRange getMeshRange() const {
+                    return this->getLodRange(0);
+                }
 
                 /**
-                 * @brief Allocates and records command buffers required for rendering operations.
-                 *
-                 * This function creates the necessary Vulkan command buffers for the rendering context.
-                 * It typically allocates one command buffer per framebuffer and records the commands
-                 * needed to render each frame. The command buffers are used during the rendering loop
-                 * to submit drawing commands to the GPU.
+                 * @brief Get the geometry pool holding the mesh, the one of its index type.
+                 */
+                std::shared_ptr<GeometryPool> getGeometryPool() const {
+                    return _geometryPools.at(_meshIndexType);
+                }
+
+            protected:
+                GLFWwindow *_window;                    // Pointer to the GLFW window
+                VkSurfaceKHR _surface;                  // Vulkan surface for rendering
+                VkQueue _presentQueue;                  // Vulkan queue for presentation
+
+                std::vector<Vertex> _vertices;          // Vector of vertices for rendering
+                std::vector<uint32_t> _indices;         // Vector of indices for rendering, every level of detail after the full mesh
+                std::vector<LodLevel> _lods = {LodLevel{}};     // Levels of detail of the mesh, ranges of _indices
+
+                /**
+                 * @brief Uploads the vertices and indices to the geometry pool of their index type.
                  *
-                 * @note This function should be called after the Vulkan device and swapchain have been initialized.
-                 *       It may need to be called again if the swapchain is recreated (e.g., on window resize).
+                 * Meshes with fewer than 65536 vertices go to a pool of 16-bit indices, the others
+                 * to a pool of 32-bit indices. A pool is created by the first mesh needing it, so
+                 * both sizes can live side by side without replacing a pool once meshes were added.
+                 * Other meshes of the Vertex layout may be added to the pools, and drawn with the
+                 * same buffer binds as the meshes of the same index type.
                  *
-                 * @throws std::runtime_error if command buffer allocation or recording fails.
+                 * @note Must be called before issuing draw commands that use indexed rendering.
                  */
-                void createCommandBuffers();
+                void allocateMesh();
+
+                std::map<VkIndexType, std::shared_ptr<GeometryPool>> _geometryPools;   // Vertex and index buffers shared by every mesh, by index type
+                VkIndexType _meshIndexType;                             // Index type of the current mesh, and of its geometry pool
+                uint32_t _mesh;                                         // Identifier of the current mesh in its geometry pool
 
                 std::vector<VkSemaphore> _imageAvailableSemaphores;     // Vector of Vulkan semaphores for image availability
                 std::vector<VkSemaphore> _renderFinishedSemaphores;     // Vector of Vulkan semaphores for rendering completion
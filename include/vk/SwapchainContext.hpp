@@ -11,8 +11,18 @@
     #include "ASwapchainContext.hpp"
 
     #include "Vertex.hpp"
+    #include "InstanceBatcher.hpp"
 
     #include "Utils.hpp"
+    #include "ThreadPool.hpp"
+    #include "PipelineStateCache.hpp"
+    #include "BindlessTextureTable.hpp"
+    #include "SamplerCache.hpp"
+    #include "HostImageCopy.hpp"
+    #include "ComputeMipGenerator.hpp"
+    #include "TextureRegistry.hpp"
+    #include "TextureFormat.hpp"
+    #include "AAssetManager.hpp"
 
     #include <map>
 
@@ -79,6 +89,40 @@ namespace maverik {
                      * @brief The Vulkan instance associated with the swapchain context.
                      */
                     VkInstance _instance;
+                    /*
+                     * @brief The frame-scoped transient command allocator used for uploads.
+                     */
+                    CommandAllocator *_commandAllocator = nullptr;
+                    /*
+                     * @brief The bindless texture table, enabling bindless mode when not null.
+                     *
+                     * In bindless mode the graphics pipelines use `bindless.frag.spv` of the shader directory.
+                     */
+                    BindlessTextureTable *_bindlessTextureTable = nullptr;
+                    /*
+                     * @brief The cache texture samplers are acquired from, samplers are created per texture when null.
+                     */
+                    SamplerCache *_samplerCache = nullptr;
+                    /*
+                     * @brief The host image copy helper textures are uploaded with, staging buffers are used when null.
+                     */
+                    HostImageCopy *_hostImageCopy = nullptr;
+                    /*
+                     * @brief The pipeline cache the graphics pipelines are compiled through, if any.
+                     */
+                    VkPipelineCache _pipelineCache = VK_NULL_HANDLE;
+                    /*
+                     * @brief The tracker of the rendering context the image barriers are recorded through.
+                     */
+                    ResourceStateTracker *_resourceStateTracker = nullptr;
+                    /*
+                     * @brief The compute mip generator of the rendering context, if any.
+                     */
+                    ComputeMipGenerator *_computeMipGenerator = nullptr;
+                    /*
+                     * @brief The directory containing the compiled shaders of the graphics pipelines.
+                     */
+                    std::string _shaderDirectory = "shaders";
                 };
 
                 /**
@@ -111,6 +155,30 @@ namespace maverik {
                      * @brief The Vulkan graphics queue used for rendering operations.
                      */
                     VkQueue _graphicsQueue;
+                    /*
+                     * @brief The frame-scoped transient command allocator used for uploads.
+                     */
+                    CommandAllocator *_commandAllocator = nullptr;
+                    /*
+                     * @brief The compute mip generator used instead of blits by createTextureImages, and by createTextureImage for formats without linear-filter blit support, if any.
+                     */
+                    ComputeMipGenerator *_computeMipGenerator = nullptr;
+                    /*
+                     * @brief What the decoded images are used for, which selects their format.
+                     */
+                    TextureFormat::Usage _usage = TextureFormat::Usage::COLOR;
+                    /*
+                     * @brief The asset manager texture files are read through and cached in, files are read without caching when null.
+                     */
+                    AAssetManager *_assetManager = nullptr;
+                    /*
+                     * @brief The host image copy helper pixels are copied with when the format allows it, staging buffers are used when null.
+                     */
+                    HostImageCopy *_hostImageCopy = nullptr;
+                    /*
+                     * @brief The tracker of the rendering context the image barriers are recorded through, a temporary one is used when null.
+                     */
+                    ResourceStateTracker *_resourceStateTracker = nullptr;
                 };
 
                 /**
@@ -157,9 +225,126 @@ namespace maverik {
                  * @param properties The properties required for texture image creation.
                  *
                  * @note This function loads the texture image from the specified path and
-                 * creates the necessary Vulkan image resources for rendering.
+                 * creates the necessary Vulkan image resources for rendering. The file is read once
+                 * through the asset manager of the properties, if any, and every format is loaded
+                 * from that buffer. `.ktx2` and cooked `.mvktex` files are copied from it to staging
+                 * as-is with their own format and mip chain, other images are decoded from it to the
+                 * format selected by TextureFormat from their channel count and the usage set in the
+                 * properties, and get their mipmaps generated: with blits, or with the compute mip
+                 * generator of the properties when the format lacks linear-filter blit support.
+                 *
+                 * @return TextureHandle The handle of the texture, named after its path.
+                 *
+                 * @throws std::runtime_error If the texture is already loaded or fails to load.
+                 */
+                TextureHandle createTextureImage(const std::string& texturePath, const TextureImageCreationProperties& properties);
+
+                /**
+                 * @brief Creates texture images from several files, decoding them in parallel.
+                 *
+                 * Files are read through the asset manager on the calling thread, as asset managers
+                 * are not thread-safe, then images are decoded from the read buffers on the worker
+                 * threads of the pool. As soon as one is decoded,
+                 * it is copied to its own staging buffer and its upload and mipmap generation are
+                 * recorded in a single command buffer and submitted without waiting, so the GPU work
+                 * of a texture overlaps with the decoding of the next ones. `.ktx2` and `.mvktex`
+                 * files need no decoding and are uploaded on the calling thread meanwhile.
+                 *
+                 * @param texturePaths The file paths to the texture images.
+                 * @param properties The properties required for texture image creation.
+                 * @param threadPool The pool decoding the images, a temporary one sized to the hardware is used if null.
+                 * @return std::vector<TextureHandle> The handles of the textures, in the order of the paths.
+                 *
+                 * @throws std::runtime_error If a texture is already loaded, or if any image fails to load
+                 * after every other upload has completed.
+                 */
+                std::vector<TextureHandle> createTextureImages(const std::vector<std::string>& texturePaths, const TextureImageCreationProperties& properties, ThreadPool *threadPool = nullptr);
+
+                /**
+                 * @brief Registers a texture into the bindless texture table.
+                 *
+                 * The texture keeps its slot if it is registered again, for instance after its
+                 * image view or sampler has been recreated.
+                 *
+                 * @param texture The handle of a texture whose image view and sampler have been created.
+                 * @return uint32_t The slot shaders index the bindless array with, to be passed to setMaterial.
+                 *
+                 * @throws std::runtime_error If bindless mode is disabled, the handle is stale or the texture has no view or sampler.
+                 */
+                uint32_t registerBindlessTexture(TextureHandle texture);
+
+                /**
+                 * @brief Binds the per-frame descriptor set, and the bindless texture array in bindless mode.
+                 *
+                 * In bindless mode this is needed once per command buffer, whatever the number of materials drawn.
+                 *
+                 * @param commandBuffer The command buffer, in the recording state.
+                 * @param currentFrame The index of the frame in flight.
+                 */
+                void bindDescriptorSets(VkCommandBuffer commandBuffer, uint32_t currentFrame);
+
+                /**
+                 * @brief Selects the texture sampled by the next draws, in bindless mode.
+                 *
+                 * @param commandBuffer The command buffer, in the recording state.
+                 * @param textureSlot The slot returned by registerBindlessTexture.
+                 */
+                void setMaterial(VkCommandBuffer commandBuffer, uint32_t textureSlot);
+
+                /**
+                 * @brief Selects the texture sampled by the next draws, in bindless mode.
+                 *
+                 * @param commandBuffer The command buffer, in the recording state.
+                 * @param texture The handle of a texture registered with registerBindlessTexture.
+                 *
+                 * @throws std::runtime_error If the handle is stale or the texture has no bindless slot.
+                 */
+                void setMaterial(VkCommandBuffer commandBuffer, TextureHandle texture);
+
+                /**
+                 * @brief Get the handle of a loaded texture by its name.
+                 *
+                 * Meant for load time, handles should be kept instead of looking names up every frame.
+                 *
+                 * @param textureName The name of the texture, its path.
+                 * @return TextureHandle The handle, invalid if no texture has that name.
                  */
-                void createTextureImage(const std::string& texturePath, const TextureImageCreationProperties& properties);
+                TextureHandle getTextureHandle(const std::string& textureName) const;
+
+                /**
+                 * @brief Get a graphics pipeline of the context.
+                 *
+                 * Both pipelines share the pipeline layout, so descriptor sets and materials stay
+                 * bound when switching from one to the other.
+                 *
+                 * The instanced pipeline is optional: it compiles on a worker, and the regular
+                 * pipeline is returned until it is ready, or for good if its vertex shader is
+                 * missing or fails to compile.
+                 *
+                 * @param instanced Whether to get the instanced pipeline, drawing the batches of an InstanceBatcher.
+                 * @return VkPipeline The pipeline.
+                 */
+                VkPipeline getGraphicsPipeline(bool instanced = false) const;
+
+                /**
+                 * @brief Get the description a graphics pipeline of the context was compiled from.
+                 *
+                 * Material variants are derived from it, changing their shaders or states, then
+                 * requested from getPipelineStateCache() with getGraphicsPipeline() as fallback.
+                 *
+                 * @param instanced Whether to describe the instanced pipeline.
+                 * @return PipelineDescription The description of the pipeline.
+                 */
+                PipelineDescription getPipelineDescription(bool instanced = false) const;
+
+                /**
+                 * @brief Get the cache the graphics pipelines of the context are compiled through.
+                 *
+                 * @return PipelineStateCache* The cache, owning the pipelines it compiles.
+                 */
+                PipelineStateCache *getPipelineStateCache() const {
+                    return _pipelineStateCache.get();
+                }
 
             protected:
                 std::vector<VkImage> _swapchainImages;              // Images in the swapchain
@@ -177,36 +362,158 @@ namespace maverik {
                 void createImageViews(VkDevice logicalDevice);
 
                 // Texture images
-                std::map<std::string, VkImage> _textureImage;           // Texture images mapped by their names
-                VkDeviceMemory _textureImageMemory;                     // Memory for texture images
-                std::map<std::string, VkImageView> _textureImageView;   // Image views for texture images mapped by their names
-                std::map<std::string, VkSampler> _textureSampler;       // Samplers for texture images mapped by their names
+                TextureRegistry _textures;                              // Texture images, views, samplers and metadata
+
+                /**
+                 * @brief Creates a texture image from a KTX2 file.
+                 *
+                 * The payload of every mip level stored in the file is copied to a single
+                 * staging buffer and uploaded with one copy region per level, so block-compressed
+                 * textures (BC, ETC2, ASTC) need neither decoding nor runtime mip generation.
+                 * Payloads are read straight from the asset, the file is not copied beforehand.
+                 *
+                 * @param texturePath The file path to the `.ktx2` texture.
+                 * @param asset The asset holding the content of the file.
+                 * @param properties The properties required for texture image creation.
+                 *
+                 * @return TextureHandle The handle of the texture.
+                 *
+                 * @throws std::runtime_error If the file is invalid or its format cannot be sampled by the device.
+                 */
+                TextureHandle createKtxTextureImage(const std::string& texturePath, const std::shared_ptr<FileAsset>& asset, const TextureImageCreationProperties& properties);
+
+                /**
+                 * @brief Creates a texture image from a cooked `.mvktex` file.
+                 *
+                 * The whole mip chain of the file, produced offline by the texture cooker, is
+                 * copied from the asset to staging with a single memcpy.
+                 *
+                 * @param texturePath The file path to the `.mvktex` texture.
+                 * @param asset The asset holding the content of the file.
+                 * @param properties The properties required for texture image creation.
+                 *
+                 * @return TextureHandle The handle of the texture.
+                 *
+                 * @throws std::runtime_error If the file is invalid or its format cannot be sampled by the device.
+                 */
+                TextureHandle createCookedTextureImage(const std::string& texturePath, const std::shared_ptr<FileAsset>& asset, const TextureImageCreationProperties& properties);
+
+                /**
+                 * @brief Creates a sampled texture image and uploads precomputed mip levels into it.
+                 *
+                 * Levels are copied from the host by copyTextureLevelsFromHost() when the host image
+                 * copy helper of the properties supports the format, through a staging buffer otherwise.
+                 *
+                 * @param textureName The name the texture is registered under.
+                 * @param properties The properties required for texture image creation.
+                 * @param format The format of the image and of the payload.
+                 * @param width The width of the base level in pixels.
+                 * @param height The height of the base level in pixels.
+                 * @param payload The data of every level, laid out as described by the regions.
+                 * @param payloadSize The size of the payload in bytes.
+                 * @param regions One copy region per mip level, offsets being relative to the payload.
+                 * @return TextureHandle The handle of the registered texture.
+                 */
+                TextureHandle uploadTextureLevels(const std::string& textureName, const TextureImageCreationProperties& properties, VkFormat format, uint32_t width, uint32_t height, const char *payload, VkDeviceSize payloadSize, const std::vector<VkBufferImageCopy>& regions);
+
+                /**
+                 * @brief Creates a sampled texture image and copies precomputed mip levels into it from the host.
+                 *
+                 * No staging buffer nor command buffer is involved: the image is transitioned to
+                 * its sampled layout and filled by the CPU through the host image copy helper.
+                 *
+                 * @param textureName The name the texture is registered under.
+                 * @param properties The properties required for texture image creation, with a host image copy helper.
+                 * @param format The format of the image and of the payload, supported by the helper.
+                 * @param width The width of the base level in pixels.
+                 * @param height The height of the base level in pixels.
+                 * @param payload The data of every level, laid out as described by the regions.
+                 * @param regions One copy region per mip level, offsets being relative to the payload.
+                 * @return TextureHandle The handle of the registered texture.
+                 */
+                TextureHandle copyTextureLevelsFromHost(const std::string& textureName, const TextureImageCreationProperties& properties, VkFormat format, uint32_t width, uint32_t height, const char *payload, const std::vector<VkBufferImageCopy>& regions);
+
+                /**
+                 * @struct TextureUpload
+                 * @brief GPU work of a texture submitted by createTextureImages and not yet retired.
+                 */
+                struct TextureUpload {
+                    VkFence _fence;                         // Signaled once the upload has executed
+                    VkCommandBuffer _commandBuffer;         // Command buffer recording the upload
+                    VkBuffer _stagingBuffer;                // Staging buffer holding the decoded pixels, null if copied from the host
+                    VkDeviceMemory _stagingBufferMemory;    // Memory of the staging buffer, null if copied from the host
+                    ComputeMipGenerator::Generation _mipGeneration; // Views and sets of a compute mip generation
+                };
+
+                /**
+                 * @brief Creates a texture image from decoded pixels and submits its upload.
+                 *
+                 * The transition, the copy of the base level and the mipmap generation are recorded
+                 * in one one-shot command buffer of the command allocator (of the command pool when
+                 * there is none), then submitted with a fence.
+                 * The texture is registered as soon as its upload is submitted.
+                 *
+                 * @param textureName The name the texture is registered under.
+                 * @param properties The properties required for texture image creation.
+                 * @param selection The format of the image and of the pixels.
+                 * @param pixels The decoded pixels of the base level.
+                 * @param width The width of the base level in pixels.
+                 * @param height The height of the base level in pixels.
+                 * @return TextureUpload The in-flight upload, to be retired with retireTextureUpload.
+                 */
+                TextureUpload submitTextureUpload(const std::string& textureName, const TextureImageCreationProperties& properties, const TextureFormat::Selection& selection, const unsigned char *pixels, uint32_t width, uint32_t height);
+
+                /**
+                 * @brief Waits for an upload to complete, recycles its command buffer and releases its staging resources.
+                 *
+                 * @param upload The upload returned by submitTextureUpload.
+                 * @param properties The properties the upload was submitted with.
+                 */
+                void retireTextureUpload(const TextureUpload& upload, const TextureImageCreationProperties& properties);
+
+                /**
+                 * @brief Checks whether uploads generate their mipmaps with the compute mip generator.
+                 *
+                 * @param properties The properties the uploads are submitted with.
+                 * @param format The format of the texture.
+                 * @return true if a generator is set and supports the texture format.
+                 */
+                bool usesComputeMipGeneration(const TextureImageCreationProperties& properties, VkFormat format) const;
+
+                /**
+                 * @brief Get the tracker the barriers of the uploads are recorded through.
+                 *
+                 * @param properties The properties the uploads are submitted with.
+                 * @return ResourceStateTracker* The tracker of the properties, or one owned by the swapchain when they have none.
+                 */
+                ResourceStateTracker *getResourceStateTracker(const TextureImageCreationProperties& properties);
 
                 /**
                  * @brief Creates texture image views for all texture images.
                  *
                  * @param logicalDevice The Vulkan logical device used to create the image view.
                  *
-                 * @note This function initializes the `_textureImageView` member by creating an image view
-                 * for each texture image in the `_textureImage` map using the specified logical device.
-                 * The image views are created with the `VK_FORMAT_R8G8B8A8_SRGB` format and the color aspect flag.
+                 * @note This function creates an image view for each registered texture that has none yet,
+                 * using the specified logical device. The image views are created with the format and
+                 * mip level count of each texture and the color aspect flag.
                  */
                 void createTextureImageView(VkDevice logicalDevice);
 
                 /**
                  * @brief Creates a Vulkan texture sampler for the swapchain context.
                  *
-                 * This function initializes a texture sampler for the specified texture name
+                 * This function initializes a texture sampler for the specified texture
                  * using the provided logical device and physical device. The sampler is created
                  * with the given sampler creation info or defaults to standard settings if none
-                 * are provided.
+                 * are provided. When a sampler cache is set, textures with identical sampler
+                 * states share the same sampler.
                  *
                  * @param logicalDevice The Vulkan logical device used to create the sampler.
                  * @param physicalDevice The Vulkan physical device used to query properties for sampler creation.
-                 * @param textureName The name of the texture for which the sampler is being created.
+                 * @param texture The handle of the texture for which the sampler is being created.
                  * @param samplerInfo Optional sampler creation info; if not provided, default settings are used.
                  */
-                void createTextureSampler(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, const std::string& textureName, VkSamplerCreateInfo samplerInfo = {});
+                void createTextureSampler(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, TextureHandle texture, VkSamplerCreateInfo samplerInfo = {});
 
                 // Depth images
                 VkImage _depthImage;                    // Depth image
@@ -261,6 +568,8 @@ namespace maverik {
 
                 VkPipelineLayout _pipelineLayout;       // Vulkan pipeline layout
                 VkPipeline _graphicsPipeline;           // Vulkan graphics pipeline
+                std::unique_ptr<PipelineStateCache> _pipelineStateCache;    // Graphics pipelines deduplicated by their description
+                std::unique_ptr<ResourceStateTracker> _ownedResourceStateTracker;   // Tracker of the uploads given no tracker
 
 
                 VkDescriptorPool _descriptorPool;                       // Vulkan descriptor pool for managing descriptor sets
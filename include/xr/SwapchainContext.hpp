@@ -32,6 +32,8 @@ namespace maverik {
          * _SAMPLE_COUNT_1_BIT)
          * @param _commandPool The Vulkan command pool
          * @param _graphicsQueue The Vulkan graphics queue
+         * @param _pipelineCache The Vulkan pipeline cache the graphics pipeline is compiled through, if any
+         * @param _resourceStateTracker The tracker of the rendering context the image barriers are recorded through, if any
          */
         struct SwapchainContextCreationPropertiesXR {
             XrInstance _instance;
@@ -42,6 +44,8 @@ namespace maverik {
             VkSampleCountFlagBits _msaaSamples = VK_SAMPLE_COUNT_1_BIT;
             VkCommandPool _commandPool;
             VkQueue _graphicsQueue;
+            VkPipelineCache _pipelineCache = VK_NULL_HANDLE;
+            ResourceStateTracker *_resourceStateTracker = nullptr;
         };
 
         /**
@@ -53,6 +57,7 @@ namespace maverik {
          * @param _swapchainCreateInfo The OpenXR swapchain creation info
          * @param _commandPool The Vulkan command pool
          * @param _graphicsQueue The Vulkan graphics queue
+         * @param _resourceStateTracker The tracker of the rendering context the image barriers are recorded through, if any
          */
         struct SwapchainImageCreationPropertiesXR {
             VkDevice _device;
@@ -61,6 +66,7 @@ namespace maverik {
             XrSwapchainCreateInfo _swapchainCreateInfo;
             VkCommandPool _commandPool;
             VkQueue _graphicsQueue;
+            ResourceStateTracker *_resourceStateTracker = nullptr;
         };
 
         /**
@@ -108,6 +114,7 @@ namespace maverik {
 
             VkCommandPool _commandPool;          // Vulkan command pool
             VkQueue _graphicsQueue;              // Vulkan graphics queue
+            ResourceStateTracker *_resourceStateTracker = nullptr;  // Tracker of the image states, if any
 
             /**
              * @brief Initializes the swapchain image resources.
@@ -236,6 +243,8 @@ namespace maverik {
                 VkSampleCountFlagBits _msaaSamples = VK_SAMPLE_COUNT_1_BIT; // MSAA sample count
                 VkCommandPool _commandPool; // The Vulkan command pool
                 VkQueue _graphicsQueue;     // The Vulkan graphics queue
+                VkPipelineCache _pipelineCache; // The Vulkan pipeline cache
+                ResourceStateTracker *_resourceStateTracker; // The tracker of the image states, if any
 
                 std::vector<XrViewConfigurationView> _viewsConfigurations;  // View configurations for the swapchain
                 std::vector<XrView> _views; // Views for the swapchain
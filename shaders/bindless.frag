@@ -0,0 +1,29 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** bindless
+*/
+
+// Fragment shader of the graphics pipelines in bindless mode: the default fragment
+// shader, with the texture of set 0 replaced by the slot of the bindless array of
+// set 1 selected by SwapchainContext::setMaterial(). See BindlessTextureTable.
+
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+// Slot of the material texture, pushed by SwapchainContext::setMaterial()
+layout(push_constant) uniform Material {
+    uint materialIndex;
+} material;
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    outColor = texture(textures[nonuniformEXT(material.materialIndex)], fragTexCoord);
+}
@@ -0,0 +1,41 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** instanced
+*/
+
+// Vertex shader of the instanced pipeline: the default vertex shader, with the model
+// matrix of the uniform buffer replaced by the per-instance transform of binding 1.
+//
+// Outputs match the ones of the default vertex shader, so the default fragment shader
+// is shared by both pipelines. The alpha of the instance color is forwarded as the LOD
+// dither coverage, for fragment shaders including lod_dither.glsl.
+
+#version 450
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+// Binding 0, per vertex, see Vertex
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 2) in vec2 inTexCoord;
+
+// Binding 1, per instance, see InstanceData
+layout(location = 3) in mat4 instanceTransform;
+layout(location = 7) in vec4 instanceColor;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) out float fragLodCoverage;
+
+void main() {
+    gl_Position = ubo.proj * ubo.view * instanceTransform * vec4(inPosition, 1.0);
+    fragColor = inColor * instanceColor.rgb;
+    fragTexCoord = inTexCoord;
+    fragLodCoverage = instanceColor.a;
+}
@@ -0,0 +1,30 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** lod_dither
+*/
+
+// Dithered cross-fade between two levels of detail, see LodSelection.
+//
+// Included by fragment shaders (GL_GOOGLE_include_directive), which discard the
+// fragment when lodDitherDiscard() returns true. A coverage c in [0, 1] keeps the
+// pixels whose threshold is below c, a coverage of -c keeps exactly the others, so
+// two levels drawn with c and -c cover every pixel once. The default coverage of 1
+// keeps every pixel. A level that is not fading must use 1, not -0.0, which compares
+// equal to 0 and would discard every pixel: see LodSelection::getLevelCoverage().
+
+const float LOD_DITHER_BAYER[16] = float[16](
+     0.0 / 16.0,  8.0 / 16.0,  2.0 / 16.0, 10.0 / 16.0,
+    12.0 / 16.0,  4.0 / 16.0, 14.0 / 16.0,  6.0 / 16.0,
+     3.0 / 16.0, 11.0 / 16.0,  1.0 / 16.0,  9.0 / 16.0,
+    15.0 / 16.0,  7.0 / 16.0, 13.0 / 16.0,  5.0 / 16.0
+);
+
+bool lodDitherDiscard(float coverage)
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy) & 3;
+    float threshold = LOD_DITHER_BAYER[pixel.y * 4 + pixel.x];
+
+    return coverage >= 0.0 ? threshold >= coverage : threshold < -coverage;
+}
@@ -7,6 +7,18 @@
 
 #include "ARenderingContext.hpp"
 
+#include <algorithm>
+
+/*
+ * Number of slots of the bindless texture table, unless the device limits are lower.
+ */
+static constexpr uint32_t BINDLESS_TEXTURE_CAPACITY = 4096;
+
+/*
+ * File the pipeline cache is persisted to, relative to the working directory.
+ */
+static constexpr const char *PIPELINE_CACHE_PATH = "pipeline_cache.bin";
+
 ///////////////////////
 // Protected methods //
 ///////////////////////
@@ -51,3 +63,79 @@ void maverik::ARenderingContext::createCommandPool()
         return;
     }
 }
+
+void maverik::ARenderingContext::createCommandAllocator(uint32_t framesInFlight)
+{
+    CommandAllocator::CommandAllocatorCreationProperties properties = {
+        ._logicalDevice = _logicalDevice,
+        ._queueFamilyIndex = Utils::findQueueFamilies(_physicalDevice).graphicsFamily.value(),
+        ._framesInFlight = framesInFlight
+    };
+
+    _commandAllocator = std::make_shared<CommandAllocator>(properties);
+}
+
+void maverik::ARenderingContext::createBindlessTextureTable(uint32_t framesInFlight)
+{
+    if (!_capabilities._descriptorIndexing) {
+        return;
+    }
+
+    BindlessTextureTable::BindlessTextureTableCreationProperties properties = {
+        ._logicalDevice = _logicalDevice,
+        ._capacity = std::min(BINDLESS_TEXTURE_CAPACITY, _capabilities._maxBindlessTextures),
+        ._framesInFlight = framesInFlight
+    };
+
+    _bindlessTextureTable = std::make_shared<BindlessTextureTable>(properties);
+}
+
+void maverik::ARenderingContext::createSamplerCache()
+{
+    _samplerCache = std::make_shared<SamplerCache>(_logicalDevice);
+}
+
+void maverik::ARenderingContext::createHostImageCopy()
+{
+    if (!_capabilities._hostImageCopy) {
+        return;
+    }
+    _hostImageCopy = std::make_shared<HostImageCopy>(_logicalDevice, _physicalDevice);
+}
+
+void maverik::ARenderingContext::createDynamicGeometry(uint32_t framesInFlight)
+{
+    DynamicGeometry::DynamicGeometryCreationProperties properties = {
+        ._physicalDevice = _physicalDevice,
+        ._logicalDevice = _logicalDevice,
+        ._framesInFlight = framesInFlight
+    };
+
+    _dynamicGeometry = std::make_shared<DynamicGeometry>(properties);
+}
+
+void maverik::ARenderingContext::createPipelineCache()
+{
+    _pipelineCache = std::make_shared<PipelineCache>(_logicalDevice, _physicalDevice, PIPELINE_CACHE_PATH);
+}
+
+void maverik::ARenderingContext::createResourceStateTracker()
+{
+    _resourceStateTracker = std::make_shared<ResourceStateTracker>(_logicalDevice, _capabilities._synchronization2);
+}
+
+void maverik::ARenderingContext::createComputeMipGenerator(const std::string& shaderDirectory)
+{
+    if (!ComputeMipGenerator::hasShaders(shaderDirectory)) {
+        return;
+    }
+
+    ComputeMipGenerator::ComputeMipGeneratorCreationProperties properties = {
+        ._physicalDevice = _physicalDevice,
+        ._logicalDevice = _logicalDevice,
+        ._shaderDirectory = shaderDirectory,
+        ._pipelineCache = _pipelineCache->getHandle()
+    };
+
+    _computeMipGenerator = std::make_shared<ComputeMipGenerator>(properties);
+}
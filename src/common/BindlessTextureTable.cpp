@@ -0,0 +1,119 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** BindlessTextureTable
+*/
+
+#include "BindlessTextureTable.hpp"
+
+////////////////////
+// Public methods //
+////////////////////
+
+maverik::BindlessTextureTable::BindlessTextureTable(const BindlessTextureTableCreationProperties& properties)
+    : _logicalDevice(properties._logicalDevice), _capacity(properties._capacity), _framesInFlight(properties._framesInFlight)
+{
+    VkDescriptorSetLayoutBinding binding{};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    binding.descriptorCount = _capacity;
+    binding.stageFlags = VK_SHADER_STAGE_ALL_GRAPHICS | VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorBindingFlags bindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+    bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    bindingFlagsInfo.bindingCount = 1;
+    bindingFlagsInfo.pBindingFlags = &bindingFlags;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.pNext = &bindingFlagsInfo;
+    layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings = &binding;
+
+    if (vkCreateDescriptorSetLayout(_logicalDevice, &layoutInfo, nullptr, &_descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create bindless descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSize.descriptorCount = _capacity;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+
+    if (vkCreateDescriptorPool(_logicalDevice, &poolInfo, nullptr, &_descriptorPool) != VK_SUCCESS) {
+        vkDestroyDescriptorSetLayout(_logicalDevice, _descriptorSetLayout, nullptr);
+        throw std::runtime_error("failed to create bindless descriptor pool!");
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = _descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &_descriptorSetLayout;
+
+    if (vkAllocateDescriptorSets(_logicalDevice, &allocInfo, &_descriptorSet) != VK_SUCCESS) {
+        vkDestroyDescriptorPool(_logicalDevice, _descriptorPool, nullptr);
+        vkDestroyDescriptorSetLayout(_logicalDevice, _descriptorSetLayout, nullptr);
+        throw std::runtime_error("failed to allocate bindless descriptor set!");
+    }
+}
+
+maverik::BindlessTextureTable::~BindlessTextureTable()
+{
+    vkDestroyDescriptorPool(_logicalDevice, _descriptorPool, nullptr);
+    vkDestroyDescriptorSetLayout(_logicalDevice, _descriptorSetLayout, nullptr);
+}
+
+uint32_t maverik::BindlessTextureTable::registerTexture(VkImageView imageView, VkSampler sampler)
+{
+    uint32_t slot;
+
+    // Slots are released in frame order, only the oldest one can be out of use
+    if (!_freeSlots.empty() && _freeSlots.front()._reuseFrame <= _frame) {
+        slot = _freeSlots.front()._slot;
+        _freeSlots.pop_front();
+    } else if (_nextSlot < _capacity) {
+        slot = _nextSlot++;
+    } else {
+        throw std::runtime_error("bindless texture table is full!");
+    }
+    this->updateTexture(slot, imageView, sampler);
+    return slot;
+}
+
+void maverik::BindlessTextureTable::updateTexture(uint32_t slot, VkImageView imageView, VkSampler sampler)
+{
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfo.imageView = imageView;
+    imageInfo.sampler = sampler;
+
+    VkWriteDescriptorSet descriptorWrite{};
+    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.dstSet = _descriptorSet;
+    descriptorWrite.dstBinding = 0;
+    descriptorWrite.dstArrayElement = slot;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pImageInfo = &imageInfo;
+
+    vkUpdateDescriptorSets(_logicalDevice, 1, &descriptorWrite, 0, nullptr);
+}
+
+void maverik::BindlessTextureTable::unregisterTexture(uint32_t slot)
+{
+    _freeSlots.push_back({slot, _frame + _framesInFlight});
+}
+
+void maverik::BindlessTextureTable::beginFrame()
+{
+    _frame++;
+}
@@ -0,0 +1,117 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** CommandAllocator
+*/
+
+#include "CommandAllocator.hpp"
+
+#include <limits>
+
+/*
+ * Number of command buffers allocated at once when a frame pool runs dry.
+ */
+static constexpr uint32_t COMMAND_BUFFER_BATCH_SIZE = 8;
+
+////////////////////
+// Public methods //
+////////////////////
+
+maverik::CommandAllocator::CommandAllocator(const CommandAllocatorCreationProperties& properties)
+    : _logicalDevice(properties._logicalDevice)
+{
+    _framePools.resize(properties._framesInFlight);
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = properties._queueFamilyIndex;
+
+    for (auto& framePool : _framePools) {
+        if (vkCreateCommandPool(_logicalDevice, &poolInfo, nullptr, &framePool._commandPool) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create transient command pool!");
+        }
+    }
+
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    if (vkCreateCommandPool(_logicalDevice, &poolInfo, nullptr, &_immediatePool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create transient command pool!");
+    }
+}
+
+maverik::CommandAllocator::~CommandAllocator()
+{
+    for (auto& framePool : _framePools) {
+        if (framePool._commandPool != VK_NULL_HANDLE) {
+            vkDestroyCommandPool(_logicalDevice, framePool._commandPool, nullptr);
+        }
+    }
+    if (_immediatePool != VK_NULL_HANDLE) {
+        vkDestroyCommandPool(_logicalDevice, _immediatePool, nullptr);
+    }
+}
+
+VkCommandBuffer maverik::CommandAllocator::allocate()
+{
+    FramePool& framePool = _framePools[_currentFrame];
+
+    if (framePool._nextIndex == framePool._commandBuffers.size()) {
+        size_t previousSize = framePool._commandBuffers.size();
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = framePool._commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = COMMAND_BUFFER_BATCH_SIZE;
+
+        framePool._commandBuffers.resize(previousSize + COMMAND_BUFFER_BATCH_SIZE);
+        if (vkAllocateCommandBuffers(_logicalDevice, &allocInfo, framePool._commandBuffers.data() + previousSize) != VK_SUCCESS) {
+            framePool._commandBuffers.resize(previousSize);
+            throw std::runtime_error("Failed to allocate transient command buffers!");
+        }
+    }
+    return framePool._commandBuffers[framePool._nextIndex++];
+}
+
+VkCommandBuffer maverik::CommandAllocator::allocateImmediate()
+{
+    VkCommandBuffer commandBuffer;
+
+    if (!_immediateBuffers.empty()) {
+        commandBuffer = _immediateBuffers.back();
+        _immediateBuffers.pop_back();
+        return commandBuffer;
+    }
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = _immediatePool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+
+    if (vkAllocateCommandBuffers(_logicalDevice, &allocInfo, &commandBuffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate transient command buffers!");
+    }
+    return commandBuffer;
+}
+
+void maverik::CommandAllocator::recycle(VkCommandBuffer commandBuffer)
+{
+    vkResetCommandBuffer(commandBuffer, 0);
+    _immediateBuffers.push_back(commandBuffer);
+}
+
+void maverik::CommandAllocator::beginFrame(uint32_t frameIndex, VkFence fence)
+{
+    FramePool& framePool = _framePools[frameIndex];
+
+    if (fence != VK_NULL_HANDLE) {
+        vkWaitForFences(_logicalDevice, 1, &fence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+    }
+
+    // Command buffers keep their allocation, only their memory is recycled
+    vkResetCommandPool(_logicalDevice, framePool._commandPool, 0);
+    framePool._nextIndex = 0;
+    _currentFrame = frameIndex;
+}
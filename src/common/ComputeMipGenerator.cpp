@@ -0,0 +1,360 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** ComputeMipGenerator
+*/
+
+#include "ComputeMipGenerator.hpp"
+
+#include <array>
+#include <memory>
+#include <cstring>
+#include <algorithm>
+#include <filesystem>
+
+/*
+ * Maximum number of dispatches of a generation: images above 4096 texels only get
+ * 6 levels per dispatch, so that the last workgroup never reduces more than 64x64 texels.
+ */
+static constexpr uint32_t MAX_DISPATCHES_PER_GENERATION = 4;
+static constexpr uint32_t SINGLE_GROUP_MAX_SIZE = 4096;
+static constexpr uint32_t TILE_SIZE = 64;
+
+/*
+ * Push constants of shaders/mipgen.comp.
+ */
+struct MipGenerationParams {
+    uint32_t _baseWidth;
+    uint32_t _baseHeight;
+    uint32_t _levelCount;
+    uint32_t _srgb;
+    uint32_t _alphaWeighted;
+};
+
+static const char *getShaderSuffix(VkFormat storageFormat)
+{
+    switch (storageFormat) {
+        case VK_FORMAT_R8G8B8A8_UNORM:
+            return "rgba8";
+        case VK_FORMAT_R16G16B16A16_SFLOAT:
+            return "rgba16f";
+        case VK_FORMAT_R32G32B32A32_SFLOAT:
+            return "rgba32f";
+        default:
+            return nullptr;
+    }
+}
+
+////////////////////
+// Public methods //
+////////////////////
+
+maverik::ComputeMipGenerator::ComputeMipGenerator(const ComputeMipGeneratorCreationProperties& properties)
+    : _properties(properties)
+{
+    std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    bindings[1].descriptorCount = MAX_LEVELS_PER_DISPATCH;
+    bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    bindings[2].binding = 2;
+    bindings[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[2].descriptorCount = 1;
+    bindings[2].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(_properties._logicalDevice, &layoutInfo, nullptr, &_descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create mip generation descriptor set layout!");
+    }
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(MipGenerationParams);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &_descriptorSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(_properties._logicalDevice, &pipelineLayoutInfo, nullptr, &_pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create mip generation pipeline layout!");
+    }
+
+    uint32_t maxSets = _properties._maxPendingGenerations * MAX_DISPATCHES_PER_GENERATION;
+    std::array<VkDescriptorPoolSize, 2> poolSizes{};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    poolSizes[0].descriptorCount = maxSets * (MAX_LEVELS_PER_DISPATCH + 1);
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[1].descriptorCount = maxSets;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    poolInfo.maxSets = maxSets;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+
+    if (vkCreateDescriptorPool(_properties._logicalDevice, &poolInfo, nullptr, &_descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create mip generation descriptor pool!");
+    }
+
+    // The shader resets the counter after each use, it only has to start at zero
+    Utils::CreateBufferProperties counterBufferProperties = {
+        ._logicalDevice = _properties._logicalDevice,
+        ._physicalDevice = _properties._physicalDevice,
+        ._size = sizeof(uint32_t),
+        ._usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        ._properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        ._buffer = _counterBuffer,
+        ._bufferMemory = _counterBufferMemory
+    };
+    Utils::createBuffer(counterBufferProperties);
+
+    void *data;
+    vkMapMemory(_properties._logicalDevice, _counterBufferMemory, 0, sizeof(uint32_t), 0, &data);
+        std::memset(data, 0, sizeof(uint32_t));
+    vkUnmapMemory(_properties._logicalDevice, _counterBufferMemory);
+}
+
+maverik::ComputeMipGenerator::~ComputeMipGenerator()
+{
+    for (const auto& [format, pipeline] : _pipelines) {
+        vkDestroyPipeline(_properties._logicalDevice, pipeline, nullptr);
+    }
+    vkDestroyBuffer(_properties._logicalDevice, _counterBuffer, nullptr);
+    vkFreeMemory(_properties._logicalDevice, _counterBufferMemory, nullptr);
+    vkDestroyDescriptorPool(_properties._logicalDevice, _descriptorPool, nullptr);
+    vkDestroyPipelineLayout(_properties._logicalDevice, _pipelineLayout, nullptr);
+    vkDestroyDescriptorSetLayout(_properties._logicalDevice, _descriptorSetLayout, nullptr);
+}
+
+VkFormat maverik::ComputeMipGenerator::getStorageFormat(VkFormat format)
+{
+    switch (format) {
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+            return VK_FORMAT_R8G8B8A8_UNORM;
+        case VK_FORMAT_R16G16B16A16_SFLOAT:
+        case VK_FORMAT_R32G32B32A32_SFLOAT:
+            return format;
+        default:
+            return VK_FORMAT_UNDEFINED;
+    }
+}
+
+bool maverik::ComputeMipGenerator::isFormatSupported(VkPhysicalDevice physicalDevice, VkFormat format)
+{
+    VkFormat storageFormat = getStorageFormat(format);
+
+    if (storageFormat == VK_FORMAT_UNDEFINED) {
+        return false;
+    }
+
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, storageFormat, &formatProperties);
+    return (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) != 0;
+}
+
+bool maverik::ComputeMipGenerator::hasShaders(const std::string& shaderDirectory)
+{
+    for (VkFormat storageFormat : {VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_R16G16B16A16_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT}) {
+        if (!std::filesystem::exists(shaderDirectory + "/mipgen_" + getShaderSuffix(storageFormat) + ".spv")) {
+            return false;
+        }
+    }
+    return true;
+}
+
+maverik::ComputeMipGenerator::Generation maverik::ComputeMipGenerator::record(VkCommandBuffer commandBuffer, const MipGenerationProperties& properties)
+{
+    VkFormat storageFormat = getStorageFormat(properties._format);
+    Generation generation;
+
+    if (storageFormat == VK_FORMAT_UNDEFINED) {
+        throw std::runtime_error("Mip generation does not support this image format !");
+    }
+
+    std::unique_ptr<ResourceStateTracker> localTracker;
+    ResourceStateTracker *tracker = properties._resourceStateTracker;
+    if (tracker == nullptr) {
+        localTracker = std::make_unique<ResourceStateTracker>(_properties._logicalDevice, false);
+        tracker = localTracker.get();
+        tracker->registerImage(properties._image, VK_IMAGE_ASPECT_COLOR_BIT, properties._mipLevels, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    }
+    tracker->require(properties._image, ResourceStateTracker::Usage::COMPUTE_SHADER_WRITE);
+    tracker->flush(commandBuffer);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, this->getPipeline(storageFormat));
+
+    for (uint32_t baseLevel = 0; baseLevel + 1 < properties._mipLevels;) {
+        uint32_t width = std::max(properties._width >> baseLevel, 1u);
+        uint32_t height = std::max(properties._height >> baseLevel, 1u);
+        uint32_t levelCount = std::min(properties._mipLevels - 1 - baseLevel, MAX_LEVELS_PER_DISPATCH);
+
+        if (std::max(width, height) > SINGLE_GROUP_MAX_SIZE) {
+            levelCount = std::min(levelCount, MAX_LEVELS_PER_DISPATCH / 2);
+        }
+        if (generation._descriptorSets.size() == MAX_DISPATCHES_PER_GENERATION) {
+            this->release(generation);
+            throw std::runtime_error("Image is too large for compute mip generation !");
+        }
+
+        VkDescriptorSet descriptorSet;
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = _descriptorPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &_descriptorSetLayout;
+        if (vkAllocateDescriptorSets(_properties._logicalDevice, &allocInfo, &descriptorSet) != VK_SUCCESS) {
+            this->release(generation);
+            throw std::runtime_error("No descriptor set left for mip generation, release completed generations first !");
+        }
+        generation._descriptorSets.push_back(descriptorSet);
+
+        // Destination slots past the last generated level are never written, they repeat the last view
+        std::array<VkDescriptorImageInfo, MAX_LEVELS_PER_DISPATCH + 1> imageInfos{};
+        for (uint32_t i = 0; i <= levelCount; i++) {
+            generation._views.push_back(this->createLevelView(properties._image, storageFormat, baseLevel + i));
+            imageInfos[i].imageView = generation._views.back();
+            imageInfos[i].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        }
+        for (uint32_t i = levelCount + 1; i < imageInfos.size(); i++) {
+            imageInfos[i] = imageInfos[levelCount];
+        }
+
+        VkDescriptorBufferInfo counterInfo{};
+        counterInfo.buffer = _counterBuffer;
+        counterInfo.offset = 0;
+        counterInfo.range = sizeof(uint32_t);
+
+        std::array<VkWriteDescriptorSet, 3> descriptorWrites{};
+        descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[0].dstSet = descriptorSet;
+        descriptorWrites[0].dstBinding = 0;
+        descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        descriptorWrites[0].descriptorCount = 1;
+        descriptorWrites[0].pImageInfo = &imageInfos[0];
+        descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[1].dstSet = descriptorSet;
+        descriptorWrites[1].dstBinding = 1;
+        descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        descriptorWrites[1].descriptorCount = MAX_LEVELS_PER_DISPATCH;
+        descriptorWrites[1].pImageInfo = &imageInfos[1];
+        descriptorWrites[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[2].dstSet = descriptorSet;
+        descriptorWrites[2].dstBinding = 2;
+        descriptorWrites[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptorWrites[2].descriptorCount = 1;
+        descriptorWrites[2].pBufferInfo = &counterInfo;
+        vkUpdateDescriptorSets(_properties._logicalDevice, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+
+        // Orders this dispatch after the previous one, which wrote its source level and the counter
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+            1, &barrier,
+            0, nullptr,
+            0, nullptr);
+
+        MipGenerationParams params = {
+            ._baseWidth = width,
+            ._baseHeight = height,
+            ._levelCount = levelCount,
+            ._srgb = properties._format == VK_FORMAT_R8G8B8A8_SRGB ? 1u : 0u,
+            ._alphaWeighted = properties._alphaWeighted ? 1u : 0u
+        };
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _pipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+        vkCmdPushConstants(commandBuffer, _pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+        vkCmdDispatch(commandBuffer, (width + TILE_SIZE - 1) / TILE_SIZE, (height + TILE_SIZE - 1) / TILE_SIZE, 1);
+
+        baseLevel += levelCount;
+    }
+
+    tracker->require(properties._image, ResourceStateTracker::Usage::FRAGMENT_SHADER_READ);
+    tracker->flush(commandBuffer);
+    return generation;
+}
+
+void maverik::ComputeMipGenerator::release(const Generation& generation)
+{
+    for (VkImageView view : generation._views) {
+        vkDestroyImageView(_properties._logicalDevice, view, nullptr);
+    }
+    if (!generation._descriptorSets.empty()) {
+        vkFreeDescriptorSets(_properties._logicalDevice, _descriptorPool, static_cast<uint32_t>(generation._descriptorSets.size()), generation._descriptorSets.data());
+    }
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+VkPipeline maverik::ComputeMipGenerator::getPipeline(VkFormat storageFormat)
+{
+    auto it = _pipelines.find(storageFormat);
+
+    if (it != _pipelines.end()) {
+        return it->second;
+    }
+
+    auto shaderCode = Utils::readFile(_properties._shaderDirectory + "/mipgen_" + getShaderSuffix(storageFormat) + ".spv");
+    VkShaderModule shaderModule = Utils::createShaderModule(_properties._logicalDevice, shaderCode);
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = shaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = _pipelineLayout;
+
+    VkPipeline pipeline;
+    VkResult result = vkCreateComputePipelines(_properties._logicalDevice, _properties._pipelineCache, 1, &pipelineInfo, nullptr, &pipeline);
+    vkDestroyShaderModule(_properties._logicalDevice, shaderModule, nullptr);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("failed to create mip generation pipeline!");
+    }
+
+    _pipelines[storageFormat] = pipeline;
+    return pipeline;
+}
+
+VkImageView maverik::ComputeMipGenerator::createLevelView(VkImage image, VkFormat format, uint32_t level)
+{
+    VkImageViewUsageCreateInfo usageInfo{};
+    usageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO;
+    usageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT;
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.pNext = &usageInfo;
+    viewInfo.image = image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = format;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel = level;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    VkImageView imageView;
+    if (vkCreateImageView(_properties._logicalDevice, &viewInfo, nullptr, &imageView) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create mip level image view!");
+    }
+    return imageView;
+}
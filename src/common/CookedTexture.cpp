@@ -0,0 +1,269 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** CookedTexture
+*/
+
+#include "CookedTexture.hpp"
+
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+static constexpr char COOKED_MAGIC[4] = {'M', 'V', 'K', 'T'};
+static constexpr uint32_t COOKED_VERSION = 1;
+static constexpr size_t COOKED_HEADER_SIZE = 24;
+static constexpr size_t COOKED_LEVEL_ENTRY_SIZE = 24;
+
+template <typename T>
+static T readField(const char *data, size_t offset)
+{
+    T value;
+
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+/*
+ * Size in bytes of a block of texels, and its width and height, of the formats a
+ * cooked texture may hold. Uncompressed formats have 1x1 blocks.
+ */
+static bool getTexelBlock(uint32_t format, uint32_t& blockWidth, uint32_t& blockHeight, uint32_t& blockBytes)
+{
+    blockWidth = 1;
+    blockHeight = 1;
+    if (format == 9 || format == 15) {              // R8
+        blockBytes = 1;
+    } else if (format == 16 || format == 22) {      // R8G8
+        blockBytes = 2;
+    } else if (format >= 37 && format <= 50) {      // R8G8B8A8 and B8G8R8A8
+        blockBytes = 4;
+    } else if (format >= 70 && format <= 76) {      // R16
+        blockBytes = 2;
+    } else if (format >= 77 && format <= 83) {      // R16G16
+        blockBytes = 4;
+    } else if (format >= 91 && format <= 97) {      // R16G16B16A16
+        blockBytes = 8;
+    } else if (format >= 98 && format <= 100) {     // R32
+        blockBytes = 4;
+    } else if (format >= 101 && format <= 103) {    // R32G32
+        blockBytes = 8;
+    } else if (format >= 107 && format <= 109) {    // R32G32B32A32
+        blockBytes = 16;
+    } else if (format >= 131 && format <= 146) {    // BC1 to BC7
+        blockWidth = 4;
+        blockHeight = 4;
+        blockBytes = (format <= 134 || format == 139 || format == 140) ? 8 : 16;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+template <typename T>
+static void writeField(std::vector<char>& data, size_t offset, T value)
+{
+    std::memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+////////////////////
+// Public methods //
+////////////////////
+
+maverik::CookedTexture::CookedTexture(const std::string& path)
+{
+#ifdef _WIN32
+    _fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (_fileHandle == INVALID_HANDLE_VALUE) {
+        _fileHandle = nullptr;
+        throw std::runtime_error("Failed to open cooked texture: " + path);
+    }
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(_fileHandle, &fileSize);
+    _size = static_cast<size_t>(fileSize.QuadPart);
+    _mappingHandle = CreateFileMappingA(_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (_mappingHandle == nullptr) {
+        this->unmap();
+        throw std::runtime_error("Failed to map cooked texture: " + path);
+    }
+    _data = static_cast<const char *>(MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat fileStat;
+
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open cooked texture: " + path);
+    }
+    if (fstat(fd, &fileStat) != 0) {
+        close(fd);
+        throw std::runtime_error("Failed to stat cooked texture: " + path);
+    }
+    _size = static_cast<size_t>(fileStat.st_size);
+    void *mapping = _size > 0 ? mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    _data = mapping == MAP_FAILED ? nullptr : static_cast<const char *>(mapping);
+#endif
+    if (_data == nullptr) {
+        this->unmap();
+        throw std::runtime_error("Failed to map cooked texture: " + path);
+    }
+
+    this->parse(path);
+}
+
+maverik::CookedTexture::CookedTexture(std::shared_ptr<FileAsset> asset, const std::string& name)
+    : _asset(std::move(asset))
+{
+    if (_asset == nullptr) {
+        throw std::runtime_error("No asset to read cooked texture from: " + name);
+    }
+    _data = _asset->content().data();
+    _size = _asset->content().size();
+    this->parse(name);
+}
+
+maverik::CookedTexture::~CookedTexture()
+{
+    this->unmap();
+}
+
+void maverik::CookedTexture::write(const std::string& path, uint32_t format, const std::vector<MipGenerator::MipLevel>& levels)
+{
+    if (levels.empty()) {
+        throw std::runtime_error("Cannot cook a texture without levels: " + path);
+    }
+
+    size_t tableEnd = COOKED_HEADER_SIZE + levels.size() * COOKED_LEVEL_ENTRY_SIZE;
+    uint64_t offset = (tableEnd + PAGE_ALIGNMENT - 1) / PAGE_ALIGNMENT * PAGE_ALIGNMENT;
+    std::vector<char> header(static_cast<size_t>(offset), 0);
+
+    std::memcpy(header.data(), COOKED_MAGIC, sizeof(COOKED_MAGIC));
+    writeField<uint32_t>(header, 4, COOKED_VERSION);
+    writeField<uint32_t>(header, 8, format);
+    writeField<uint32_t>(header, 12, levels.front()._width);
+    writeField<uint32_t>(header, 16, levels.front()._height);
+    writeField<uint32_t>(header, 20, static_cast<uint32_t>(levels.size()));
+
+    for (size_t i = 0; i < levels.size(); i++) {
+        size_t entryOffset = COOKED_HEADER_SIZE + i * COOKED_LEVEL_ENTRY_SIZE;
+
+        writeField<uint64_t>(header, entryOffset, offset);
+        writeField<uint64_t>(header, entryOffset + 8, levels[i]._pixels.size());
+        writeField<uint32_t>(header, entryOffset + 16, levels[i]._width);
+        writeField<uint32_t>(header, entryOffset + 20, levels[i]._height);
+        offset = (offset + levels[i]._pixels.size() + PAGE_ALIGNMENT - 1) / PAGE_ALIGNMENT * PAGE_ALIGNMENT;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file for writing: " + path);
+    }
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    std::vector<char> padding(PAGE_ALIGNMENT, 0);
+    for (const auto& level : levels) {
+        file.write(reinterpret_cast<const char *>(level._pixels.data()), static_cast<std::streamsize>(level._pixels.size()));
+        size_t remainder = level._pixels.size() % PAGE_ALIGNMENT;
+        if (remainder != 0) {
+            file.write(padding.data(), static_cast<std::streamsize>(PAGE_ALIGNMENT - remainder));
+        }
+    }
+    if (!file.good()) {
+        throw std::runtime_error("Failed to write cooked texture: " + path);
+    }
+}
+
+bool maverik::CookedTexture::isCookedPath(const std::string& path)
+{
+    static const std::string extension = ".mvktex";
+
+    return path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+void maverik::CookedTexture::parse(const std::string& name)
+{
+    if (_size < COOKED_HEADER_SIZE || std::memcmp(_data, COOKED_MAGIC, sizeof(COOKED_MAGIC)) != 0 || readField<uint32_t>(_data, 4) != COOKED_VERSION) {
+        this->unmap();
+        throw std::runtime_error("Not a cooked texture or unsupported version: " + name);
+    }
+
+    _format = readField<uint32_t>(_data, 8);
+    uint32_t levelCount = readField<uint32_t>(_data, 20);
+
+    if (levelCount == 0 || _size < COOKED_HEADER_SIZE + levelCount * COOKED_LEVEL_ENTRY_SIZE) {
+        this->unmap();
+        throw std::runtime_error("Truncated cooked texture: " + name);
+    }
+    uint32_t blockWidth;
+    uint32_t blockHeight;
+    uint32_t blockBytes;
+
+    if (!getTexelBlock(_format, blockWidth, blockHeight, blockBytes)) {
+        this->unmap();
+        throw std::runtime_error("Unsupported cooked texture format " + std::to_string(_format) + ": " + name);
+    }
+    _levels.resize(levelCount);
+    for (uint32_t i = 0; i < levelCount; i++) {
+        size_t entryOffset = COOKED_HEADER_SIZE + i * COOKED_LEVEL_ENTRY_SIZE;
+
+        _levels[i]._offset = readField<uint64_t>(_data, entryOffset);
+        _levels[i]._size = readField<uint64_t>(_data, entryOffset + 8);
+        _levels[i]._width = readField<uint32_t>(_data, entryOffset + 16);
+        _levels[i]._height = readField<uint32_t>(_data, entryOffset + 20);
+        // Compared without adding, so a huge offset cannot wrap around into the file
+        if (_levels[i]._size > _size || _levels[i]._offset > _size - _levels[i]._size) {
+            this->unmap();
+            throw std::runtime_error("Cooked texture level " + std::to_string(i) + " lies outside of the file: " + name);
+        }
+
+        // The level is copied to staging as-is, its size must be exactly the one of its extent
+        uint64_t blocksX = (static_cast<uint64_t>(_levels[i]._width) + blockWidth - 1) / blockWidth;
+        uint64_t blocksY = (static_cast<uint64_t>(_levels[i]._height) + blockHeight - 1) / blockHeight;
+        if (blocksX == 0 || blocksY == 0 || blocksX > _levels[i]._size / blockBytes / blocksY
+            || blocksX * blocksY * blockBytes != _levels[i]._size) {
+            this->unmap();
+            throw std::runtime_error("Cooked texture level " + std::to_string(i) + " size does not match its extent: " + name);
+        }
+    }
+}
+
+void maverik::CookedTexture::unmap()
+{
+    // The content of an asset belongs to the asset, it is released with it
+    if (_asset != nullptr) {
+        _asset.reset();
+        _data = nullptr;
+        return;
+    }
+#ifdef _WIN32
+    if (_data != nullptr) {
+        UnmapViewOfFile(_data);
+    }
+    if (_mappingHandle != nullptr) {
+        CloseHandle(_mappingHandle);
+    }
+    if (_fileHandle != nullptr && _fileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(_fileHandle);
+    }
+    _mappingHandle = nullptr;
+    _fileHandle = nullptr;
+#else
+    if (_data != nullptr) {
+        munmap(const_cast<char *>(_data), _size);
+    }
+#endif
+    _data = nullptr;
+}
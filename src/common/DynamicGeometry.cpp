@@ -0,0 +1,148 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** DynamicGeometry
+*/
+
+#include "DynamicGeometry.hpp"
+
+#include <cstring>
+#include <algorithm>
+
+////////////////////
+// Public methods //
+////////////////////
+
+maverik::DynamicGeometry::DynamicGeometry(const DynamicGeometryCreationProperties& properties)
+    : _properties(properties)
+{
+    if (_properties._framesInFlight == 0) {
+        throw std::runtime_error("Dynamic geometry needs at least one frame in flight !");
+    }
+    // Partitions start aligned, so a frame gets its whole capacity at the default alignment
+    _ring = this->createRing((std::max<VkDeviceSize>(_properties._frameCapacity, 1) + DEFAULT_ALIGNMENT - 1) & ~(DEFAULT_ALIGNMENT - 1));
+}
+
+maverik::DynamicGeometry::~DynamicGeometry()
+{
+    for (RetiredRing& retired : _retiredRings) {
+        this->destroyRing(retired._ring);
+    }
+    this->destroyRing(_ring);
+}
+
+void maverik::DynamicGeometry::beginFrame(uint32_t frameIndex)
+{
+    _frameIndex = frameIndex % _properties._framesInFlight;
+    _frameOffset = 0;
+
+    // Rings retired framesInFlight frames ago were last read by the frame just waited for
+    for (RetiredRing& retired : _retiredRings) {
+        if (--retired._framesLeft == 0) {
+            this->destroyRing(retired._ring);
+        }
+    }
+    std::erase_if(_retiredRings, [](const RetiredRing& retired) {
+        return retired._framesLeft == 0;
+    });
+}
+
+maverik::DynamicBufferRange maverik::DynamicGeometry::allocate(VkDeviceSize size, VkDeviceSize alignment)
+{
+    auto align = [alignment](VkDeviceSize offset) {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    };
+    VkDeviceSize partition = _frameIndex * _ring._frameCapacity;
+    VkDeviceSize offset = align(partition + _frameOffset);
+
+    if (offset + size > partition + _ring._frameCapacity) {
+        VkDeviceSize frameCapacity = _ring._frameCapacity * 2;
+        while (frameCapacity < size + alignment) {
+            frameCapacity *= 2;
+        }
+        // Ranges handed out earlier this frame keep pointing to the previous ring
+        _retiredRings.push_back({_ring, _properties._framesInFlight});
+        _ring = this->createRing(frameCapacity);
+        partition = _frameIndex * _ring._frameCapacity;
+        offset = align(partition);
+    }
+    _frameOffset = offset + size - partition;
+    return {_ring._buffer, offset, size, _ring._mapped + offset};
+}
+
+maverik::DynamicBufferRange maverik::DynamicGeometry::write(const void *data, VkDeviceSize size, VkDeviceSize alignment)
+{
+    DynamicBufferRange range = this->allocate(size, alignment);
+
+    memcpy(range._data, data, static_cast<size_t>(size));
+    return range;
+}
+
+void maverik::DynamicGeometry::bindVertexBuffer(VkCommandBuffer commandBuffer, uint32_t binding, const DynamicBufferRange& range)
+{
+    vkCmdBindVertexBuffers(commandBuffer, binding, 1, &range._buffer, &range._offset);
+}
+
+void maverik::DynamicGeometry::bindIndexBuffer(VkCommandBuffer commandBuffer, const DynamicBufferRange& range, VkIndexType indexType)
+{
+    vkCmdBindIndexBuffer(commandBuffer, range._buffer, range._offset, indexType);
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+maverik::DynamicGeometry::Ring maverik::DynamicGeometry::createRing(VkDeviceSize frameCapacity) const
+{
+    Ring ring;
+    VkDeviceSize size = frameCapacity * _properties._framesInFlight;
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateBuffer(_properties._logicalDevice, &bufferInfo, nullptr, &ring._buffer) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create dynamic geometry buffer !");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(_properties._logicalDevice, ring._buffer, &memRequirements);
+
+    // Device-local memory spares the GPU reads over the bus, host-visible memory is the fallback
+    uint32_t memoryTypeIndex;
+    if (!Utils::findDirectWriteMemoryType(_properties._physicalDevice, memRequirements.memoryTypeBits, size, memoryTypeIndex)) {
+        memoryTypeIndex = Utils::findMemoryType(_properties._physicalDevice, memRequirements.memoryTypeBits,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    }
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    if (vkAllocateMemory(_properties._logicalDevice, &allocInfo, nullptr, &ring._memory) != VK_SUCCESS) {
+        vkDestroyBuffer(_properties._logicalDevice, ring._buffer, nullptr);
+        throw std::runtime_error("failed to allocate dynamic geometry memory !");
+    }
+    vkBindBufferMemory(_properties._logicalDevice, ring._buffer, ring._memory, 0);
+
+    void *mapped;
+    vkMapMemory(_properties._logicalDevice, ring._memory, 0, VK_WHOLE_SIZE, 0, &mapped);
+    ring._mapped = static_cast<char *>(mapped);
+    ring._frameCapacity = frameCapacity;
+    return ring;
+}
+
+void maverik::DynamicGeometry::destroyRing(Ring& ring) const
+{
+    if (ring._buffer == VK_NULL_HANDLE) {
+        return;
+    }
+    vkUnmapMemory(_properties._logicalDevice, ring._memory);
+    vkDestroyBuffer(_properties._logicalDevice, ring._buffer, nullptr);
+    vkFreeMemory(_properties._logicalDevice, ring._memory, nullptr);
+    ring = Ring{};
+}
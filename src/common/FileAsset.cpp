@@ -7,8 +7,8 @@
 
 #include "FileAsset.hpp"
 
-maverik::FileAsset::FileAsset(const std::string& content)
-    : _content(content)
+maverik::FileAsset::FileAsset(std::string content)
+    : _content(std::move(content))
 {
 }
 
@@ -0,0 +1,363 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** GeometryPool
+*/
+
+#include "GeometryPool.hpp"
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+////////////////////
+// Public methods //
+////////////////////
+
+maverik::RangeAllocator::RangeAllocator(uint32_t capacity)
+{
+    this->reset(capacity);
+}
+
+std::optional<uint32_t> maverik::RangeAllocator::allocate(uint32_t count)
+{
+    if (count == 0) {
+        return 0;
+    }
+    for (auto it = _freeBlocks.begin(); it != _freeBlocks.end(); ++it) {
+        if (it->second < count) {
+            continue;
+        }
+        uint32_t offset = it->first;
+        uint32_t remaining = it->second - count;
+        _freeBlocks.erase(it);
+        if (remaining > 0) {
+            _freeBlocks.emplace(offset + count, remaining);
+        }
+        _freeCount -= count;
+        return offset;
+    }
+    return std::nullopt;
+}
+
+void maverik::RangeAllocator::free(uint32_t offset, uint32_t count)
+{
+    if (count == 0) {
+        return;
+    }
+    auto it = _freeBlocks.emplace(offset, count).first;
+
+    auto next = std::next(it);
+    if (next != _freeBlocks.end() && it->first + it->second == next->first) {
+        it->second += next->second;
+        _freeBlocks.erase(next);
+    }
+    if (it != _freeBlocks.begin()) {
+        auto previous = std::prev(it);
+        if (previous->first + previous->second == it->first) {
+            previous->second += it->second;
+            _freeBlocks.erase(it);
+        }
+    }
+    _freeCount += count;
+}
+
+void maverik::RangeAllocator::reset(uint32_t capacity, uint32_t usedCount)
+{
+    _freeBlocks.clear();
+    _capacity = capacity;
+    _freeCount = capacity - std::min(usedCount, capacity);
+    if (_freeCount > 0) {
+        _freeBlocks.emplace(usedCount, _freeCount);
+    }
+}
+
+uint32_t maverik::RangeAllocator::getLargestFreeBlock() const
+{
+    uint32_t largest = 0;
+
+    for (const auto& [offset, count] : _freeBlocks) {
+        largest = std::max(largest, count);
+    }
+    return largest;
+}
+
+maverik::GeometryPool::GeometryPool(const GeometryPoolCreationProperties& properties)
+    : _properties(properties)
+{
+    _properties._vertexCapacity = std::max(_properties._vertexCapacity, 1u);
+    _properties._indexCapacity = std::max(_properties._indexCapacity, 1u);
+
+    _vertexBuffer = this->createBuffer(static_cast<VkDeviceSize>(_properties._vertexCapacity) * _properties._vertexStride, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+    _indexBuffer = this->createBuffer(static_cast<VkDeviceSize>(_properties._indexCapacity) * this->getIndexSize(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+    _vertexAllocator.reset(_properties._vertexCapacity);
+    _indexAllocator.reset(_properties._indexCapacity);
+}
+
+maverik::GeometryPool::~GeometryPool()
+{
+    this->destroyBuffer(_vertexBuffer);
+    this->destroyBuffer(_indexBuffer);
+}
+
+uint32_t maverik::GeometryPool::allocate(const void *vertices, uint32_t vertexCount, const std::vector<uint32_t>& indices)
+{
+    uint32_t indexCount = static_cast<uint32_t>(indices.size());
+
+    if (_properties._indexType == VK_INDEX_TYPE_UINT16 && MeshOptimizer::selectIndexType(vertexCount) != VK_INDEX_TYPE_UINT16) {
+        throw std::runtime_error("Mesh has too many vertices for a 16-bit index geometry pool !");
+    }
+
+    std::optional<uint32_t> firstVertex = _vertexAllocator.allocate(vertexCount);
+    std::optional<uint32_t> firstIndex = _indexAllocator.allocate(indexCount);
+    if (!firstVertex || !firstIndex) {
+        if (firstVertex) {
+            _vertexAllocator.free(*firstVertex, vertexCount);
+        }
+        if (firstIndex) {
+            _indexAllocator.free(*firstIndex, indexCount);
+        }
+        // Packing the live meshes leaves a single free block at the end of each buffer
+        uint32_t usedVertices = _vertexAllocator.getCapacity() - _vertexAllocator.getFreeCount();
+        uint32_t usedIndices = _indexAllocator.getCapacity() - _indexAllocator.getFreeCount();
+        this->relocate(std::max(_vertexAllocator.getCapacity() * 2, usedVertices + vertexCount),
+            std::max(_indexAllocator.getCapacity() * 2, usedIndices + indexCount));
+        firstVertex = _vertexAllocator.allocate(vertexCount);
+        firstIndex = _indexAllocator.allocate(indexCount);
+    }
+
+    this->upload(_vertexBuffer, static_cast<VkDeviceSize>(*firstVertex) * _properties._vertexStride, vertices,
+        static_cast<VkDeviceSize>(vertexCount) * _properties._vertexStride);
+    if (_properties._indexType == VK_INDEX_TYPE_UINT16) {
+        std::vector<uint16_t> narrowed = MeshOptimizer::narrowIndices(indices);
+        this->upload(_indexBuffer, static_cast<VkDeviceSize>(*firstIndex) * sizeof(uint16_t), narrowed.data(), narrowed.size() * sizeof(uint16_t));
+    } else {
+        this->upload(_indexBuffer, static_cast<VkDeviceSize>(*firstIndex) * sizeof(uint32_t), indices.data(), indices.size() * sizeof(uint32_t));
+    }
+
+    uint32_t mesh;
+    if (!_freeMeshes.empty()) {
+        mesh = _freeMeshes.back();
+        _freeMeshes.pop_back();
+    } else {
+        mesh = static_cast<uint32_t>(_allocations.size());
+        _allocations.emplace_back();
+    }
+    _allocations[mesh] = {*firstVertex, vertexCount, *firstIndex, indexCount, true};
+    return mesh;
+}
+
+void maverik::GeometryPool::free(uint32_t mesh)
+{
+    if (mesh >= _allocations.size() || !_allocations[mesh]._live) {
+        throw std::runtime_error("Unknown geometry pool mesh !");
+    }
+    Allocation& allocation = _allocations[mesh];
+
+    _vertexAllocator.free(allocation._firstVertex, allocation._vertexCount);
+    _indexAllocator.free(allocation._firstIndex, allocation._indexCount);
+    allocation._live = false;
+    _freeMeshes.push_back(mesh);
+}
+
+maverik::MeshRange maverik::GeometryPool::getRange(uint32_t mesh) const
+{
+    if (mesh >= _allocations.size() || !_allocations[mesh]._live) {
+        throw std::runtime_error("Unknown geometry pool mesh !");
+    }
+    const Allocation& allocation = _allocations[mesh];
+
+    return {allocation._firstIndex, allocation._indexCount, static_cast<int32_t>(allocation._firstVertex)};
+}
+
+void maverik::GeometryPool::compact()
+{
+    this->relocate(_vertexAllocator.getCapacity(), _indexAllocator.getCapacity());
+}
+
+void maverik::GeometryPool::bind(VkCommandBuffer commandBuffer) const
+{
+    VkDeviceSize offset = 0;
+
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &_vertexBuffer._buffer, &offset);
+    vkCmdBindIndexBuffer(commandBuffer, _indexBuffer._buffer, 0, _properties._indexType);
+}
+
+float maverik::GeometryPool::getFragmentation() const
+{
+    auto fragmentation = [](const RangeAllocator& allocator) {
+        if (allocator.getFreeCount() == 0) {
+            return 0.0f;
+        }
+        return 1.0f - static_cast<float>(allocator.getLargestFreeBlock()) / static_cast<float>(allocator.getFreeCount());
+    };
+
+    return std::max(fragmentation(_vertexAllocator), fragmentation(_indexAllocator));
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+maverik::GeometryPool::PoolBuffer maverik::GeometryPool::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage) const
+{
+    PoolBuffer buffer;
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateBuffer(_properties._logicalDevice, &bufferInfo, nullptr, &buffer._buffer) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create geometry pool buffer !");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(_properties._logicalDevice, buffer._buffer, &memRequirements);
+
+    uint32_t memoryTypeIndex;
+    bool directWrite = Utils::findDirectWriteMemoryType(_properties._physicalDevice, memRequirements.memoryTypeBits, size, memoryTypeIndex);
+    if (!directWrite) {
+        memoryTypeIndex = Utils::findMemoryType(_properties._physicalDevice, memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    if (vkAllocateMemory(_properties._logicalDevice, &allocInfo, nullptr, &buffer._memory) != VK_SUCCESS) {
+        vkDestroyBuffer(_properties._logicalDevice, buffer._buffer, nullptr);
+        throw std::runtime_error("failed to allocate geometry pool buffer memory !");
+    }
+    vkBindBufferMemory(_properties._logicalDevice, buffer._buffer, buffer._memory, 0);
+
+    // Kept mapped for the lifetime of the buffer, coherent writes need no flush
+    if (directWrite) {
+        vkMapMemory(_properties._logicalDevice, buffer._memory, 0, size, 0, &buffer._mapped);
+    }
+    return buffer;
+}
+
+void maverik::GeometryPool::destroyBuffer(PoolBuffer& buffer) const
+{
+    if (buffer._mapped) {
+        vkUnmapMemory(_properties._logicalDevice, buffer._memory);
+    }
+    vkDestroyBuffer(_properties._logicalDevice, buffer._buffer, nullptr);
+    vkFreeMemory(_properties._logicalDevice, buffer._memory, nullptr);
+    buffer = PoolBuffer{};
+}
+
+void maverik::GeometryPool::upload(const PoolBuffer& buffer, VkDeviceSize offset, const void *data, VkDeviceSize size) const
+{
+    if (size == 0) {
+        return;
+    }
+    if (buffer._mapped) {
+        memcpy(static_cast<char *>(buffer._mapped) + offset, data, static_cast<size_t>(size));
+        return;
+    }
+
+    VkBuffer stagingBuffer;
+    VkDeviceMemory stagingBufferMemory;
+    Utils::CreateBufferProperties stagingBufferProperties = {
+        ._logicalDevice = _properties._logicalDevice,
+        ._physicalDevice = _properties._physicalDevice,
+        ._size = size,
+        ._usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        ._properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        ._buffer = stagingBuffer,
+        ._bufferMemory = stagingBufferMemory
+    };
+    Utils::createBuffer(stagingBufferProperties);
+
+    void *mapped;
+    vkMapMemory(_properties._logicalDevice, stagingBufferMemory, 0, size, 0, &mapped);
+        memcpy(mapped, data, static_cast<size_t>(size));
+    vkUnmapMemory(_properties._logicalDevice, stagingBufferMemory);
+
+    VkBufferCopy region{};
+    region.dstOffset = offset;
+    region.size = size;
+    Utils::CopyBufferProperties copyBufferProperties = {
+        ._logicalDevice = _properties._logicalDevice,
+        ._commandPool = _properties._commandPool,
+        ._graphicsQueue = _properties._graphicsQueue,
+        ._srcBuffer = stagingBuffer,
+        ._dstBuffer = buffer._buffer,
+        ._size = size,
+        ._commandAllocator = _properties._commandAllocator,
+        ._regions = {region}
+    };
+    Utils::copyBuffer(copyBufferProperties);
+
+    vkDestroyBuffer(_properties._logicalDevice, stagingBuffer, nullptr);
+    vkFreeMemory(_properties._logicalDevice, stagingBufferMemory, nullptr);
+}
+
+void maverik::GeometryPool::relocate(uint32_t vertexCapacity, uint32_t indexCapacity)
+{
+    PoolBuffer vertexBuffer = this->createBuffer(static_cast<VkDeviceSize>(vertexCapacity) * _properties._vertexStride, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+    PoolBuffer indexBuffer = this->createBuffer(static_cast<VkDeviceSize>(indexCapacity) * this->getIndexSize(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+    std::vector<VkBufferCopy> vertexRegions;
+    std::vector<VkBufferCopy> indexRegions;
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+
+    // Live meshes are packed in identifier order, one copy region each
+    for (Allocation& allocation : _allocations) {
+        if (!allocation._live) {
+            continue;
+        }
+        if (allocation._vertexCount > 0) {
+            vertexRegions.push_back({
+                static_cast<VkDeviceSize>(allocation._firstVertex) * _properties._vertexStride,
+                static_cast<VkDeviceSize>(vertexCount) * _properties._vertexStride,
+                static_cast<VkDeviceSize>(allocation._vertexCount) * _properties._vertexStride
+            });
+        }
+        if (allocation._indexCount > 0) {
+            indexRegions.push_back({
+                static_cast<VkDeviceSize>(allocation._firstIndex) * this->getIndexSize(),
+                static_cast<VkDeviceSize>(indexCount) * this->getIndexSize(),
+                static_cast<VkDeviceSize>(allocation._indexCount) * this->getIndexSize()
+            });
+        }
+        allocation._firstVertex = vertexCount;
+        allocation._firstIndex = indexCount;
+        vertexCount += allocation._vertexCount;
+        indexCount += allocation._indexCount;
+    }
+
+    // Copies run on the GPU, reading back from device-local memory is slow even when mapped
+    auto copy = [this](const PoolBuffer& source, const PoolBuffer& destination, std::vector<VkBufferCopy> regions) {
+        if (regions.empty()) {
+            return;
+        }
+        Utils::CopyBufferProperties copyBufferProperties = {
+            ._logicalDevice = _properties._logicalDevice,
+            ._commandPool = _properties._commandPool,
+            ._graphicsQueue = _properties._graphicsQueue,
+            ._srcBuffer = source._buffer,
+            ._dstBuffer = destination._buffer,
+            ._size = 0,
+            ._commandAllocator = _properties._commandAllocator,
+            ._regions = std::move(regions)
+        };
+        Utils::copyBuffer(copyBufferProperties);
+    };
+    copy(_vertexBuffer, vertexBuffer, std::move(vertexRegions));
+    copy(_indexBuffer, indexBuffer, std::move(indexRegions));
+
+    // Frames still in flight may draw from the previous buffers
+    vkDeviceWaitIdle(_properties._logicalDevice);
+    this->destroyBuffer(_vertexBuffer);
+    this->destroyBuffer(_indexBuffer);
+    _vertexBuffer = vertexBuffer;
+    _indexBuffer = indexBuffer;
+    _vertexAllocator.reset(vertexCapacity, vertexCount);
+    _indexAllocator.reset(indexCapacity, indexCount);
+}
@@ -0,0 +1,109 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** HostImageCopy
+*/
+
+#include "HostImageCopy.hpp"
+
+#include <algorithm>
+
+////////////////////
+// Public methods //
+////////////////////
+
+maverik::HostImageCopy::HostImageCopy(VkDevice logicalDevice, VkPhysicalDevice physicalDevice)
+    : _logicalDevice(logicalDevice), _physicalDevice(physicalDevice)
+{
+    _copyMemoryToImage = reinterpret_cast<PFN_vkCopyMemoryToImageEXT>(vkGetDeviceProcAddr(logicalDevice, "vkCopyMemoryToImageEXT"));
+    _transitionImageLayout = reinterpret_cast<PFN_vkTransitionImageLayoutEXT>(vkGetDeviceProcAddr(logicalDevice, "vkTransitionImageLayoutEXT"));
+    if (_copyMemoryToImage == nullptr || _transitionImageLayout == nullptr) {
+        throw std::runtime_error("Failed to load the host image copy entry points !");
+    }
+
+    VkPhysicalDeviceHostImageCopyPropertiesEXT hostImageCopyProperties{};
+    hostImageCopyProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_PROPERTIES_EXT;
+
+    VkPhysicalDeviceProperties2 properties2{};
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties2.pNext = &hostImageCopyProperties;
+    vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+
+    _copyDstLayouts.resize(hostImageCopyProperties.copyDstLayoutCount);
+    hostImageCopyProperties.pCopyDstLayouts = _copyDstLayouts.data();
+    vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+    _copyDstLayouts.resize(hostImageCopyProperties.copyDstLayoutCount);
+}
+
+bool maverik::HostImageCopy::isSupported(VkFormat format, VkImageUsageFlags usage, VkImageLayout layout) const
+{
+    if (std::find(_copyDstLayouts.begin(), _copyDstLayouts.end(), layout) == _copyDstLayouts.end()) {
+        return false;
+    }
+
+    VkHostImageCopyDevicePerformanceQueryEXT performanceQuery{};
+    performanceQuery.sType = VK_STRUCTURE_TYPE_HOST_IMAGE_COPY_DEVICE_PERFORMANCE_QUERY_EXT;
+
+    VkImageFormatProperties2 formatProperties{};
+    formatProperties.sType = VK_STRUCTURE_TYPE_IMAGE_FORMAT_PROPERTIES_2;
+    formatProperties.pNext = &performanceQuery;
+
+    VkPhysicalDeviceImageFormatInfo2 formatInfo{};
+    formatInfo.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGE_FORMAT_INFO_2;
+    formatInfo.format = format;
+    formatInfo.type = VK_IMAGE_TYPE_2D;
+    formatInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    formatInfo.usage = usage | VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT;
+
+    // Fails when the format lacks VK_FORMAT_FEATURE_2_HOST_IMAGE_TRANSFER_BIT_EXT
+    if (vkGetPhysicalDeviceImageFormatProperties2(_physicalDevice, &formatInfo, &formatProperties) != VK_SUCCESS) {
+        return false;
+    }
+    // A staging copy is cheaper than sampling a less efficient layout every frame
+    return performanceQuery.optimalDeviceAccess == VK_TRUE;
+}
+
+void maverik::HostImageCopy::transitionLayout(VkImage image, uint32_t mipLevels, VkImageLayout oldLayout, VkImageLayout newLayout) const
+{
+    VkHostImageLayoutTransitionInfoEXT transition{};
+    transition.sType = VK_STRUCTURE_TYPE_HOST_IMAGE_LAYOUT_TRANSITION_INFO_EXT;
+    transition.image = image;
+    transition.oldLayout = oldLayout;
+    transition.newLayout = newLayout;
+    transition.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    transition.subresourceRange.baseMipLevel = 0;
+    transition.subresourceRange.levelCount = mipLevels;
+    transition.subresourceRange.baseArrayLayer = 0;
+    transition.subresourceRange.layerCount = 1;
+
+    if (_transitionImageLayout(_logicalDevice, 1, &transition) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to transition image layout from the host !");
+    }
+}
+
+void maverik::HostImageCopy::copyToImage(VkImage image, VkImageLayout layout, const char *payload, const std::vector<VkBufferImageCopy>& regions) const
+{
+    std::vector<VkMemoryToImageCopyEXT> copies(regions.size());
+
+    for (size_t i = 0; i < regions.size(); i++) {
+        copies[i].sType = VK_STRUCTURE_TYPE_MEMORY_TO_IMAGE_COPY_EXT;
+        copies[i].pHostPointer = payload + regions[i].bufferOffset;
+        copies[i].memoryRowLength = regions[i].bufferRowLength;
+        copies[i].memoryImageHeight = regions[i].bufferImageHeight;
+        copies[i].imageSubresource = regions[i].imageSubresource;
+        copies[i].imageOffset = regions[i].imageOffset;
+        copies[i].imageExtent = regions[i].imageExtent;
+    }
+
+    VkCopyMemoryToImageInfoEXT copyInfo{};
+    copyInfo.sType = VK_STRUCTURE_TYPE_COPY_MEMORY_TO_IMAGE_INFO_EXT;
+    copyInfo.dstImage = image;
+    copyInfo.dstImageLayout = layout;
+    copyInfo.regionCount = static_cast<uint32_t>(copies.size());
+    copyInfo.pRegions = copies.data();
+
+    if (_copyMemoryToImage(_logicalDevice, &copyInfo) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to copy memory to image from the host !");
+    }
+}
@@ -0,0 +1,311 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** IndirectRenderer
+*/
+
+#include "IndirectRenderer.hpp"
+#include "MeshletCuller.hpp"
+
+#include <array>
+#include <algorithm>
+
+/*
+ * vkCmdUpdateBuffer uploads at most 65536 bytes per call.
+ */
+static constexpr VkDeviceSize MAX_UPDATE_SIZE = 65536;
+
+/*
+ * Radius of removed objects, no frustum test can accept them.
+ */
+static constexpr float REMOVED_RADIUS = -1.0f;
+
+/*
+ * Push constants of shaders/cull.comp.
+ */
+struct CullingParams {
+    glm::vec4 _planes[6];
+    uint32_t _objectCount;
+    uint32_t _compact;
+};
+
+////////////////////
+// Public methods //
+////////////////////
+
+maverik::IndirectRenderer::IndirectRenderer(const IndirectRendererCreationProperties& properties)
+    : _properties(properties)
+{
+    if (!_properties._capabilities._multiDrawIndirect) {
+        throw std::runtime_error("GPU-driven rendering needs multi-draw indirect and first instance support !");
+    }
+    if (_properties._capabilities._drawIndirectCount) {
+        _drawIndexedIndirectCount = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(
+            vkGetDeviceProcAddr(_properties._logicalDevice, "vkCmdDrawIndexedIndirectCountKHR"));
+    }
+    _objects.resize(_properties._maxObjects);
+
+    this->createBuffers();
+    this->createPipeline();
+}
+
+maverik::IndirectRenderer::~IndirectRenderer()
+{
+    vkDestroyPipeline(_properties._logicalDevice, _pipeline, nullptr);
+    vkDestroyDescriptorPool(_properties._logicalDevice, _descriptorPool, nullptr);
+    vkDestroyPipelineLayout(_properties._logicalDevice, _pipelineLayout, nullptr);
+    vkDestroyDescriptorSetLayout(_properties._logicalDevice, _descriptorSetLayout, nullptr);
+    vkDestroyBuffer(_properties._logicalDevice, _objectBuffer, nullptr);
+    vkFreeMemory(_properties._logicalDevice, _objectBufferMemory, nullptr);
+    vkDestroyBuffer(_properties._logicalDevice, _drawBuffer, nullptr);
+    vkFreeMemory(_properties._logicalDevice, _drawBufferMemory, nullptr);
+    vkDestroyBuffer(_properties._logicalDevice, _countBuffer, nullptr);
+    vkFreeMemory(_properties._logicalDevice, _countBufferMemory, nullptr);
+}
+
+uint32_t maverik::IndirectRenderer::addObject(const IndirectObject& object)
+{
+    uint32_t index;
+
+    if (!_freeIndices.empty()) {
+        index = _freeIndices.back();
+        _freeIndices.pop_back();
+    } else if (_objectCount < _properties._maxObjects) {
+        index = _objectCount++;
+    } else {
+        throw std::runtime_error("Indirect renderer is full !");
+    }
+    _objects[index] = object;
+    this->markDirty(index);
+    return index;
+}
+
+void maverik::IndirectRenderer::updateObject(uint32_t index, const IndirectObject& object)
+{
+    if (index >= _objectCount || _objects[index]._boundingSphere.w == REMOVED_RADIUS) {
+        throw std::runtime_error("No indirect object has this index !");
+    }
+    _objects[index] = object;
+    this->markDirty(index);
+}
+
+void maverik::IndirectRenderer::removeObject(uint32_t index)
+{
+    if (index >= _objectCount || _objects[index]._boundingSphere.w == REMOVED_RADIUS) {
+        throw std::runtime_error("No indirect object has this index !");
+    }
+    _objects[index] = IndirectObject{};
+    _objects[index]._boundingSphere.w = REMOVED_RADIUS;
+    _freeIndices.push_back(index);
+    this->markDirty(index);
+}
+
+void maverik::IndirectRenderer::recordCulling(VkCommandBuffer commandBuffer, const glm::mat4& viewProjection)
+{
+    // The previous frame may still read the draw commands and count this pass overwrites
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+        1, &barrier,
+        0, nullptr,
+        0, nullptr);
+
+    for (uint32_t first = _dirtyBegin; first < _dirtyEnd;) {
+        uint32_t count = std::min<uint32_t>(_dirtyEnd - first, MAX_UPDATE_SIZE / sizeof(IndirectObject));
+
+        vkCmdUpdateBuffer(commandBuffer, _objectBuffer, first * sizeof(IndirectObject), count * sizeof(IndirectObject), &_objects[first]);
+        first += count;
+    }
+    _dirtyBegin = 0;
+    _dirtyEnd = 0;
+    vkCmdFillBuffer(commandBuffer, _countBuffer, 0, sizeof(uint32_t), 0);
+
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+        1, &barrier,
+        0, nullptr,
+        0, nullptr);
+
+    std::array<glm::vec4, 6> planes = MeshletCuller::extractFrustumPlanes(viewProjection);
+    CullingParams params{};
+    std::copy(planes.begin(), planes.end(), params._planes);
+    params._objectCount = _objectCount;
+    params._compact = _drawIndexedIndirectCount != nullptr ? 1u : 0u;
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _pipelineLayout, 0, 1, &_descriptorSet, 0, nullptr);
+    vkCmdPushConstants(commandBuffer, _pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+    if (_objectCount > 0) {
+        vkCmdDispatch(commandBuffer, (_objectCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+    }
+
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0,
+        1, &barrier,
+        0, nullptr,
+        0, nullptr);
+}
+
+void maverik::IndirectRenderer::recordDraws(VkCommandBuffer commandBuffer) const
+{
+    if (_objectCount == 0) {
+        return;
+    }
+    if (_drawIndexedIndirectCount != nullptr) {
+        _drawIndexedIndirectCount(commandBuffer, _drawBuffer, 0, _countBuffer, 0, _objectCount, sizeof(VkDrawIndexedIndirectCommand));
+    } else {
+        vkCmdDrawIndexedIndirect(commandBuffer, _drawBuffer, 0, _objectCount, sizeof(VkDrawIndexedIndirectCommand));
+    }
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+void maverik::IndirectRenderer::markDirty(uint32_t index)
+{
+    if (_dirtyBegin == _dirtyEnd) {
+        _dirtyBegin = index;
+        _dirtyEnd = index + 1;
+        return;
+    }
+    _dirtyBegin = std::min(_dirtyBegin, index);
+    _dirtyEnd = std::max(_dirtyEnd, index + 1);
+}
+
+void maverik::IndirectRenderer::createBuffers()
+{
+    Utils::CreateBufferProperties objectBufferProperties = {
+        ._logicalDevice = _properties._logicalDevice,
+        ._physicalDevice = _properties._physicalDevice,
+        ._size = _properties._maxObjects * sizeof(IndirectObject),
+        ._usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        ._properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        ._buffer = _objectBuffer,
+        ._bufferMemory = _objectBufferMemory
+    };
+    Utils::createBuffer(objectBufferProperties);
+
+    Utils::CreateBufferProperties drawBufferProperties = {
+        ._logicalDevice = _properties._logicalDevice,
+        ._physicalDevice = _properties._physicalDevice,
+        ._size = _properties._maxObjects * sizeof(VkDrawIndexedIndirectCommand),
+        ._usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+        ._properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        ._buffer = _drawBuffer,
+        ._bufferMemory = _drawBufferMemory
+    };
+    Utils::createBuffer(drawBufferProperties);
+
+    Utils::CreateBufferProperties countBufferProperties = {
+        ._logicalDevice = _properties._logicalDevice,
+        ._physicalDevice = _properties._physicalDevice,
+        ._size = sizeof(uint32_t),
+        ._usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        ._properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        ._buffer = _countBuffer,
+        ._bufferMemory = _countBufferMemory
+    };
+    Utils::createBuffer(countBufferProperties);
+}
+
+void maverik::IndirectRenderer::createPipeline()
+{
+    std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+    for (uint32_t i = 0; i < bindings.size(); i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(_properties._logicalDevice, &layoutInfo, nullptr, &_descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create culling descriptor set layout!");
+    }
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(CullingParams);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &_descriptorSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(_properties._logicalDevice, &pipelineLayoutInfo, nullptr, &_pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create culling pipeline layout!");
+    }
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = static_cast<uint32_t>(bindings.size());
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+
+    if (vkCreateDescriptorPool(_properties._logicalDevice, &poolInfo, nullptr, &_descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create culling descriptor pool!");
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = _descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &_descriptorSetLayout;
+    if (vkAllocateDescriptorSets(_properties._logicalDevice, &allocInfo, &_descriptorSet) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate culling descriptor set!");
+    }
+
+    std::array<VkDescriptorBufferInfo, 3> bufferInfos{};
+    bufferInfos[0].buffer = _objectBuffer;
+    bufferInfos[1].buffer = _drawBuffer;
+    bufferInfos[2].buffer = _countBuffer;
+    std::array<VkWriteDescriptorSet, 3> descriptorWrites{};
+    for (uint32_t i = 0; i < descriptorWrites.size(); i++) {
+        bufferInfos[i].offset = 0;
+        bufferInfos[i].range = VK_WHOLE_SIZE;
+        descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[i].dstSet = _descriptorSet;
+        descriptorWrites[i].dstBinding = i;
+        descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptorWrites[i].descriptorCount = 1;
+        descriptorWrites[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(_properties._logicalDevice, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+
+    auto shaderCode = Utils::readFile(_properties._shaderDirectory + "/cull.comp.spv");
+    VkShaderModule shaderModule = Utils::createShaderModule(_properties._logicalDevice, shaderCode);
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = shaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = _pipelineLayout;
+
+    VkResult result = vkCreateComputePipelines(_properties._logicalDevice, _properties._pipelineCache, 1, &pipelineInfo, nullptr, &_pipeline);
+    vkDestroyShaderModule(_properties._logicalDevice, shaderModule, nullptr);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("failed to create culling pipeline!");
+    }
+}
@@ -0,0 +1,166 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** InstanceBatcher
+*/
+
+#include "InstanceBatcher.hpp"
+#include "Utils.hpp"
+
+#include <numeric>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+
+////////////////////
+// Public methods //
+////////////////////
+
+maverik::InstanceBatcher::InstanceBatcher(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, uint32_t frameCount)
+    : _logicalDevice(logicalDevice), _physicalDevice(physicalDevice), _frames(frameCount)
+{
+}
+
+maverik::InstanceBatcher::~InstanceBatcher()
+{
+    for (FrameBuffer& frame : _frames) {
+        this->destroy(frame);
+    }
+}
+
+uint32_t maverik::InstanceBatcher::addMesh(const MeshRange& range)
+{
+    _meshes.push_back(range);
+    return static_cast<uint32_t>(_meshes.size() - 1);
+}
+
+void maverik::InstanceBatcher::clear()
+{
+    _submittedMeshes.clear();
+    _submittedMaterials.clear();
+    _submittedInstances.clear();
+}
+
+void maverik::InstanceBatcher::submit(uint32_t mesh, uint32_t material, const InstanceData& instance)
+{
+    if (mesh >= _meshes.size()) {
+        throw std::runtime_error("Instance submitted with an unknown mesh !");
+    }
+    _submittedMeshes.push_back(mesh);
+    _submittedMaterials.push_back(material);
+    _submittedInstances.push_back(instance);
+}
+
+const std::vector<maverik::InstanceBatcher::Batch>& maverik::InstanceBatcher::build(uint32_t currentFrame)
+{
+    size_t instanceCount = _submittedInstances.size();
+    std::vector<uint32_t> instanceBatches(instanceCount);
+
+    _batches.clear();
+    _batchIndices.clear();
+    for (size_t i = 0; i < instanceCount; i++) {
+        uint64_t key = (static_cast<uint64_t>(_submittedMaterials[i]) << 32) | _submittedMeshes[i];
+        auto [entry, inserted] = _batchIndices.try_emplace(key, static_cast<uint32_t>(_batches.size()));
+
+        if (inserted) {
+            _batches.push_back({_submittedMeshes[i], _submittedMaterials[i], 0, 0});
+        }
+        _batches[entry->second]._instanceCount++;
+        instanceBatches[i] = entry->second;
+    }
+
+    // Sort by material so that consecutive batches share it, then lay the batches out in that order
+    std::vector<uint32_t> order(_batches.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        return _batches[a]._material != _batches[b]._material ? _batches[a]._material < _batches[b]._material : _batches[a]._mesh < _batches[b]._mesh;
+    });
+
+    std::vector<Batch> sorted;
+    std::vector<uint32_t> cursors(_batches.size());
+    uint32_t firstInstance = 0;
+    sorted.reserve(_batches.size());
+    for (uint32_t batch : order) {
+        cursors[batch] = firstInstance;
+        sorted.push_back(_batches[batch]);
+        sorted.back()._firstInstance = firstInstance;
+        firstInstance += _batches[batch]._instanceCount;
+    }
+    _batches = std::move(sorted);
+
+    // Instances keep their submission order inside their batch
+    _instances.resize(instanceCount);
+    for (size_t i = 0; i < instanceCount; i++) {
+        _instances[cursors[instanceBatches[i]]++] = _submittedInstances[i];
+    }
+
+    FrameBuffer& frame = _frames.at(currentFrame);
+    this->reserve(frame, instanceCount);
+    if (instanceCount > 0) {
+        std::memcpy(frame._mapped, _instances.data(), instanceCount * sizeof(InstanceData));
+    }
+    return _batches;
+}
+
+void maverik::InstanceBatcher::draw(VkCommandBuffer commandBuffer, uint32_t currentFrame, const std::function<void(VkCommandBuffer, uint32_t)>& setMaterial) const
+{
+    if (_batches.empty()) {
+        return;
+    }
+
+    VkBuffer instanceBuffer = _frames.at(currentFrame)._buffer;
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, InstanceData::BINDING, 1, &instanceBuffer, &offset);
+
+    for (size_t i = 0; i < _batches.size(); i++) {
+        const Batch& batch = _batches[i];
+        const MeshRange& mesh = _meshes[batch._mesh];
+
+        if (setMaterial && (i == 0 || batch._material != _batches[i - 1]._material)) {
+            setMaterial(commandBuffer, batch._material);
+        }
+        vkCmdDrawIndexed(commandBuffer, mesh._indexCount, batch._instanceCount, mesh._firstIndex, mesh._vertexOffset, batch._firstInstance);
+    }
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+void maverik::InstanceBatcher::reserve(FrameBuffer& frame, size_t instanceCount)
+{
+    if (instanceCount <= frame._capacity) {
+        return;
+    }
+    this->destroy(frame);
+
+    // Grow geometrically so that a slowly growing scene does not reallocate every frame
+    size_t capacity = std::max<size_t>(instanceCount, frame._capacity * 2);
+    capacity = std::max<size_t>(capacity, 64);
+    Utils::CreateBufferProperties bufferProperties = {
+        ._logicalDevice = _logicalDevice,
+        ._physicalDevice = _physicalDevice,
+        ._size = capacity * sizeof(InstanceData),
+        ._usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+        ._properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        ._buffer = frame._buffer,
+        ._bufferMemory = frame._memory
+    };
+    Utils::createBuffer(bufferProperties);
+    vkMapMemory(_logicalDevice, frame._memory, 0, VK_WHOLE_SIZE, 0, &frame._mapped);
+    frame._capacity = capacity;
+}
+
+void maverik::InstanceBatcher::destroy(FrameBuffer& frame)
+{
+    if (frame._buffer == VK_NULL_HANDLE) {
+        return;
+    }
+    vkUnmapMemory(_logicalDevice, frame._memory);
+    vkDestroyBuffer(_logicalDevice, frame._buffer, nullptr);
+    vkFreeMemory(_logicalDevice, frame._memory, nullptr);
+    frame._buffer = VK_NULL_HANDLE;
+    frame._memory = VK_NULL_HANDLE;
+    frame._mapped = nullptr;
+}
@@ -0,0 +1,117 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** KtxTexture
+*/
+
+#include "KtxTexture.hpp"
+#include "Utils.hpp"
+
+#include <cstring>
+#include <algorithm>
+
+/*
+ * Layout of the fixed-size part of a KTX2 file, the level index follows it.
+ */
+static constexpr uint8_t KTX2_IDENTIFIER[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+static constexpr size_t KTX2_HEADER_SIZE = 80;
+static constexpr size_t KTX2_LEVEL_INDEX_ENTRY_SIZE = 24;
+
+template <typename T>
+static T readLittleEndian(const char *data, size_t offset)
+{
+    T value;
+
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+////////////////////
+// Public methods //
+////////////////////
+
+maverik::KtxTexture::KtxTexture(std::vector<char> data)
+    : _data(std::move(data))
+{
+    this->parse(_data.data(), _data.size());
+}
+
+maverik::KtxTexture::KtxTexture(std::shared_ptr<FileAsset> asset)
+    : _asset(std::move(asset))
+{
+    if (_asset == nullptr) {
+        throw std::runtime_error("No asset to read the KTX2 file from!");
+    }
+    this->parse(_asset->content().data(), _asset->content().size());
+}
+
+maverik::KtxTexture maverik::KtxTexture::fromFile(const std::string& path)
+{
+    return KtxTexture(Utils::readFile(path));
+}
+
+bool maverik::KtxTexture::isKtx2Path(const std::string& path)
+{
+    static const std::string extension = ".ktx2";
+
+    return path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+bool maverik::KtxTexture::isCompressedFormat(VkFormat format)
+{
+    // BC1 to BC7, ETC2, EAC and ASTC LDR formats are contiguous in the core enumeration
+    if (format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK) {
+        return true;
+    }
+    return format >= VK_FORMAT_ASTC_4x4_SFLOAT_BLOCK && format <= VK_FORMAT_ASTC_12x12_SFLOAT_BLOCK;
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+void maverik::KtxTexture::parse(const char *bytes, size_t size)
+{
+    if (size < KTX2_HEADER_SIZE || std::memcmp(bytes, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0) {
+        throw std::runtime_error("Not a KTX2 file!");
+    }
+
+    _format = static_cast<VkFormat>(readLittleEndian<uint32_t>(bytes, 12));
+    _width = readLittleEndian<uint32_t>(bytes, 20);
+    _height = readLittleEndian<uint32_t>(bytes, 24);
+
+    uint32_t pixelDepth = readLittleEndian<uint32_t>(bytes, 28);
+    uint32_t layerCount = readLittleEndian<uint32_t>(bytes, 32);
+    uint32_t faceCount = readLittleEndian<uint32_t>(bytes, 36);
+    uint32_t levelCount = readLittleEndian<uint32_t>(bytes, 40);
+    uint32_t supercompressionScheme = readLittleEndian<uint32_t>(bytes, 44);
+
+    if (_format == VK_FORMAT_UNDEFINED) {
+        throw std::runtime_error("KTX2 textures without a Vulkan format (Basis Universal) are not supported!");
+    }
+    if (supercompressionScheme != 0) {
+        throw std::runtime_error("Supercompressed KTX2 textures are not supported!");
+    }
+    if (_width == 0 || _height == 0 || pixelDepth > 1 || layerCount > 1 || faceCount != 1) {
+        throw std::runtime_error("Only 2D KTX2 textures are supported!");
+    }
+
+    // A level count of 0 asks for runtime mip generation, only the base level is stored
+    levelCount = std::max(levelCount, 1u);
+    if (size < KTX2_HEADER_SIZE + levelCount * KTX2_LEVEL_INDEX_ENTRY_SIZE) {
+        throw std::runtime_error("Truncated KTX2 level index!");
+    }
+
+    _levels.resize(levelCount);
+    for (uint32_t i = 0; i < levelCount; i++) {
+        size_t entryOffset = KTX2_HEADER_SIZE + i * KTX2_LEVEL_INDEX_ENTRY_SIZE;
+
+        _levels[i]._byteOffset = readLittleEndian<uint64_t>(bytes, entryOffset);
+        _levels[i]._byteLength = readLittleEndian<uint64_t>(bytes, entryOffset + 8);
+        // Compared without adding, so a huge offset cannot wrap around into the file
+        if (_levels[i]._byteLength == 0 || _levels[i]._byteLength > size || _levels[i]._byteOffset > size - _levels[i]._byteLength) {
+            throw std::runtime_error("KTX2 level " + std::to_string(i) + " lies outside of the file!");
+        }
+    }
+}
@@ -0,0 +1,1179 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** MeshLoader
+*/
+
+#include "MeshLoader.hpp"
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <limits>
+#include <cstring>
+#include <utility>
+#include <charconv>
+#include <algorithm>
+
+/*
+ * Chunks per worker, so that workers finishing early pick up the remaining chunks.
+ */
+static constexpr size_t CHUNKS_PER_THREAD = 4;
+static constexpr size_t OBJ_MIN_CHUNK_BYTES = 1024 * 1024;
+static constexpr size_t MIN_CHUNK_CORNERS = 64 * 1024;
+static constexpr size_t GLB_MIN_CHUNK_ELEMENTS = 64 * 1024;
+
+/*
+ * Layout of a binary glTF file: a 12-byte header, then chunks made of an 8-byte header and their data.
+ */
+static constexpr uint32_t GLB_MAGIC = 0x46546C67;
+static constexpr uint32_t GLB_VERSION = 2;
+static constexpr uint32_t GLB_CHUNK_JSON = 0x4E4F534A;
+static constexpr uint32_t GLB_CHUNK_BIN = 0x004E4942;
+static constexpr size_t GLB_HEADER_SIZE = 12;
+static constexpr size_t GLB_CHUNK_HEADER_SIZE = 8;
+static constexpr uint32_t GLTF_MODE_TRIANGLES = 4;
+static constexpr size_t GLTF_MAX_NODE_DEPTH = 256;
+static constexpr size_t JSON_MAX_DEPTH = 256;
+
+static const glm::vec3 DEFAULT_COLOR(1.0f, 1.0f, 1.0f);
+
+template <typename T>
+static T readLittleEndian(const char *data, size_t offset)
+{
+    T value;
+
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+/**
+ * @brief Waits for every task of a batch.
+ *
+ * Tasks reference the state of the caller, so none may still be running when the
+ * exception of another one unwinds it. Results are then read with get().
+ */
+template <typename Result>
+static void waitForTasks(std::vector<std::future<Result>>& futures)
+{
+    for (auto& future : futures) {
+        future.wait();
+    }
+}
+
+/**
+ * @brief Hashes the value of a vertex, -0.0 and 0.0 hashing alike as they compare equal.
+ */
+static uint64_t hashVertex(const maverik::Vertex& vertex)
+{
+    const float values[8] = {
+        vertex.pos.x, vertex.pos.y, vertex.pos.z,
+        vertex.color.r, vertex.color.g, vertex.color.b,
+        vertex.texCoord.x, vertex.texCoord.y
+    };
+    uint64_t hash = 0xCBF29CE484222325ull;
+
+    for (float value : values) {
+        uint32_t bits;
+        float normalized = value + 0.0f;
+
+        std::memcpy(&bits, &normalized, sizeof(bits));
+        hash = (hash ^ bits) * 0x100000001B3ull;
+    }
+    hash ^= hash >> 32;
+    hash *= 0xD6E8FEB86659FD93ull;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+/**
+ * @brief Open-addressing hash table assigning an index to every distinct vertex.
+ *
+ * Slots are probed linearly and hold the index of a vertex along with the upper bits
+ * of its hash, so that most mismatches are rejected without comparing vertices. The
+ * table doubles whenever it gets half full.
+ */
+class VertexTable {
+    public:
+        VertexTable(size_t expectedCount)
+        {
+            size_t capacity = 16;
+
+            while (capacity < expectedCount * 2) {
+                capacity *= 2;
+            }
+            _slots.assign(capacity, {EMPTY, 0});
+            _vertices.reserve(expectedCount);
+        }
+
+        uint32_t insert(const maverik::Vertex& vertex)
+        {
+            uint64_t hash = hashVertex(vertex);
+            uint32_t tag = static_cast<uint32_t>(hash >> 32);
+            size_t mask = _slots.size() - 1;
+
+            for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+                Slot& entry = _slots[slot];
+
+                if (entry._index == EMPTY) {
+                    entry = {static_cast<uint32_t>(_vertices.size()), tag};
+                    _vertices.push_back(vertex);
+                    if (_vertices.size() * 2 > _slots.size()) {
+                        this->grow();
+                    }
+                    return static_cast<uint32_t>(_vertices.size() - 1);
+                }
+                if (entry._tag == tag && _vertices[entry._index] == vertex) {
+                    return entry._index;
+                }
+            }
+        }
+
+        std::vector<maverik::Vertex> release()
+        {
+            _slots.clear();
+            return std::move(_vertices);
+        }
+
+    private:
+        struct Slot {
+            uint32_t _index;    // Index of the vertex, EMPTY if the slot is free
+            uint32_t _tag;      // Upper 32 bits of the hash of the vertex
+        };
+
+        static constexpr uint32_t EMPTY = UINT32_MAX;
+
+        void grow()
+        {
+            std::vector<Slot> slots(_slots.size() * 2, {EMPTY, 0});
+            size_t mask = slots.size() - 1;
+
+            for (const Slot& entry : _slots) {
+                if (entry._index == EMPTY) {
+                    continue;
+                }
+                size_t slot = hashVertex(_vertices[entry._index]) & mask;
+                while (slots[slot]._index != EMPTY) {
+                    slot = (slot + 1) & mask;
+                }
+                slots[slot] = entry;
+            }
+            _slots = std::move(slots);
+        }
+
+        std::vector<Slot> _slots;
+        std::vector<maverik::Vertex> _vertices;
+};
+
+/*
+ * OBJ parsing
+ */
+
+/**
+ * @brief Corner of an OBJ face as written in its chunk.
+ *
+ * Absolute indices are already 0-based. Relative ones are stored relative to the first
+ * element of the chunk, whose global index is only known once every chunk is parsed.
+ */
+struct ObjCorner {
+    int32_t _position;
+    int32_t _texCoord;
+    uint32_t _flags;
+};
+
+static constexpr uint32_t OBJ_POSITION_RELATIVE = 1 << 0;
+static constexpr uint32_t OBJ_TEXCOORD_RELATIVE = 1 << 1;
+static constexpr uint32_t OBJ_NO_TEXCOORD = 1 << 2;
+
+struct ObjChunk {
+    std::vector<glm::vec3> _positions;
+    std::vector<glm::vec3> _colors;         // One per position
+    std::vector<glm::vec2> _texCoords;
+    std::vector<ObjCorner> _corners;        // Three per triangle
+};
+
+struct ObjResolvedCorner {
+    uint32_t _position;
+    uint32_t _texCoord;                     // UINT32_MAX if the corner has no texture coordinates
+};
+
+static bool isObjSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static const char *skipObjSpaces(const char *cursor, const char *end)
+{
+    while (cursor < end && isObjSpace(*cursor)) {
+        cursor++;
+    }
+    return cursor;
+}
+
+static const char *parseObjFloat(const char *cursor, const char *end, float& value)
+{
+    cursor = skipObjSpaces(cursor, end);
+    // from_chars rejects the leading plus sign some exporters write
+    if (cursor < end && *cursor == '+') {
+        cursor++;
+    }
+
+    auto [next, error] = std::from_chars(cursor, end, value);
+    return error == std::errc() ? next : nullptr;
+}
+
+static const char *parseObjIndex(const char *cursor, const char *end, size_t localCount, int32_t& index, bool& relative)
+{
+    int32_t value = 0;
+    auto [next, error] = std::from_chars(cursor, end, value);
+
+    if (error != std::errc() || value == 0) {
+        throw std::runtime_error("Malformed face in OBJ file !");
+    }
+    relative = value < 0;
+    index = relative ? static_cast<int32_t>(localCount) + value : value - 1;
+    return next;
+}
+
+static void parseObjFace(const char *cursor, const char *end, ObjChunk& chunk, std::vector<ObjCorner>& polygon)
+{
+    polygon.clear();
+    while (true) {
+        cursor = skipObjSpaces(cursor, end);
+        if (cursor == end || *cursor == '#') {
+            break;
+        }
+
+        ObjCorner corner{0, 0, OBJ_NO_TEXCOORD};
+        bool relative = false;
+
+        cursor = parseObjIndex(cursor, end, chunk._positions.size(), corner._position, relative);
+        if (relative) {
+            corner._flags |= OBJ_POSITION_RELATIVE;
+        }
+        if (cursor < end && *cursor == '/') {
+            cursor++;
+            if (cursor < end && *cursor != '/') {
+                cursor = parseObjIndex(cursor, end, chunk._texCoords.size(), corner._texCoord, relative);
+                corner._flags &= ~OBJ_NO_TEXCOORD;
+                if (relative) {
+                    corner._flags |= OBJ_TEXCOORD_RELATIVE;
+                }
+            }
+            // Normals are not imported, skip them
+            if (cursor < end && *cursor == '/') {
+                cursor++;
+                while (cursor < end && !isObjSpace(*cursor)) {
+                    cursor++;
+                }
+            }
+        }
+        polygon.push_back(corner);
+    }
+
+    // Polygons are triangulated as fans around their first corner
+    for (size_t i = 2; i < polygon.size(); i++) {
+        chunk._corners.push_back(polygon[0]);
+        chunk._corners.push_back(polygon[i - 1]);
+        chunk._corners.push_back(polygon[i]);
+    }
+}
+
+static ObjChunk parseObjChunk(const char *begin, const char *end)
+{
+    ObjChunk chunk;
+    std::vector<ObjCorner> polygon;
+
+    for (const char *line = begin; line < end;) {
+        const char *lineEnd = static_cast<const char *>(std::memchr(line, '\n', end - line));
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+
+        const char *cursor = skipObjSpaces(line, lineEnd);
+        size_t length = lineEnd - cursor;
+
+        if (length > 2 && cursor[0] == 'v' && isObjSpace(cursor[1])) {
+            glm::vec3 position(0.0f);
+            glm::vec3 color = DEFAULT_COLOR;
+
+            cursor += 2;
+            for (int i = 0; i < 3 && cursor != nullptr; i++) {
+                cursor = parseObjFloat(cursor, lineEnd, position[i]);
+            }
+            if (cursor == nullptr) {
+                throw std::runtime_error("Malformed vertex position in OBJ file !");
+            }
+            // Optional vertex color extension: v x y z r g b
+            glm::vec3 extra;
+            const char *colorCursor = cursor;
+            for (int i = 0; i < 3 && colorCursor != nullptr; i++) {
+                colorCursor = parseObjFloat(colorCursor, lineEnd, extra[i]);
+            }
+            if (colorCursor != nullptr) {
+                color = extra;
+            }
+            chunk._positions.push_back(position);
+            chunk._colors.push_back(color);
+        } else if (length > 3 && cursor[0] == 'v' && cursor[1] == 't' && isObjSpace(cursor[2])) {
+            glm::vec2 texCoord(0.0f);
+
+            cursor += 3;
+            for (int i = 0; i < 2 && cursor != nullptr; i++) {
+                cursor = parseObjFloat(cursor, lineEnd, texCoord[i]);
+            }
+            if (cursor == nullptr) {
+                throw std::runtime_error("Malformed texture coordinates in OBJ file !");
+            }
+            // OBJ puts the origin of textures at their bottom left, Vulkan at their top left
+            chunk._texCoords.emplace_back(texCoord.x, 1.0f - texCoord.y);
+        } else if (length > 2 && cursor[0] == 'f' && isObjSpace(cursor[1])) {
+            parseObjFace(cursor + 2, lineEnd, chunk, polygon);
+        }
+        line = lineEnd + 1;
+    }
+    return chunk;
+}
+
+static uint32_t resolveObjIndex(int32_t index, bool relative, size_t base, size_t count)
+{
+    int64_t resolved = relative ? static_cast<int64_t>(base) + index : index;
+
+    if (resolved < 0 || static_cast<size_t>(resolved) >= count) {
+        throw std::runtime_error("OBJ face references an element that does not exist !");
+    }
+    return static_cast<uint32_t>(resolved);
+}
+
+/*
+ * JSON parsing, limited to what the glTF chunk of a GLB file needs
+ */
+
+struct JsonValue {
+    enum class Type {
+        NIL,
+        BOOLEAN,
+        NUMBER,
+        STRING,
+        ARRAY,
+        OBJECT
+    };
+
+    Type _type = Type::NIL;
+    bool _boolean = false;
+    double _number = 0.0;
+    std::string _string;
+    std::vector<JsonValue> _array;
+    std::vector<std::pair<std::string, JsonValue>> _members;
+
+    const JsonValue *get(const std::string& key) const
+    {
+        for (const auto& [name, value] : _members) {
+            if (name == key) {
+                return &value;
+            }
+        }
+        return nullptr;
+    }
+
+    const JsonValue& at(size_t index) const
+    {
+        if (_type != Type::ARRAY || index >= _array.size()) {
+            throw std::runtime_error("Invalid glTF reference !");
+        }
+        return _array[index];
+    }
+
+    double number(const std::string& key, double fallback) const
+    {
+        const JsonValue *value = this->get(key);
+
+        return value != nullptr && value->_type == Type::NUMBER ? value->_number : fallback;
+    }
+
+    size_t index(const std::string& key) const
+    {
+        double value = this->number(key, -1.0);
+
+        if (value < 0.0) {
+            throw std::runtime_error("Missing glTF property " + key + " !");
+        }
+        return static_cast<size_t>(value);
+    }
+};
+
+class JsonParser {
+    public:
+        JsonParser(const char *begin, const char *end)
+            : _cursor(begin), _end(end)
+        {
+        }
+
+        JsonValue parse()
+        {
+            JsonValue value = this->parseValue(0);
+
+            this->skipSpaces();
+            // The JSON chunk is padded with spaces, nothing else may follow the document
+            if (_cursor != _end) {
+                this->fail();
+            }
+            return value;
+        }
+
+    private:
+        [[noreturn]] void fail() const
+        {
+            throw std::runtime_error("Malformed JSON in glTF file !");
+        }
+
+        void skipSpaces()
+        {
+            while (_cursor < _end && (*_cursor == ' ' || *_cursor == '\t' || *_cursor == '\n' || *_cursor == '\r')) {
+                _cursor++;
+            }
+        }
+
+        void expect(char c)
+        {
+            this->skipSpaces();
+            if (_cursor == _end || *_cursor != c) {
+                this->fail();
+            }
+            _cursor++;
+        }
+
+        bool consumeSeparator()
+        {
+            this->skipSpaces();
+            if (_cursor < _end && *_cursor == ',') {
+                _cursor++;
+                return true;
+            }
+            return false;
+        }
+
+        bool consume(const char *literal)
+        {
+            size_t length = std::strlen(literal);
+
+            if (static_cast<size_t>(_end - _cursor) < length || std::memcmp(_cursor, literal, length) != 0) {
+                return false;
+            }
+            _cursor += length;
+            return true;
+        }
+
+        JsonValue parseValue(size_t depth)
+        {
+            JsonValue value;
+
+            if (depth > JSON_MAX_DEPTH) {
+                this->fail();
+            }
+            this->skipSpaces();
+            if (_cursor == _end) {
+                this->fail();
+            }
+            if (*_cursor == '{') {
+                value._type = JsonValue::Type::OBJECT;
+                _cursor++;
+                this->skipSpaces();
+                if (_cursor < _end && *_cursor == '}') {
+                    _cursor++;
+                    return value;
+                }
+                while (true) {
+                    this->skipSpaces();
+                    std::string key = this->parseString();
+                    this->expect(':');
+                    value._members.emplace_back(std::move(key), this->parseValue(depth + 1));
+                    if (!this->consumeSeparator()) {
+                        break;
+                    }
+                }
+                this->expect('}');
+            } else if (*_cursor == '[') {
+                value._type = JsonValue::Type::ARRAY;
+                _cursor++;
+                this->skipSpaces();
+                if (_cursor < _end && *_cursor == ']') {
+                    _cursor++;
+                    return value;
+                }
+                while (true) {
+                    value._array.push_back(this->parseValue(depth + 1));
+                    if (!this->consumeSeparator()) {
+                        break;
+                    }
+                }
+                this->expect(']');
+            } else if (*_cursor == '"') {
+                value._type = JsonValue::Type::STRING;
+                value._string = this->parseString();
+            } else if (this->consume("true")) {
+                value._type = JsonValue::Type::BOOLEAN;
+                value._boolean = true;
+            } else if (this->consume("false")) {
+                value._type = JsonValue::Type::BOOLEAN;
+            } else if (this->consume("null")) {
+                value._type = JsonValue::Type::NIL;
+            } else {
+                value._type = JsonValue::Type::NUMBER;
+                auto [next, error] = std::from_chars(_cursor, _end, value._number);
+                if (error != std::errc()) {
+                    this->fail();
+                }
+                _cursor = next;
+            }
+            return value;
+        }
+
+        std::string parseString()
+        {
+            std::string result;
+
+            if (_cursor == _end || *_cursor != '"') {
+                this->fail();
+            }
+            _cursor++;
+            while (_cursor < _end && *_cursor != '"') {
+                if (*_cursor != '\\') {
+                    result += *_cursor++;
+                    continue;
+                }
+                if (++_cursor == _end) {
+                    this->fail();
+                }
+                switch (*_cursor++) {
+                    case '"': result += '"'; break;
+                    case '\\': result += '\\'; break;
+                    case '/': result += '/'; break;
+                    case 'b': result += '\b'; break;
+                    case 'f': result += '\f'; break;
+                    case 'n': result += '\n'; break;
+                    case 'r': result += '\r'; break;
+                    case 't': result += '\t'; break;
+                    case 'u': this->appendCodePoint(result); break;
+                    default: this->fail();
+                }
+            }
+            if (_cursor == _end) {
+                this->fail();
+            }
+            _cursor++;
+            return result;
+        }
+
+        uint32_t parseHex()
+        {
+            uint32_t value = 0;
+
+            if (_end - _cursor < 4) {
+                this->fail();
+            }
+            auto [next, error] = std::from_chars(_cursor, _cursor + 4, value, 16);
+            if (error != std::errc() || next != _cursor + 4) {
+                this->fail();
+            }
+            _cursor = next;
+            return value;
+        }
+
+        void appendCodePoint(std::string& result)
+        {
+            uint32_t codePoint = this->parseHex();
+
+            // Characters outside the basic plane are escaped as surrogate pairs
+            if (codePoint >= 0xD800 && codePoint < 0xDC00 && this->consume("\\u")) {
+                uint32_t low = this->parseHex();
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+            }
+            if (codePoint < 0x80) {
+                result += static_cast<char>(codePoint);
+            } else if (codePoint < 0x800) {
+                result += static_cast<char>(0xC0 | (codePoint >> 6));
+                result += static_cast<char>(0x80 | (codePoint & 0x3F));
+            } else if (codePoint < 0x10000) {
+                result += static_cast<char>(0xE0 | (codePoint >> 12));
+                result += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                result += static_cast<char>(0x80 | (codePoint & 0x3F));
+            } else {
+                result += static_cast<char>(0xF0 | (codePoint >> 18));
+                result += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+                result += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                result += static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+        }
+
+        const char *_cursor;
+        const char *_end;
+};
+
+/*
+ * glTF accessors
+ */
+
+struct GltfAccessor {
+    const char *_data = nullptr;        // First element
+    size_t _count = 0;                  // Number of elements
+    size_t _stride = 0;                 // Distance between two elements, in bytes
+    uint32_t _componentType = 0;        // GL enum of the type of the components
+    uint32_t _components = 0;           // Number of components per element
+    bool _normalized = false;           // Whether integer components map to [0, 1] or [-1, 1]
+};
+
+static size_t getComponentSize(uint32_t componentType)
+{
+    switch (componentType) {
+        case 5120: // BYTE
+        case 5121: // UNSIGNED_BYTE
+            return 1;
+        case 5122: // SHORT
+        case 5123: // UNSIGNED_SHORT
+            return 2;
+        case 5125: // UNSIGNED_INT
+        case 5126: // FLOAT
+            return 4;
+        default:
+            throw std::runtime_error("Unsupported glTF component type !");
+    }
+}
+
+static uint32_t getComponentCount(const std::string& type)
+{
+    if (type == "SCALAR") {
+        return 1;
+    }
+    if (type == "VEC2") {
+        return 2;
+    }
+    if (type == "VEC3") {
+        return 3;
+    }
+    if (type == "VEC4") {
+        return 4;
+    }
+    throw std::runtime_error("Unsupported glTF accessor type " + type + " !");
+}
+
+static GltfAccessor getAccessor(const JsonValue& document, const std::string& binary, size_t index)
+{
+    const JsonValue& accessor = document.get("accessors") ? document.get("accessors")->at(index) : throw std::runtime_error("Missing glTF accessors !");
+    const JsonValue *type = accessor.get("type");
+    GltfAccessor result;
+
+    if (accessor.get("sparse") != nullptr) {
+        throw std::runtime_error("Sparse glTF accessors are not supported !");
+    }
+    if (type == nullptr || type->_type != JsonValue::Type::STRING) {
+        throw std::runtime_error("Missing glTF accessor type !");
+    }
+    result._count = accessor.index("count");
+    result._componentType = static_cast<uint32_t>(accessor.index("componentType"));
+    result._components = getComponentCount(type->_string);
+    result._normalized = accessor.get("normalized") != nullptr && accessor.get("normalized")->_boolean;
+
+    size_t elementSize = getComponentSize(result._componentType) * result._components;
+    const JsonValue *viewIndex = accessor.get("bufferView");
+    if (viewIndex == nullptr) {
+        throw std::runtime_error("glTF accessors without buffer view are not supported !");
+    }
+
+    const JsonValue *views = document.get("bufferViews");
+    const JsonValue& view = views ? views->at(static_cast<size_t>(viewIndex->_number)) : throw std::runtime_error("Missing glTF buffer views !");
+    if (view.index("buffer") != 0) {
+        throw std::runtime_error("Only the embedded buffer of GLB files is supported !");
+    }
+
+    size_t viewOffset = static_cast<size_t>(view.number("byteOffset", 0.0));
+    size_t viewLength = view.index("byteLength");
+    size_t offset = static_cast<size_t>(accessor.number("byteOffset", 0.0));
+    result._stride = static_cast<size_t>(view.number("byteStride", static_cast<double>(elementSize)));
+
+    if (viewOffset > binary.size() || viewLength > binary.size() - viewOffset || result._stride < elementSize) {
+        throw std::runtime_error("glTF buffer view out of bounds !");
+    }
+    if (result._count > 0) {
+        size_t available = offset <= viewLength ? viewLength - offset : 0;
+
+        if (available < elementSize || (result._count - 1) > (available - elementSize) / result._stride) {
+            throw std::runtime_error("glTF accessor out of bounds !");
+        }
+    }
+    result._data = binary.data() + viewOffset + offset;
+    return result;
+}
+
+static float readComponent(const char *data, uint32_t componentType, bool normalized)
+{
+    switch (componentType) {
+        case 5120: {
+            float value = static_cast<float>(readLittleEndian<int8_t>(data, 0));
+            return normalized ? std::max(value / 127.0f, -1.0f) : value;
+        }
+        case 5121: {
+            float value = static_cast<float>(readLittleEndian<uint8_t>(data, 0));
+            return normalized ? value / 255.0f : value;
+        }
+        case 5122: {
+            float value = static_cast<float>(readLittleEndian<int16_t>(data, 0));
+            return normalized ? std::max(value / 32767.0f, -1.0f) : value;
+        }
+        case 5123: {
+            float value = static_cast<float>(readLittleEndian<uint16_t>(data, 0));
+            return normalized ? value / 65535.0f : value;
+        }
+        case 5125:
+            return static_cast<float>(readLittleEndian<uint32_t>(data, 0));
+        default:
+            return readLittleEndian<float>(data, 0);
+    }
+}
+
+static glm::vec4 readElement(const GltfAccessor& accessor, size_t element)
+{
+    glm::vec4 value(0.0f, 0.0f, 0.0f, 1.0f);
+    const char *data = accessor._data + element * accessor._stride;
+    size_t componentSize = getComponentSize(accessor._componentType);
+
+    for (uint32_t i = 0; i < accessor._components; i++) {
+        value[i] = readComponent(data + i * componentSize, accessor._componentType, accessor._normalized);
+    }
+    return value;
+}
+
+static uint32_t readIndex(const GltfAccessor& accessor, size_t element)
+{
+    const char *data = accessor._data + element * accessor._stride;
+
+    switch (accessor._componentType) {
+        case 5121:
+            return readLittleEndian<uint8_t>(data, 0);
+        case 5123:
+            return readLittleEndian<uint16_t>(data, 0);
+        case 5125:
+            return readLittleEndian<uint32_t>(data, 0);
+        default:
+            throw std::runtime_error("Invalid glTF index component type !");
+    }
+}
+
+/**
+ * @brief A triangle primitive of the scene, with the world transform of the node drawing it.
+ */
+struct GltfPrimitiveInstance {
+    const JsonValue *_primitive;
+    glm::mat4 _transform;
+    GltfAccessor _positions;
+    GltfAccessor _colors;                   // _count is 0 if the primitive has no color
+    GltfAccessor _texCoords;                // _count is 0 if the primitive has no texture coordinates
+    GltfAccessor _indices;                  // _count is 0 if the primitive is not indexed
+    size_t _vertexBase = 0;                 // First vertex of the primitive in the source vertices
+    size_t _cornerBase = 0;                 // First corner of the primitive
+    size_t _cornerCount = 0;                // Number of corners, three per triangle
+};
+
+static glm::mat4 getNodeTransform(const JsonValue& node)
+{
+    const JsonValue *matrix = node.get("matrix");
+
+    if (matrix != nullptr && matrix->_type == JsonValue::Type::ARRAY && matrix->_array.size() == 16) {
+        glm::mat4 transform(1.0f);
+        // glTF matrices are column-major, as glm ones
+        for (size_t i = 0; i < 16; i++) {
+            transform[i / 4][i % 4] = static_cast<float>(matrix->_array[i]._number);
+        }
+        return transform;
+    }
+
+    glm::vec3 translation(0.0f);
+    glm::quat rotation(1.0f, 0.0f, 0.0f, 0.0f);
+    glm::vec3 scale(1.0f);
+    const JsonValue *value = nullptr;
+
+    if ((value = node.get("translation")) != nullptr && value->_array.size() == 3) {
+        translation = glm::vec3(value->_array[0]._number, value->_array[1]._number, value->_array[2]._number);
+    }
+    // glTF stores quaternions as x, y, z, w
+    if ((value = node.get("rotation")) != nullptr && value->_array.size() == 4) {
+        rotation = glm::quat(static_cast<float>(value->_array[3]._number), static_cast<float>(value->_array[0]._number),
+            static_cast<float>(value->_array[1]._number), static_cast<float>(value->_array[2]._number));
+    }
+    if ((value = node.get("scale")) != nullptr && value->_array.size() == 3) {
+        scale = glm::vec3(value->_array[0]._number, value->_array[1]._number, value->_array[2]._number);
+    }
+    return glm::translate(glm::mat4(1.0f), translation) * glm::mat4_cast(rotation) * glm::scale(glm::mat4(1.0f), scale);
+}
+
+static void collectMeshPrimitives(const JsonValue& document, size_t meshIndex, const glm::mat4& transform, std::vector<GltfPrimitiveInstance>& instances)
+{
+    const JsonValue *meshes = document.get("meshes");
+    const JsonValue& mesh = meshes ? meshes->at(meshIndex) : throw std::runtime_error("Missing glTF meshes !");
+    const JsonValue *primitives = mesh.get("primitives");
+
+    if (primitives == nullptr) {
+        return;
+    }
+    for (const JsonValue& primitive : primitives->_array) {
+        // Points, lines and strips are not imported
+        if (primitive.number("mode", GLTF_MODE_TRIANGLES) != GLTF_MODE_TRIANGLES) {
+            continue;
+        }
+        instances.push_back({&primitive, transform, {}, {}, {}, {}});
+    }
+}
+
+static void collectNodePrimitives(const JsonValue& document, size_t nodeIndex, const glm::mat4& parentTransform, size_t depth, std::vector<GltfPrimitiveInstance>& instances)
+{
+    if (depth > GLTF_MAX_NODE_DEPTH) {
+        throw std::runtime_error("glTF node hierarchy is too deep !");
+    }
+
+    const JsonValue *nodes = document.get("nodes");
+    const JsonValue& node = nodes ? nodes->at(nodeIndex) : throw std::runtime_error("Missing glTF nodes !");
+    glm::mat4 transform = parentTransform * getNodeTransform(node);
+
+    if (node.get("mesh") != nullptr) {
+        collectMeshPrimitives(document, node.index("mesh"), transform, instances);
+    }
+    if (const JsonValue *children = node.get("children")) {
+        for (const JsonValue& child : children->_array) {
+            collectNodePrimitives(document, static_cast<size_t>(child._number), transform, depth + 1, instances);
+        }
+    }
+}
+
+////////////////////
+// Public methods //
+////////////////////
+
+maverik::MeshLoader::MeshLoader(ThreadPool& threadPool)
+    : _threadPool(threadPool)
+{
+}
+
+bool maverik::MeshLoader::isMeshPath(const std::string& path)
+{
+    auto endsWith = [&path](const std::string& suffix) {
+        return path.size() >= suffix.size() && path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+
+    return endsWith(".obj") || endsWith(".glb");
+}
+
+maverik::MeshData maverik::MeshLoader::load(const std::string& path, AAssetManager& assetManager)
+{
+    if (!isMeshPath(path)) {
+        throw std::runtime_error("Unsupported mesh format: " + path + " !");
+    }
+
+    std::shared_ptr<FileAsset> asset = assetManager.add(path);
+    if (asset == nullptr) {
+        throw std::runtime_error("Failed to read mesh file " + path + " !");
+    }
+    if (path.compare(path.size() - 4, 4, ".obj") == 0) {
+        return this->loadObj(*asset);
+    }
+    return this->loadGlb(*asset);
+}
+
+maverik::MeshData maverik::MeshLoader::loadObj(const FileAsset& asset)
+{
+    const std::string& text = asset.content();
+    std::vector<size_t> bounds = this->splitRange(text.size(), OBJ_MIN_CHUNK_BYTES);
+
+    // Chunks start at the beginning of a line
+    for (size_t i = 1; i + 1 < bounds.size(); i++) {
+        size_t bound = std::max(bounds[i], bounds[i - 1]);
+
+        if (bound > 0 && text[bound - 1] != '\n') {
+            size_t lineEnd = text.find('\n', bound);
+            bound = lineEnd == std::string::npos ? text.size() : lineEnd + 1;
+        }
+        bounds[i] = bound;
+    }
+
+    std::vector<std::future<ObjChunk>> parsing;
+    for (size_t i = 0; i + 1 < bounds.size(); i++) {
+        const char *begin = text.data() + bounds[i];
+        const char *end = text.data() + std::max(bounds[i], bounds[i + 1]);
+
+        parsing.push_back(_threadPool.submit([begin, end] { return parseObjChunk(begin, end); }));
+    }
+    waitForTasks(parsing);
+
+    std::vector<ObjChunk> chunks;
+    for (auto& future : parsing) {
+        chunks.push_back(future.get());
+    }
+
+    // Relative indices are resolved against the elements of the previous chunks
+    std::vector<size_t> positionBases(chunks.size());
+    std::vector<size_t> texCoordBases(chunks.size());
+    std::vector<size_t> cornerBases(chunks.size());
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> colors;
+    std::vector<glm::vec2> texCoords;
+    size_t cornerCount = 0;
+
+    for (size_t i = 0; i < chunks.size(); i++) {
+        positionBases[i] = positions.size();
+        texCoordBases[i] = texCoords.size();
+        cornerBases[i] = cornerCount;
+        positions.insert(positions.end(), chunks[i]._positions.begin(), chunks[i]._positions.end());
+        colors.insert(colors.end(), chunks[i]._colors.begin(), chunks[i]._colors.end());
+        texCoords.insert(texCoords.end(), chunks[i]._texCoords.begin(), chunks[i]._texCoords.end());
+        cornerCount += chunks[i]._corners.size();
+    }
+    if (positions.size() > UINT32_MAX || texCoords.size() > UINT32_MAX || cornerCount > UINT32_MAX) {
+        throw std::runtime_error("OBJ file is too large to be indexed with 32-bit indices !");
+    }
+
+    std::vector<ObjResolvedCorner> corners(cornerCount);
+    std::vector<std::future<void>> resolving;
+    for (size_t i = 0; i < chunks.size(); i++) {
+        resolving.push_back(_threadPool.submit([&, i] {
+            const ObjChunk& chunk = chunks[i];
+
+            for (size_t j = 0; j < chunk._corners.size(); j++) {
+                const ObjCorner& corner = chunk._corners[j];
+                ObjResolvedCorner& resolved = corners[cornerBases[i] + j];
+
+                resolved._position = resolveObjIndex(corner._position, corner._flags & OBJ_POSITION_RELATIVE, positionBases[i], positions.size());
+                resolved._texCoord = corner._flags & OBJ_NO_TEXCOORD ? UINT32_MAX
+                    : resolveObjIndex(corner._texCoord, corner._flags & OBJ_TEXCOORD_RELATIVE, texCoordBases[i], texCoords.size());
+            }
+        }));
+    }
+    waitForTasks(resolving);
+    for (auto& future : resolving) {
+        future.get();
+    }
+    chunks.clear();
+
+    return this->weld(corners.size(), [&](size_t corner) {
+        const ObjResolvedCorner& resolved = corners[corner];
+
+        return Vertex{
+            positions[resolved._position],
+            colors[resolved._position],
+            resolved._texCoord == UINT32_MAX ? glm::vec2(0.0f) : texCoords[resolved._texCoord]
+        };
+    });
+}
+
+maverik::MeshData maverik::MeshLoader::loadGlb(const FileAsset& asset)
+{
+    const std::string& content = asset.content();
+
+    if (content.size() < GLB_HEADER_SIZE + GLB_CHUNK_HEADER_SIZE
+        || readLittleEndian<uint32_t>(content.data(), 0) != GLB_MAGIC
+        || readLittleEndian<uint32_t>(content.data(), 4) != GLB_VERSION) {
+        throw std::runtime_error("Invalid GLB file !");
+    }
+
+    size_t length = std::min<size_t>(readLittleEndian<uint32_t>(content.data(), 8), content.size());
+    const char *json = nullptr;
+    size_t jsonLength = 0;
+    std::string binary;
+
+    for (size_t offset = GLB_HEADER_SIZE; offset + GLB_CHUNK_HEADER_SIZE <= length;) {
+        size_t chunkLength = readLittleEndian<uint32_t>(content.data(), offset);
+        uint32_t chunkType = readLittleEndian<uint32_t>(content.data(), offset + 4);
+
+        offset += GLB_CHUNK_HEADER_SIZE;
+        if (chunkLength > length - offset) {
+            throw std::runtime_error("GLB chunk out of bounds !");
+        }
+        if (chunkType == GLB_CHUNK_JSON && json == nullptr) {
+            json = content.data() + offset;
+            jsonLength = chunkLength;
+        } else if (chunkType == GLB_CHUNK_BIN && binary.empty()) {
+            binary.assign(content.data() + offset, chunkLength);
+        }
+        // Chunks are 4-byte aligned
+        offset += (chunkLength + 3) & ~static_cast<size_t>(3);
+    }
+    if (json == nullptr) {
+        throw std::runtime_error("GLB file has no JSON chunk !");
+    }
+
+    JsonValue document = JsonParser(json, json + jsonLength).parse();
+    std::vector<GltfPrimitiveInstance> instances;
+    const JsonValue *scenes = document.get("scenes");
+
+    if (scenes != nullptr && !scenes->_array.empty()) {
+        const JsonValue& scene = scenes->at(static_cast<size_t>(document.number("scene", 0.0)));
+        if (const JsonValue *roots = scene.get("nodes")) {
+            for (const JsonValue& root : roots->_array) {
+                collectNodePrimitives(document, static_cast<size_t>(root._number), glm::mat4(1.0f), 0, instances);
+            }
+        }
+    } else if (const JsonValue *meshes = document.get("meshes")) {
+        // Without scenes, every mesh is imported once, untransformed
+        for (size_t i = 0; i < meshes->_array.size(); i++) {
+            collectMeshPrimitives(document, i, glm::mat4(1.0f), instances);
+        }
+    }
+
+    size_t vertexCount = 0;
+    size_t cornerCount = 0;
+    for (GltfPrimitiveInstance& instance : instances) {
+        const JsonValue *attributes = instance._primitive->get("attributes");
+        if (attributes == nullptr || attributes->get("POSITION") == nullptr) {
+            throw std::runtime_error("glTF primitive has no position !");
+        }
+
+        instance._positions = getAccessor(document, binary, attributes->index("POSITION"));
+        if (instance._positions._components != 3) {
+            throw std::runtime_error("glTF positions must be 3D vectors !");
+        }
+        if (attributes->get("COLOR_0") != nullptr) {
+            instance._colors = getAccessor(document, binary, attributes->index("COLOR_0"));
+        }
+        if (attributes->get("TEXCOORD_0") != nullptr) {
+            instance._texCoords = getAccessor(document, binary, attributes->index("TEXCOORD_0"));
+        }
+        if (instance._primitive->get("indices") != nullptr) {
+            instance._indices = getAccessor(document, binary, instance._primitive->index("indices"));
+            instance._cornerCount = instance._indices._count - instance._indices._count % 3;
+        } else {
+            instance._cornerCount = instance._positions._count - instance._positions._count % 3;
+        }
+        if (instance._colors._count > 0 && instance._colors._count < instance._positions._count) {
+            throw std::runtime_error("glTF primitive has fewer colors than positions !");
+        }
+        if (instance._texCoords._count > 0 && instance._texCoords._count < instance._positions._count) {
+            throw std::runtime_error("glTF primitive has fewer texture coordinates than positions !");
+        }
+        instance._vertexBase = vertexCount;
+        instance._cornerBase = cornerCount;
+        vertexCount += instance._positions._count;
+        cornerCount += instance._cornerCount;
+    }
+    if (vertexCount > UINT32_MAX || cornerCount > UINT32_MAX) {
+        throw std::runtime_error("GLB file is too large to be indexed with 32-bit indices !");
+    }
+
+    // Vertices are converted and transformed, then corners point into them, both in ranges spread across the workers
+    std::vector<Vertex> vertices(vertexCount);
+    std::vector<uint32_t> cornerVertices(cornerCount);
+    std::vector<std::future<void>> converting;
+
+    for (const GltfPrimitiveInstance& instance : instances) {
+        std::vector<size_t> vertexBounds = this->splitRange(instance._positions._count, GLB_MIN_CHUNK_ELEMENTS);
+        std::vector<size_t> triangleBounds = this->splitRange(instance._cornerCount / 3, GLB_MIN_CHUNK_ELEMENTS);
+
+        for (size_t i = 0; i + 1 < vertexBounds.size(); i++) {
+            converting.push_back(_threadPool.submit([&instance, &vertices, begin = vertexBounds[i], end = vertexBounds[i + 1]] {
+                for (size_t vertex = begin; vertex < end; vertex++) {
+                    Vertex& destination = vertices[instance._vertexBase + vertex];
+
+                    destination.pos = glm::vec3(instance._transform * glm::vec4(glm::vec3(readElement(instance._positions, vertex)), 1.0f));
+                    destination.color = instance._colors._count > 0 ? glm::vec3(readElement(instance._colors, vertex)) : DEFAULT_COLOR;
+                    destination.texCoord = instance._texCoords._count > 0 ? glm::vec2(readElement(instance._texCoords, vertex)) : glm::vec2(0.0f);
+                }
+            }));
+        }
+        for (size_t i = 0; i + 1 < triangleBounds.size(); i++) {
+            converting.push_back(_threadPool.submit([&instance, &cornerVertices, begin = triangleBounds[i], end = triangleBounds[i + 1]] {
+                // Mirroring transforms flip the winding of the triangles, which is restored by swapping two corners
+                bool mirrored = glm::determinant(glm::mat3(instance._transform)) < 0.0f;
+
+                for (size_t triangle = begin; triangle < end; triangle++) {
+                    for (size_t corner = 0; corner < 3; corner++) {
+                        size_t source = triangle * 3 + (mirrored && corner > 0 ? 3 - corner : corner);
+                        uint32_t index = instance._indices._count > 0 ? readIndex(instance._indices, source) : static_cast<uint32_t>(source);
+
+                        if (index >= instance._positions._count) {
+                            throw std::runtime_error("glTF index out of bounds !");
+                        }
+                        cornerVertices[instance._cornerBase + triangle * 3 + corner] = static_cast<uint32_t>(instance._vertexBase + index);
+                    }
+                }
+            }));
+        }
+    }
+    waitForTasks(converting);
+    for (auto& future : converting) {
+        future.get();
+    }
+
+    return this->weld(cornerVertices.size(), [&](size_t corner) {
+        return vertices[cornerVertices[corner]];
+    });
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+template <typename GetCorner>
+maverik::MeshData maverik::MeshLoader::weld(size_t cornerCount, const GetCorner& getCorner)
+{
+    MeshData mesh;
+    std::vector<size_t> bounds = this->splitRange(cornerCount, MIN_CHUNK_CORNERS);
+    std::vector<std::future<std::vector<Vertex>>> localWelds;
+
+    // Every chunk is welded on its own, its corners receiving indices local to the chunk
+    mesh._indices.resize(cornerCount);
+    for (size_t i = 0; i + 1 < bounds.size(); i++) {
+        localWelds.push_back(_threadPool.submit([&mesh, &getCorner, begin = bounds[i], end = bounds[i + 1]] {
+            // Closed meshes share each vertex between about six triangles
+            VertexTable table((end - begin) / 4);
+
+            for (size_t corner = begin; corner < end; corner++) {
+                mesh._indices[corner] = table.insert(getCorner(corner));
+            }
+            return table.release();
+        }));
+    }
+    waitForTasks(localWelds);
+
+    std::vector<std::vector<Vertex>> localVertices;
+    size_t localVertexCount = 0;
+    for (auto& future : localWelds) {
+        localVertices.push_back(future.get());
+        localVertexCount += localVertices.back().size();
+    }
+
+    // Vertices shared across chunks are merged in chunk order, which keeps the output deterministic
+    VertexTable table(localVertexCount);
+    std::vector<std::vector<uint32_t>> remaps(localVertices.size());
+    for (size_t i = 0; i < localVertices.size(); i++) {
+        remaps[i].resize(localVertices[i].size());
+        for (size_t j = 0; j < localVertices[i].size(); j++) {
+            remaps[i][j] = table.insert(localVertices[i][j]);
+        }
+        localVertices[i] = {};
+    }
+    mesh._vertices = table.release();
+
+    std::vector<std::future<void>> remapping;
+    for (size_t i = 0; i + 1 < bounds.size(); i++) {
+        remapping.push_back(_threadPool.submit([&mesh, &remap = remaps[i], begin = bounds[i], end = bounds[i + 1]] {
+            for (size_t corner = begin; corner < end; corner++) {
+                mesh._indices[corner] = remap[mesh._indices[corner]];
+            }
+        }));
+    }
+    waitForTasks(remapping);
+    for (auto& future : remapping) {
+        future.get();
+    }
+    return mesh;
+}
+
+std::vector<size_t> maverik::MeshLoader::splitRange(size_t count, size_t minimumChunkSize) const
+{
+    size_t chunkCount = std::max<size_t>(_threadPool.getThreadCount() * CHUNKS_PER_THREAD, 1);
+    std::vector<size_t> bounds;
+
+    chunkCount = std::min(chunkCount, std::max<size_t>(count / minimumChunkSize, 1));
+    bounds.resize(chunkCount + 1);
+    for (size_t i = 0; i <= chunkCount; i++) {
+        bounds[i] = count * i / chunkCount;
+    }
+    return bounds;
+}
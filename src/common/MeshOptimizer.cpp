@@ -0,0 +1,314 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** MeshOptimizer
+*/
+
+#include "MeshOptimizer.hpp"
+
+#include <numeric>
+#include <algorithm>
+
+/**
+ * @brief Simulated FIFO post-transform cache.
+ *
+ * A vertex is cached while fewer than cacheSize misses happened since it was
+ * loaded, so lookups are constant time whatever the size of the cache.
+ */
+class VertexCacheSimulator {
+    public:
+        VertexCacheSimulator(size_t vertexCount, uint32_t cacheSize)
+            : _timestamps(vertexCount, 0), _cacheSize(cacheSize), _time(cacheSize + 1)
+        {
+        }
+
+        bool isCached(uint32_t vertex) const
+        {
+            return _time - _timestamps[vertex] <= _cacheSize;
+        }
+
+        // Returns whether the access was a miss
+        bool access(uint32_t vertex)
+        {
+            if (this->isCached(vertex)) {
+                return false;
+            }
+            _timestamps[vertex] = _time++;
+            return true;
+        }
+
+        uint32_t countMisses(const uint32_t *triangle)
+        {
+            return this->access(triangle[0]) + this->access(triangle[1]) + this->access(triangle[2]);
+        }
+
+        void flush()
+        {
+            _time += _cacheSize + 1;
+        }
+
+        uint64_t age(uint32_t vertex) const
+        {
+            return _time - _timestamps[vertex];
+        }
+
+    private:
+        std::vector<uint64_t> _timestamps;  // Time each vertex was last loaded at
+        uint64_t _cacheSize;
+        uint64_t _time;                     // Incremented on every miss
+};
+
+/**
+ * @brief Lists the triangles using each vertex.
+ */
+struct TriangleAdjacency {
+    std::vector<uint32_t> _offsets;     // First entry of each vertex in _triangles, plus the total
+    std::vector<uint32_t> _triangles;   // Triangles of every vertex, grouped by vertex
+
+    TriangleAdjacency(const std::vector<uint32_t>& indices, size_t vertexCount)
+        : _offsets(vertexCount + 1, 0), _triangles(indices.size())
+    {
+        for (uint32_t index : indices) {
+            _offsets[index + 1]++;
+        }
+        std::partial_sum(_offsets.begin(), _offsets.end(), _offsets.begin());
+
+        std::vector<uint32_t> cursors(_offsets.begin(), _offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++) {
+            _triangles[cursors[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+};
+
+////////////////////
+// Public methods //
+////////////////////
+
+void maverik::MeshOptimizer::optimize(MeshData& mesh)
+{
+    std::vector<size_t> clusters = optimizeVertexCache(mesh._indices, mesh._vertices.size());
+
+    optimizeOverdraw(mesh._indices, mesh._vertices, clusters);
+    optimizeVertexFetch(mesh._vertices, mesh._indices);
+}
+
+std::vector<size_t> maverik::MeshOptimizer::optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize)
+{
+    size_t triangleCount = indices.size() / 3;
+    std::vector<size_t> clusters;
+
+    if (triangleCount == 0) {
+        return clusters;
+    }
+
+    TriangleAdjacency adjacency(indices, vertexCount);
+    std::vector<uint32_t> liveTriangles(vertexCount);
+    for (size_t vertex = 0; vertex < vertexCount; vertex++) {
+        liveTriangles[vertex] = adjacency._offsets[vertex + 1] - adjacency._offsets[vertex];
+    }
+
+    VertexCacheSimulator cache(vertexCount, cacheSize);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEnds;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> output;
+    size_t scan = 0;
+    int64_t fanning = indices[0];
+
+    output.reserve(triangleCount * 3);
+    clusters.push_back(0);
+    while (fanning >= 0) {
+        candidates.clear();
+
+        // Emit every remaining triangle around the fanning vertex
+        for (uint32_t entry = adjacency._offsets[fanning]; entry < adjacency._offsets[fanning + 1]; entry++) {
+            uint32_t triangle = adjacency._triangles[entry];
+
+            if (emitted[triangle]) {
+                continue;
+            }
+            emitted[triangle] = true;
+            for (size_t corner = 0; corner < 3; corner++) {
+                uint32_t vertex = indices[triangle * 3 + corner];
+
+                output.push_back(vertex);
+                deadEnds.push_back(vertex);
+                candidates.push_back(vertex);
+                liveTriangles[vertex]--;
+                cache.access(vertex);
+            }
+        }
+
+        // Prefer the candidate that stays cached while its remaining triangles are emitted, oldest first
+        int64_t next = -1;
+        int64_t bestPriority = -1;
+        for (uint32_t vertex : candidates) {
+            if (liveTriangles[vertex] == 0) {
+                continue;
+            }
+
+            int64_t priority = 0;
+            if (cache.age(vertex) + 2 * liveTriangles[vertex] <= cacheSize) {
+                priority = static_cast<int64_t>(cache.age(vertex));
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                next = vertex;
+            }
+        }
+
+        if (next < 0) {
+            // Dead end: resume from a recently used vertex, or from the next unfinished one in input order
+            while (!deadEnds.empty() && next < 0) {
+                uint32_t vertex = deadEnds.back();
+
+                deadEnds.pop_back();
+                if (liveTriangles[vertex] > 0) {
+                    next = vertex;
+                }
+            }
+            while (next < 0 && scan < indices.size()) {
+                uint32_t vertex = indices[scan++];
+
+                if (liveTriangles[vertex] > 0) {
+                    next = vertex;
+                }
+            }
+            if (next >= 0 && output.size() / 3 < triangleCount) {
+                clusters.push_back(output.size() / 3);
+            }
+        }
+        fanning = next;
+    }
+
+    indices = std::move(output);
+    return clusters;
+}
+
+void maverik::MeshOptimizer::optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, const std::vector<size_t>& clusters,
+    float threshold, uint32_t cacheSize)
+{
+    size_t triangleCount = indices.size() / 3;
+
+    if (triangleCount == 0 || clusters.empty()) {
+        return;
+    }
+
+    // Split the clusters wherever the triangles drawn so far already match the cache efficiency of the whole cluster
+    VertexCacheSimulator cache(vertices.size(), cacheSize);
+    std::vector<size_t> splits;
+    for (size_t i = 0; i < clusters.size(); i++) {
+        size_t begin = clusters[i];
+        size_t end = i + 1 < clusters.size() ? clusters[i + 1] : triangleCount;
+        uint64_t clusterMisses = 0;
+
+        cache.flush();
+        for (size_t triangle = begin; triangle < end; triangle++) {
+            clusterMisses += cache.countMisses(&indices[triangle * 3]);
+        }
+
+        float targetRatio = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+        uint64_t misses = 0;
+        size_t start = begin;
+
+        splits.push_back(begin);
+        cache.flush();
+        for (size_t triangle = begin; triangle + 1 < end; triangle++) {
+            misses += cache.countMisses(&indices[triangle * 3]);
+            if (static_cast<float>(misses) / static_cast<float>(triangle + 1 - start) <= targetRatio) {
+                start = triangle + 1;
+                splits.push_back(start);
+                misses = 0;
+                cache.flush();
+            }
+        }
+    }
+    splits.push_back(triangleCount);
+
+    // Clusters facing away from the center of the mesh are on its outside, they are drawn first
+    glm::vec3 meshCenter(0.0f);
+    for (const Vertex& vertex : vertices) {
+        meshCenter += vertex.pos;
+    }
+    meshCenter /= static_cast<float>(std::max<size_t>(vertices.size(), 1));
+
+    std::vector<float> sortKeys(splits.size() - 1);
+    for (size_t i = 0; i + 1 < splits.size(); i++) {
+        glm::vec3 center(0.0f);
+        glm::vec3 normal(0.0f);
+        float area = 0.0f;
+
+        for (size_t triangle = splits[i]; triangle < splits[i + 1]; triangle++) {
+            const glm::vec3& a = vertices[indices[triangle * 3]].pos;
+            const glm::vec3& b = vertices[indices[triangle * 3 + 1]].pos;
+            const glm::vec3& c = vertices[indices[triangle * 3 + 2]].pos;
+            glm::vec3 cross = glm::cross(b - a, c - a);
+            float triangleArea = glm::length(cross);
+
+            center += (a + b + c) * (triangleArea / 3.0f);
+            normal += cross;
+            area += triangleArea;
+        }
+
+        float normalLength = glm::length(normal);
+        if (area > 0.0f && normalLength > 0.0f) {
+            sortKeys[i] = glm::dot(center / area - meshCenter, normal / normalLength);
+        } else {
+            sortKeys[i] = 0.0f;
+        }
+    }
+
+    std::vector<size_t> order(sortKeys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&sortKeys](size_t a, size_t b) { return sortKeys[a] > sortKeys[b]; });
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    for (size_t cluster : order) {
+        output.insert(output.end(), indices.begin() + splits[cluster] * 3, indices.begin() + splits[cluster + 1] * 3);
+    }
+    indices = std::move(output);
+}
+
+void maverik::MeshOptimizer::optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+    constexpr uint32_t UNUSED = UINT32_MAX;
+    std::vector<uint32_t> remap(vertices.size(), UNUSED);
+    std::vector<Vertex> output;
+
+    output.reserve(vertices.size());
+    for (uint32_t& index : indices) {
+        if (remap[index] == UNUSED) {
+            remap[index] = static_cast<uint32_t>(output.size());
+            output.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+    vertices = std::move(output);
+}
+
+float maverik::MeshOptimizer::computeAcmr(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize)
+{
+    size_t triangleCount = indices.size() / 3;
+    VertexCacheSimulator cache(vertexCount, cacheSize);
+    uint64_t misses = 0;
+
+    if (triangleCount == 0) {
+        return 0.0f;
+    }
+    for (size_t triangle = 0; triangle < triangleCount; triangle++) {
+        misses += cache.countMisses(&indices[triangle * 3]);
+    }
+    return static_cast<float>(misses) / static_cast<float>(triangleCount);
+}
+
+VkIndexType maverik::MeshOptimizer::selectIndexType(size_t vertexCount)
+{
+    return vertexCount <= UINT16_MAX ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+}
+
+std::vector<uint16_t> maverik::MeshOptimizer::narrowIndices(const std::vector<uint32_t>& indices)
+{
+    return std::vector<uint16_t>(indices.begin(), indices.end());
+}
@@ -0,0 +1,349 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** MeshSimplifier
+*/
+
+#include "MeshSimplifier.hpp"
+#include "MeshOptimizer.hpp"
+
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+
+/*
+ * Collapses turning a triangle by more than about 75 degrees are rejected as flips.
+ */
+static constexpr float MIN_NORMAL_COS = 0.25f;
+
+/*
+ * Levels keeping more of the triangles of the previous one are not worth their indices.
+ */
+static constexpr float MAX_LOD_SHRINK = 0.9f;
+
+/*
+ * Distances below this are clamped when projecting errors on screen.
+ */
+static constexpr float MIN_LOD_DISTANCE = 1e-4f;
+
+/**
+ * @brief Sum of squared distances to a set of planes, weighted by the area of their triangles.
+ */
+struct Quadric {
+    double _a00 = 0.0, _a01 = 0.0, _a02 = 0.0, _a11 = 0.0, _a12 = 0.0, _a22 = 0.0;
+    double _b0 = 0.0, _b1 = 0.0, _b2 = 0.0;
+    double _c = 0.0;
+    double _weight = 0.0;   // Total area of the planes
+
+    Quadric() = default;
+
+    // Plane of unit normal n through p, scaled by weight
+    Quadric(const glm::vec3& n, const glm::vec3& p, double weight)
+    {
+        double d = -(static_cast<double>(n.x) * p.x + static_cast<double>(n.y) * p.y + static_cast<double>(n.z) * p.z);
+
+        _a00 = weight * n.x * n.x;
+        _a01 = weight * n.x * n.y;
+        _a02 = weight * n.x * n.z;
+        _a11 = weight * n.y * n.y;
+        _a12 = weight * n.y * n.z;
+        _a22 = weight * n.z * n.z;
+        _b0 = weight * n.x * d;
+        _b1 = weight * n.y * d;
+        _b2 = weight * n.z * d;
+        _c = weight * d * d;
+        _weight = weight;
+    }
+
+    void add(const Quadric& other)
+    {
+        _a00 += other._a00;
+        _a01 += other._a01;
+        _a02 += other._a02;
+        _a11 += other._a11;
+        _a12 += other._a12;
+        _a22 += other._a22;
+        _b0 += other._b0;
+        _b1 += other._b1;
+        _b2 += other._b2;
+        _c += other._c;
+        _weight += other._weight;
+    }
+
+    // Root mean square distance from p to the planes
+    float distance(const glm::vec3& p) const
+    {
+        if (_weight <= 0.0) {
+            return 0.0f;
+        }
+        double x = p.x, y = p.y, z = p.z;
+        double error = _a00 * x * x + _a11 * y * y + _a22 * z * z
+            + 2.0 * (_a01 * x * y + _a02 * x * z + _a12 * y * z)
+            + 2.0 * (_b0 * x + _b1 * y + _b2 * z) + _c;
+
+        return static_cast<float>(std::sqrt(std::max(error, 0.0) / _weight));
+    }
+};
+
+/**
+ * @brief A vertex merged into one of its neighbours.
+ */
+struct Collapse {
+    uint32_t _from;     // Vertex removed
+    uint32_t _to;       // Vertex its triangles are moved to
+    float _error;       // Distance introduced, per the quadric of _from
+};
+
+/**
+ * @brief Maps every vertex to the first vertex sharing its position.
+ */
+static std::vector<uint32_t> buildPositionRemap(const std::vector<maverik::Vertex>& vertices)
+{
+    std::vector<uint32_t> order(vertices.size());
+    std::vector<uint32_t> remap(vertices.size());
+
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        const glm::vec3& pa = vertices[a].pos;
+        const glm::vec3& pb = vertices[b].pos;
+        if (pa.x != pb.x) {
+            return pa.x < pb.x;
+        }
+        if (pa.y != pb.y) {
+            return pa.y < pb.y;
+        }
+        if (pa.z != pb.z) {
+            return pa.z < pb.z;
+        }
+        return a < b;
+    });
+    for (size_t i = 0; i < order.size(); i++) {
+        bool samePosition = i > 0 && vertices[order[i]].pos == vertices[order[i - 1]].pos;
+        remap[order[i]] = samePosition ? remap[order[i - 1]] : order[i];
+    }
+    return remap;
+}
+
+////////////////////
+// Public methods //
+////////////////////
+
+std::vector<uint32_t> maverik::MeshSimplifier::simplify(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+    size_t targetIndexCount, float maxError, float *resultError)
+{
+    size_t vertexCount = vertices.size();
+    std::vector<uint32_t> result(indices);
+    float error = 0.0f;
+
+    // Topology is built on positions, vertices of an attribute seam count as one
+    std::vector<uint32_t> position = buildPositionRemap(vertices);
+    std::vector<bool> locked(vertexCount, false);
+    for (uint32_t vertex = 0; vertex < vertexCount; vertex++) {
+        if (position[vertex] != vertex) {
+            locked[position[vertex]] = true;
+        }
+    }
+
+    // Edges not shared by exactly two triangles are borders or non-manifold
+    std::vector<uint64_t> edges;
+    edges.reserve(result.size());
+    for (size_t i = 0; i + 2 < result.size(); i += 3) {
+        for (size_t corner = 0; corner < 3; corner++) {
+            uint64_t a = position[result[i + corner]];
+            uint64_t b = position[result[i + (corner + 1) % 3]];
+            edges.push_back(std::min(a, b) << 32 | std::max(a, b));
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    for (size_t begin = 0, end = 0; begin < edges.size(); begin = end) {
+        while (end < edges.size() && edges[end] == edges[begin]) {
+            end++;
+        }
+        if (end - begin != 2) {
+            locked[edges[begin] >> 32] = true;
+            locked[edges[begin] & UINT32_MAX] = true;
+        }
+    }
+
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t i = 0; i + 2 < result.size(); i += 3) {
+        const glm::vec3& p0 = vertices[result[i]].pos;
+        glm::vec3 normal = glm::cross(vertices[result[i + 1]].pos - p0, vertices[result[i + 2]].pos - p0);
+        float length = glm::length(normal);
+        if (length == 0.0f) {
+            continue;
+        }
+        Quadric plane(normal / length, p0, 0.5 * length);
+        for (size_t corner = 0; corner < 3; corner++) {
+            quadrics[position[result[i + corner]]].add(plane);
+        }
+    }
+
+    auto isCollapsible = [&](uint32_t vertex) {
+        return !locked[position[vertex]];
+    };
+    // Whether moving the triangles of from onto to turns one of them over
+    auto flips = [&](const std::vector<uint32_t>& offsets, const std::vector<uint32_t>& triangles, uint32_t from, uint32_t to) {
+        for (uint32_t entry = offsets[from]; entry < offsets[from + 1]; entry++) {
+            const uint32_t *triangle = &result[triangles[entry] * 3];
+            glm::vec3 corners[3];
+            bool collapsed = false;
+            for (size_t corner = 0; corner < 3; corner++) {
+                collapsed = collapsed || position[triangle[corner]] == position[to];
+                corners[corner] = vertices[triangle[corner]].pos;
+            }
+            if (collapsed) {
+                continue;
+            }
+            glm::vec3 before = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+            for (size_t corner = 0; corner < 3; corner++) {
+                if (triangle[corner] == from) {
+                    corners[corner] = vertices[to].pos;
+                }
+            }
+            glm::vec3 after = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+            if (glm::dot(before, after) <= MIN_NORMAL_COS * glm::length(before) * glm::length(after)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<bool> touched(vertexCount);
+    std::vector<Collapse> collapses;
+    while (result.size() > targetIndexCount) {
+        size_t triangleCount = result.size() / 3;
+
+        // Triangles of every vertex, grouped by vertex
+        std::vector<uint32_t> offsets(vertexCount + 1, 0);
+        std::vector<uint32_t> triangles(triangleCount * 3);
+        for (size_t i = 0; i < triangleCount * 3; i++) {
+            offsets[result[i] + 1]++;
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < triangleCount * 3; i++) {
+            triangles[cursors[result[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        collapses.clear();
+        for (size_t i = 0; i < triangleCount * 3; i++) {
+            uint32_t a = result[i];
+            uint32_t b = result[i - i % 3 + (i + 1) % 3];
+            if (isCollapsible(a)) {
+                collapses.push_back({a, b, quadrics[position[a]].distance(vertices[b].pos)});
+            }
+            if (isCollapsible(b)) {
+                collapses.push_back({b, a, quadrics[position[b]].distance(vertices[a].pos)});
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) {
+            if (a._error != b._error) {
+                return a._error < b._error;
+            }
+            return a._from != b._from ? a._from < b._from : a._to < b._to;
+        });
+
+        // Collapses of a pass touch disjoint neighbourhoods, so each one is checked against the current triangles
+        std::iota(remap.begin(), remap.end(), 0);
+        std::fill(touched.begin(), touched.end(), false);
+        size_t removeCount = (result.size() - targetIndexCount + 2) / 3;
+        size_t removed = 0;
+        for (const Collapse& collapse : collapses) {
+            if (collapse._error > maxError || removed >= removeCount) {
+                break;
+            }
+            uint32_t from = collapse._from;
+            uint32_t to = collapse._to;
+            if (touched[position[from]] || touched[position[to]] || position[from] == position[to] || flips(offsets, triangles, from, to)) {
+                continue;
+            }
+            remap[from] = to;
+            quadrics[position[to]].add(quadrics[position[from]]);
+            error = std::max(error, collapse._error);
+            for (uint32_t entry = offsets[from]; entry < offsets[from + 1]; entry++) {
+                const uint32_t *triangle = &result[triangles[entry] * 3];
+                bool collapsed = false;
+                for (size_t corner = 0; corner < 3; corner++) {
+                    touched[position[triangle[corner]]] = true;
+                    collapsed = collapsed || position[triangle[corner]] == position[to];
+                }
+                removed += collapsed;
+            }
+        }
+        if (removed == 0) {
+            break;
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < triangleCount * 3; i += 3) {
+            uint32_t a = remap[result[i]];
+            uint32_t b = remap[result[i + 1]];
+            uint32_t c = remap[result[i + 2]];
+            if (position[a] == position[b] || position[b] == position[c] || position[a] == position[c]) {
+                continue;
+            }
+            result[kept++] = a;
+            result[kept++] = b;
+            result[kept++] = c;
+        }
+        result.resize(kept);
+    }
+
+    if (resultError) {
+        *resultError = error;
+    }
+    return result;
+}
+
+std::vector<maverik::LodLevel> maverik::MeshSimplifier::generateLods(MeshData& mesh, uint32_t maxLevels, float reduction)
+{
+    std::vector<LodLevel> levels = {{0, static_cast<uint32_t>(mesh._indices.size()), 0.0f}};
+    std::vector<uint32_t> current = mesh._indices;
+
+    for (uint32_t level = 1; level < maxLevels; level++) {
+        size_t targetIndexCount = static_cast<size_t>(static_cast<float>(current.size() / 3) * reduction) * 3;
+        float levelError = 0.0f;
+        std::vector<uint32_t> simplified = simplify(mesh._vertices, current, targetIndexCount, FLT_MAX, &levelError);
+
+        if (simplified.empty() || static_cast<float>(simplified.size()) > static_cast<float>(current.size()) * MAX_LOD_SHRINK) {
+            break;
+        }
+        MeshOptimizer::optimizeVertexCache(simplified, mesh._vertices.size());
+
+        // Each level is measured against the previous one, errors add up along the chain
+        levels.push_back({static_cast<uint32_t>(mesh._indices.size()), static_cast<uint32_t>(simplified.size()), levels.back()._error + levelError});
+        mesh._indices.insert(mesh._indices.end(), simplified.begin(), simplified.end());
+        current = std::move(simplified);
+    }
+    return levels;
+}
+
+maverik::LodSelection maverik::MeshSimplifier::selectLod(const std::vector<LodLevel>& levels, float distance, float projectionScale,
+    float pixelError, float fadeRange)
+{
+    LodSelection selection;
+    float scale = projectionScale / std::max(distance, MIN_LOD_DISTANCE);
+
+    while (selection._level + 1 < levels.size() && levels[selection._level + 1]._error * scale <= pixelError) {
+        selection._level++;
+    }
+    selection._fadeLevel = selection._level;
+
+    if (fadeRange > 0.0f && selection._level + 1 < levels.size()) {
+        float nextError = levels[selection._level + 1]._error * scale;
+        float fadeStart = pixelError * (1.0f + fadeRange);
+        if (nextError < fadeStart) {
+            selection._fadeLevel = selection._level + 1;
+            selection._fade = (fadeStart - nextError) / (fadeStart - pixelError);
+        }
+    }
+    return selection;
+}
+
+float maverik::MeshSimplifier::getProjectionScale(float fovY, float viewportHeight)
+{
+    return viewportHeight / (2.0f * std::tan(fovY * 0.5f));
+}
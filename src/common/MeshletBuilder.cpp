@@ -0,0 +1,234 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** MeshletBuilder
+*/
+
+#include "MeshletBuilder.hpp"
+
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <algorithm>
+
+/*
+ * Normal cones wider than a half sphere, down to this margin, cannot reject anything.
+ */
+static constexpr float MIN_CONE_DOT = 1e-3f;
+
+////////////////////
+// Public methods //
+////////////////////
+
+std::vector<maverik::Meshlet> maverik::MeshletBuilder::build(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+    uint32_t maxVertices, uint32_t maxTriangles)
+{
+    if (maxVertices < 3 || maxTriangles < 1) {
+        throw std::runtime_error("Meshlets must hold at least one triangle !");
+    }
+
+    size_t triangleCount = indices.size() / 3;
+    std::vector<Meshlet> meshlets;
+
+    // Triangles of every vertex, grouped by vertex
+    std::vector<uint32_t> adjacencyOffsets(vertices.size() + 1, 0);
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    for (size_t i = 0; i < triangleCount * 3; i++) {
+        adjacencyOffsets[indices[i] + 1]++;
+    }
+    std::partial_sum(adjacencyOffsets.begin(), adjacencyOffsets.end(), adjacencyOffsets.begin());
+    std::vector<uint32_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (size_t i = 0; i < triangleCount * 3; i++) {
+        adjacency[cursors[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    constexpr uint32_t NO_MESHLET = UINT32_MAX;
+    std::vector<uint32_t> vertexMeshlet(vertices.size(), NO_MESHLET);     // Last meshlet each vertex was added to
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> meshletVertices;
+    std::vector<uint32_t> previousVertices;
+    std::vector<uint32_t> output;
+    glm::vec3 positionSum(0.0f);
+    uint32_t meshletTriangles = 0;
+    size_t scan = 0;
+
+    output.reserve(triangleCount * 3);
+    meshlets.reserve(triangleCount / maxTriangles + 1);
+
+    auto countNewVertices = [&](uint32_t triangle) {
+        uint32_t id = static_cast<uint32_t>(meshlets.size());
+        return static_cast<uint32_t>((vertexMeshlet[indices[triangle * 3]] != id) + (vertexMeshlet[indices[triangle * 3 + 1]] != id)
+            + (vertexMeshlet[indices[triangle * 3 + 2]] != id));
+    };
+    auto findSeed = [&]() {
+        // Start next to the previous meshlet so that consecutive meshlets stay close
+        for (uint32_t vertex : previousVertices) {
+            for (uint32_t entry = adjacencyOffsets[vertex]; entry < adjacencyOffsets[vertex + 1]; entry++) {
+                if (!emitted[adjacency[entry]]) {
+                    return adjacency[entry];
+                }
+            }
+        }
+        while (emitted[scan]) {
+            scan++;
+        }
+        return static_cast<uint32_t>(scan);
+    };
+    auto closeMeshlet = [&]() {
+        Meshlet meshlet{};
+
+        meshlet._indexCount = meshletTriangles * 3;
+        meshlet._firstIndex = static_cast<uint32_t>(output.size()) - meshlet._indexCount;
+        meshlet._vertexCount = static_cast<uint32_t>(meshletVertices.size());
+        meshlets.push_back(meshlet);
+        // Vertex marks hold the index of their meshlet, so they no longer match the next one
+        previousVertices = std::move(meshletVertices);
+        meshletVertices.clear();
+        positionSum = glm::vec3(0.0f);
+        meshletTriangles = 0;
+    };
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+        int64_t best = -1;
+        uint32_t bestNewVertices = 0;
+        float bestDistance = std::numeric_limits<float>::max();
+
+        if (!meshletVertices.empty()) {
+            glm::vec3 center = positionSum / static_cast<float>(meshletVertices.size());
+
+            for (uint32_t vertex : meshletVertices) {
+                for (uint32_t entry = adjacencyOffsets[vertex]; entry < adjacencyOffsets[vertex + 1]; entry++) {
+                    uint32_t triangle = adjacency[entry];
+                    if (emitted[triangle]) {
+                        continue;
+                    }
+
+                    uint32_t newVertices = countNewVertices(triangle);
+                    if (meshletVertices.size() + newVertices > maxVertices) {
+                        continue;
+                    }
+
+                    glm::vec3 offset = (vertices[indices[triangle * 3]].pos + vertices[indices[triangle * 3 + 1]].pos
+                        + vertices[indices[triangle * 3 + 2]].pos) * (1.0f / 3.0f) - center;
+                    float distance = glm::dot(offset, offset);
+                    if (best < 0 || newVertices < bestNewVertices || (newVertices == bestNewVertices && distance < bestDistance)) {
+                        best = triangle;
+                        bestNewVertices = newVertices;
+                        bestDistance = distance;
+                    }
+                }
+            }
+        }
+
+        // Nothing left around the meshlet fits in it, start a new one
+        if (best < 0) {
+            if (meshletTriangles > 0) {
+                closeMeshlet();
+            }
+            best = findSeed();
+        }
+
+        uint32_t triangle = static_cast<uint32_t>(best);
+        uint32_t id = static_cast<uint32_t>(meshlets.size());
+        emitted[triangle] = true;
+        for (size_t corner = 0; corner < 3; corner++) {
+            uint32_t vertex = indices[triangle * 3 + corner];
+
+            if (vertexMeshlet[vertex] != id) {
+                vertexMeshlet[vertex] = id;
+                meshletVertices.push_back(vertex);
+                positionSum += vertices[vertex].pos;
+            }
+            output.push_back(vertex);
+        }
+        if (++meshletTriangles == maxTriangles) {
+            closeMeshlet();
+        }
+    }
+    if (meshletTriangles > 0) {
+        closeMeshlet();
+    }
+
+    indices = std::move(output);
+    for (Meshlet& meshlet : meshlets) {
+        computeBounds(vertices, indices, meshlet);
+    }
+    return meshlets;
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+void maverik::MeshletBuilder::computeBounds(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, Meshlet& meshlet)
+{
+    const uint32_t *first = indices.data() + meshlet._firstIndex;
+    const uint32_t *last = first + meshlet._indexCount;
+
+    // Ritter's sphere: start from two distant points, then grow to enclose the others
+    auto farthestFrom = [&](const glm::vec3& point) {
+        glm::vec3 farthest = point;
+        float farthestDistance = -1.0f;
+
+        for (const uint32_t *index = first; index != last; index++) {
+            glm::vec3 offset = vertices[*index].pos - point;
+            float distance = glm::dot(offset, offset);
+            if (distance > farthestDistance) {
+                farthestDistance = distance;
+                farthest = vertices[*index].pos;
+            }
+        }
+        return farthest;
+    };
+    glm::vec3 a = farthestFrom(vertices[*first].pos);
+    glm::vec3 b = farthestFrom(a);
+    glm::vec3 center = (a + b) * 0.5f;
+    float radius = glm::length(b - a) * 0.5f;
+
+    for (const uint32_t *index = first; index != last; index++) {
+        const glm::vec3& position = vertices[*index].pos;
+        float distance = glm::length(position - center);
+
+        if (distance > radius) {
+            float grownRadius = (radius + distance) * 0.5f;
+            center += (position - center) * ((grownRadius - radius) / distance);
+            radius = grownRadius;
+        }
+    }
+    meshlet._center = center;
+    meshlet._radius = radius;
+
+    // Normal cone: the axis averages the triangle normals, the cutoff follows the normal farthest from it
+    std::vector<glm::vec3> normals;
+    glm::vec3 axis(0.0f);
+    normals.reserve(meshlet._indexCount / 3);
+    for (const uint32_t *triangle = first; triangle != last; triangle += 3) {
+        const glm::vec3& p0 = vertices[triangle[0]].pos;
+        glm::vec3 normal = glm::cross(vertices[triangle[1]].pos - p0, vertices[triangle[2]].pos - p0);
+        float length = glm::length(normal);
+
+        if (length > 0.0f) {
+            normals.push_back(normal / length);
+            axis += normals.back();
+        }
+    }
+
+    float axisLength = glm::length(axis);
+    meshlet._coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+    meshlet._coneCutoff = 1.0f;
+    if (normals.empty() || axisLength <= 0.0f) {
+        return;
+    }
+    axis /= axisLength;
+
+    float minimumDot = 1.0f;
+    for (const glm::vec3& normal : normals) {
+        minimumDot = std::min(minimumDot, glm::dot(normal, axis));
+    }
+    meshlet._coneAxis = axis;
+    if (minimumDot > MIN_CONE_DOT) {
+        meshlet._coneCutoff = std::sqrt(1.0f - minimumDot * minimumDot);
+    }
+}
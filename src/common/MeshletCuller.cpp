@@ -0,0 +1,212 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** MeshletCuller
+*/
+
+#include "MeshletCuller.hpp"
+
+#include <bit>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define MAVERIK_CULL_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define MAVERIK_CULL_NEON
+#endif
+
+/*
+ * Radius of the padding meshlets, no sphere test can accept them.
+ */
+static constexpr float PADDING_RADIUS = -1e30f;
+
+namespace {
+    /*
+     * Frustum planes and camera position, each component broadcast for the SIMD tests.
+     */
+    struct CullingView {
+        float _planes[6][4];
+        float _camera[3];
+    };
+
+    /*
+     * Returns a bit per meshlet of a group of four, set if the meshlet is visible.
+     */
+    inline uint32_t cullGroup(const CullingView& view, const float *centerX, const float *centerY, const float *centerZ, const float *radius,
+        const float *axisX, const float *axisY, const float *axisZ, const float *cutoff)
+    {
+#if defined(MAVERIK_CULL_SSE2)
+        __m128 x = _mm_loadu_ps(centerX);
+        __m128 y = _mm_loadu_ps(centerY);
+        __m128 z = _mm_loadu_ps(centerZ);
+        __m128 r = _mm_loadu_ps(radius);
+        __m128 negativeR = _mm_sub_ps(_mm_setzero_ps(), r);
+        __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+        for (const float *plane : view._planes) {
+            __m128 distance = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[0]), x), _mm_mul_ps(_mm_set1_ps(plane[1]), y)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[2]), z), _mm_set1_ps(plane[3])));
+            visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, negativeR));
+        }
+
+        __m128 dx = _mm_sub_ps(x, _mm_set1_ps(view._camera[0]));
+        __m128 dy = _mm_sub_ps(y, _mm_set1_ps(view._camera[1]));
+        __m128 dz = _mm_sub_ps(z, _mm_set1_ps(view._camera[2]));
+        __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, _mm_loadu_ps(axisX)), _mm_mul_ps(dy, _mm_loadu_ps(axisY))), _mm_mul_ps(dz, _mm_loadu_ps(axisZ)));
+        __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+        __m128 backFacing = _mm_cmpgt_ps(dot, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(cutoff), length), r));
+
+        return static_cast<uint32_t>(_mm_movemask_ps(_mm_andnot_ps(backFacing, visible)));
+#elif defined(MAVERIK_CULL_NEON)
+        float32x4_t x = vld1q_f32(centerX);
+        float32x4_t y = vld1q_f32(centerY);
+        float32x4_t z = vld1q_f32(centerZ);
+        float32x4_t r = vld1q_f32(radius);
+        float32x4_t negativeR = vnegq_f32(r);
+        uint32x4_t visible = vdupq_n_u32(0xFFFFFFFF);
+
+        for (const float *plane : view._planes) {
+            float32x4_t distance = vdupq_n_f32(plane[3]);
+            distance = vmlaq_n_f32(distance, x, plane[0]);
+            distance = vmlaq_n_f32(distance, y, plane[1]);
+            distance = vmlaq_n_f32(distance, z, plane[2]);
+            visible = vandq_u32(visible, vcgeq_f32(distance, negativeR));
+        }
+
+        float32x4_t dx = vsubq_f32(x, vdupq_n_f32(view._camera[0]));
+        float32x4_t dy = vsubq_f32(y, vdupq_n_f32(view._camera[1]));
+        float32x4_t dz = vsubq_f32(z, vdupq_n_f32(view._camera[2]));
+        float32x4_t dot = vmulq_f32(dx, vld1q_f32(axisX));
+        dot = vmlaq_f32(dot, dy, vld1q_f32(axisY));
+        dot = vmlaq_f32(dot, dz, vld1q_f32(axisZ));
+        float32x4_t squaredLength = vmulq_f32(dx, dx);
+        squaredLength = vmlaq_f32(squaredLength, dy, dy);
+        squaredLength = vmlaq_f32(squaredLength, dz, dz);
+        float lengths[4];
+        vst1q_f32(lengths, squaredLength);
+        for (float& length : lengths) {
+            length = std::sqrt(length);
+        }
+        uint32x4_t backFacing = vcgtq_f32(dot, vmlaq_f32(r, vld1q_f32(cutoff), vld1q_f32(lengths)));
+        visible = vbicq_u32(visible, backFacing);
+
+        return (vgetq_lane_u32(visible, 0) & 1) | (vgetq_lane_u32(visible, 1) & 2) | (vgetq_lane_u32(visible, 2) & 4) | (vgetq_lane_u32(visible, 3) & 8);
+#else
+        uint32_t mask = 0;
+
+        for (int i = 0; i < 4; i++) {
+            bool visible = true;
+
+            for (const float *plane : view._planes) {
+                visible = visible && plane[0] * centerX[i] + plane[1] * centerY[i] + plane[2] * centerZ[i] + plane[3] >= -radius[i];
+            }
+
+            float dx = centerX[i] - view._camera[0];
+            float dy = centerY[i] - view._camera[1];
+            float dz = centerZ[i] - view._camera[2];
+            float dot = dx * axisX[i] + dy * axisY[i] + dz * axisZ[i];
+            float length = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+            if (visible && !(dot > cutoff[i] * length + radius[i])) {
+                mask |= 1u << i;
+            }
+        }
+        return mask;
+#endif
+    }
+}
+
+////////////////////
+// Public methods //
+////////////////////
+
+maverik::MeshletCuller::MeshletCuller(const std::vector<Meshlet>& meshlets)
+{
+    size_t paddedCount = (meshlets.size() + 3) & ~static_cast<size_t>(3);
+
+    _centerX.assign(paddedCount, 0.0f);
+    _centerY.assign(paddedCount, 0.0f);
+    _centerZ.assign(paddedCount, 0.0f);
+    _radius.assign(paddedCount, PADDING_RADIUS);
+    _coneAxisX.assign(paddedCount, 0.0f);
+    _coneAxisY.assign(paddedCount, 0.0f);
+    _coneAxisZ.assign(paddedCount, 0.0f);
+    _coneCutoff.assign(paddedCount, 1.0f);
+    _firstIndices.reserve(meshlets.size());
+    _indexCounts.reserve(meshlets.size());
+
+    for (size_t i = 0; i < meshlets.size(); i++) {
+        _centerX[i] = meshlets[i]._center.x;
+        _centerY[i] = meshlets[i]._center.y;
+        _centerZ[i] = meshlets[i]._center.z;
+        _radius[i] = meshlets[i]._radius;
+        _coneAxisX[i] = meshlets[i]._coneAxis.x;
+        _coneAxisY[i] = meshlets[i]._coneAxis.y;
+        _coneAxisZ[i] = meshlets[i]._coneAxis.z;
+        _coneCutoff[i] = meshlets[i]._coneCutoff;
+        _firstIndices.push_back(meshlets[i]._firstIndex);
+        _indexCounts.push_back(meshlets[i]._indexCount);
+    }
+}
+
+void maverik::MeshletCuller::cull(const glm::mat4& viewProjection, const glm::vec3& cameraPosition, std::vector<DrawRange>& ranges) const
+{
+    std::array<glm::vec4, 6> planes = extractFrustumPlanes(viewProjection);
+    CullingView view{};
+
+    ranges.clear();
+    for (size_t i = 0; i < planes.size(); i++) {
+        for (int component = 0; component < 4; component++) {
+            view._planes[i][component] = planes[i][component];
+        }
+    }
+    view._camera[0] = cameraPosition.x;
+    view._camera[1] = cameraPosition.y;
+    view._camera[2] = cameraPosition.z;
+
+    for (size_t group = 0; group < _radius.size(); group += 4) {
+        uint32_t mask = cullGroup(view, &_centerX[group], &_centerY[group], &_centerZ[group], &_radius[group],
+            &_coneAxisX[group], &_coneAxisY[group], &_coneAxisZ[group], &_coneCutoff[group]);
+
+        for (; mask != 0; mask &= mask - 1) {
+            size_t meshlet = group + static_cast<size_t>(std::countr_zero(mask));
+
+            // Consecutive visible meshlets are contiguous in the index buffer, draw them at once
+            if (!ranges.empty() && ranges.back()._firstIndex + ranges.back()._indexCount == _firstIndices[meshlet]) {
+                ranges.back()._indexCount += _indexCounts[meshlet];
+            } else {
+                ranges.push_back({_firstIndices[meshlet], _indexCounts[meshlet]});
+            }
+        }
+    }
+}
+
+std::array<glm::vec4, 6> maverik::MeshletCuller::extractFrustumPlanes(const glm::mat4& viewProjection)
+{
+    // Rows of the matrix, glm matrices being indexed by column
+    glm::vec4 rows[4];
+    for (int row = 0; row < 4; row++) {
+        rows[row] = glm::vec4(viewProjection[0][row], viewProjection[1][row], viewProjection[2][row], viewProjection[3][row]);
+    }
+
+    std::array<glm::vec4, 6> planes = {
+        rows[3] + rows[0],      // Left
+        rows[3] - rows[0],      // Right
+        rows[3] + rows[1],      // Bottom
+        rows[3] - rows[1],      // Top
+        rows[2],                // Near, depth starts at 0
+        rows[3] - rows[2]       // Far
+    };
+    for (glm::vec4& plane : planes) {
+        float length = glm::length(glm::vec3(plane));
+
+        if (length > 0.0f) {
+            plane /= length;
+        }
+    }
+    return planes;
+}
@@ -0,0 +1,282 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** MipGenerator
+*/
+
+#include "MipGenerator.hpp"
+
+#include <array>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define MAVERIK_MIP_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define MAVERIK_MIP_NEON
+#endif
+
+/*
+ * Half-width of the Kaiser filter in destination pixels, and its shape parameter.
+ * With a 2:1 reduction this gives 8 source taps per destination pixel and axis.
+ */
+static constexpr int KAISER_TAPS = 8;
+static constexpr double KAISER_RADIUS = 2.0;
+static constexpr double KAISER_BETA = 4.0;
+static constexpr double PI = 3.14159265358979323846;
+
+namespace {
+    /*
+     * One RGBA pixel held in a SIMD register when the target supports it.
+     */
+    struct Float4 {
+#if defined(MAVERIK_MIP_SSE2)
+        __m128 _value;
+#elif defined(MAVERIK_MIP_NEON)
+        float32x4_t _value;
+#else
+        float _value[4];
+#endif
+    };
+
+    inline Float4 zero4()
+    {
+#if defined(MAVERIK_MIP_SSE2)
+        return {_mm_setzero_ps()};
+#elif defined(MAVERIK_MIP_NEON)
+        return {vdupq_n_f32(0.0f)};
+#else
+        return {{0.0f, 0.0f, 0.0f, 0.0f}};
+#endif
+    }
+
+    inline Float4 load4(const float *src)
+    {
+#if defined(MAVERIK_MIP_SSE2)
+        return {_mm_loadu_ps(src)};
+#elif defined(MAVERIK_MIP_NEON)
+        return {vld1q_f32(src)};
+#else
+        return {{src[0], src[1], src[2], src[3]}};
+#endif
+    }
+
+    inline void store4(float *dst, Float4 value)
+    {
+#if defined(MAVERIK_MIP_SSE2)
+        _mm_storeu_ps(dst, value._value);
+#elif defined(MAVERIK_MIP_NEON)
+        vst1q_f32(dst, value._value);
+#else
+        std::copy(value._value, value._value + 4, dst);
+#endif
+    }
+
+    // Returns acc + value * weight
+    inline Float4 madd4(Float4 acc, Float4 value, float weight)
+    {
+#if defined(MAVERIK_MIP_SSE2)
+        return {_mm_add_ps(acc._value, _mm_mul_ps(value._value, _mm_set1_ps(weight)))};
+#elif defined(MAVERIK_MIP_NEON)
+        return {vmlaq_n_f32(acc._value, value._value, weight)};
+#else
+        for (int i = 0; i < 4; i++) {
+            acc._value[i] += value._value[i] * weight;
+        }
+        return acc;
+#endif
+    }
+
+    // Zeroth order modified Bessel function of the first kind
+    double besselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+
+        for (int k = 1; k < 32; k++) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    // Weights of the source taps around a destination pixel, from the leftmost one
+    const std::array<float, KAISER_TAPS>& getKaiserWeights()
+    {
+        static const std::array<float, KAISER_TAPS> weights = [] {
+            std::array<float, KAISER_TAPS> result{};
+            double sum = 0.0;
+
+            for (int i = 0; i < KAISER_TAPS; i++) {
+                // Distance between the source pixel center and the destination pixel center, in destination pixels
+                double t = (i - KAISER_TAPS / 2 + 0.5) * 0.5;
+                double sinc = t == 0.0 ? 1.0 : std::sin(PI * t) / (PI * t);
+                double ratio = t / KAISER_RADIUS;
+                double window = besselI0(KAISER_BETA * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) / besselI0(KAISER_BETA);
+
+                result[i] = static_cast<float>(sinc * window);
+                sum += result[i];
+            }
+            for (auto& weight : result) {
+                weight = static_cast<float>(weight / sum);
+            }
+            return result;
+        }();
+
+        return weights;
+    }
+
+    const std::array<float, 256>& getSrgbToLinearTable()
+    {
+        static const std::array<float, 256> table = [] {
+            std::array<float, 256> result{};
+
+            for (int i = 0; i < 256; i++) {
+                float value = i / 255.0f;
+                result[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+            }
+            return result;
+        }();
+
+        return table;
+    }
+
+    uint8_t linearToSrgb(float value)
+    {
+        value = std::clamp(value, 0.0f, 1.0f);
+        value = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+        return static_cast<uint8_t>(value * 255.0f + 0.5f);
+    }
+
+    uint8_t linearToUnorm(float value)
+    {
+        return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+}
+
+////////////////////
+// Public methods //
+////////////////////
+
+std::vector<maverik::MipGenerator::MipLevel> maverik::MipGenerator::generate(const uint8_t *pixels, uint32_t width, uint32_t height, Filter filter, bool srgb)
+{
+    std::vector<MipLevel> levels;
+    std::vector<float> current;
+    std::vector<float> next;
+
+    levels.push_back({width, height, std::vector<uint8_t>(pixels, pixels + static_cast<size_t>(width) * height * 4)});
+    decode(pixels, static_cast<size_t>(width) * height, srgb, current);
+
+    while (width > 1 || height > 1) {
+        uint32_t nextWidth = std::max(width / 2, 1u);
+        uint32_t nextHeight = std::max(height / 2, 1u);
+
+        // Each level is filtered from the previous one, which keeps the cost linear in the base size
+        if (filter == Filter::KAISER) {
+            downsampleKaiser(current, width, height, next, nextWidth, nextHeight);
+        } else {
+            downsampleBox(current, width, height, next, nextWidth, nextHeight);
+        }
+
+        MipLevel level{nextWidth, nextHeight, {}};
+        encode(next, srgb, level._pixels);
+        levels.push_back(std::move(level));
+
+        std::swap(current, next);
+        width = nextWidth;
+        height = nextHeight;
+    }
+    return levels;
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+void maverik::MipGenerator::downsampleBox(const std::vector<float>& src, uint32_t srcWidth, uint32_t srcHeight, std::vector<float>& dst, uint32_t dstWidth, uint32_t dstHeight)
+{
+    dst.resize(static_cast<size_t>(dstWidth) * dstHeight * 4);
+
+    for (uint32_t y = 0; y < dstHeight; y++) {
+        const float *row0 = src.data() + static_cast<size_t>(std::min(y * 2, srcHeight - 1)) * srcWidth * 4;
+        const float *row1 = src.data() + static_cast<size_t>(std::min(y * 2 + 1, srcHeight - 1)) * srcWidth * 4;
+        float *out = dst.data() + static_cast<size_t>(y) * dstWidth * 4;
+
+        for (uint32_t x = 0; x < dstWidth; x++) {
+            uint32_t x0 = std::min(x * 2, srcWidth - 1) * 4;
+            uint32_t x1 = std::min(x * 2 + 1, srcWidth - 1) * 4;
+            Float4 sum = zero4();
+
+            sum = madd4(sum, load4(row0 + x0), 0.25f);
+            sum = madd4(sum, load4(row0 + x1), 0.25f);
+            sum = madd4(sum, load4(row1 + x0), 0.25f);
+            sum = madd4(sum, load4(row1 + x1), 0.25f);
+            store4(out + x * 4, sum);
+        }
+    }
+}
+
+void maverik::MipGenerator::downsampleKaiser(const std::vector<float>& src, uint32_t srcWidth, uint32_t srcHeight, std::vector<float>& dst, uint32_t dstWidth, uint32_t dstHeight)
+{
+    const std::array<float, KAISER_TAPS>& weights = getKaiserWeights();
+    std::vector<float> horizontal(static_cast<size_t>(dstWidth) * srcHeight * 4);
+
+    dst.resize(static_cast<size_t>(dstWidth) * dstHeight * 4);
+
+    // Horizontal pass: srcWidth x srcHeight -> dstWidth x srcHeight
+    for (uint32_t y = 0; y < srcHeight; y++) {
+        const float *row = src.data() + static_cast<size_t>(y) * srcWidth * 4;
+        float *out = horizontal.data() + static_cast<size_t>(y) * dstWidth * 4;
+
+        for (uint32_t x = 0; x < dstWidth; x++) {
+            int first = static_cast<int>(x * 2) - KAISER_TAPS / 2 + 1;
+            Float4 sum = zero4();
+
+            for (int tap = 0; tap < KAISER_TAPS; tap++) {
+                int sx = std::clamp(first + tap, 0, static_cast<int>(srcWidth) - 1);
+                sum = madd4(sum, load4(row + sx * 4), weights[tap]);
+            }
+            store4(out + x * 4, sum);
+        }
+    }
+
+    // Vertical pass: dstWidth x srcHeight -> dstWidth x dstHeight
+    for (uint32_t y = 0; y < dstHeight; y++) {
+        int first = static_cast<int>(y * 2) - KAISER_TAPS / 2 + 1;
+        float *out = dst.data() + static_cast<size_t>(y) * dstWidth * 4;
+
+        for (uint32_t x = 0; x < dstWidth; x++) {
+            Float4 sum = zero4();
+
+            for (int tap = 0; tap < KAISER_TAPS; tap++) {
+                int sy = std::clamp(first + tap, 0, static_cast<int>(srcHeight) - 1);
+                sum = madd4(sum, load4(horizontal.data() + (static_cast<size_t>(sy) * dstWidth + x) * 4), weights[tap]);
+            }
+            store4(out + x * 4, sum);
+        }
+    }
+}
+
+void maverik::MipGenerator::decode(const uint8_t *pixels, size_t pixelCount, bool srgb, std::vector<float>& out)
+{
+    const std::array<float, 256>& srgbToLinear = getSrgbToLinearTable();
+
+    out.resize(pixelCount * 4);
+    for (size_t i = 0; i < pixelCount * 4; i++) {
+        // Alpha is always linear
+        bool color = srgb && (i % 4) != 3;
+        out[i] = color ? srgbToLinear[pixels[i]] : pixels[i] / 255.0f;
+    }
+}
+
+void maverik::MipGenerator::encode(const std::vector<float>& linear, bool srgb, std::vector<uint8_t>& out)
+{
+    out.resize(linear.size());
+    for (size_t i = 0; i < linear.size(); i++) {
+        bool color = srgb && (i % 4) != 3;
+        out[i] = color ? linearToSrgb(linear[i]) : linearToUnorm(linear[i]);
+    }
+}
@@ -0,0 +1,177 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** PipelineCache
+*/
+
+#include "PipelineCache.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+
+/*
+ * Identifies pipeline cache files, followed by PIPELINE_CACHE_VERSION.
+ */
+static constexpr char PIPELINE_CACHE_MAGIC[4] = {'M', 'V', 'P', 'C'};
+
+/*
+ * Incremented whenever the layout of the file header changes.
+ */
+static constexpr uint32_t PIPELINE_CACHE_VERSION = 1;
+
+/*
+ * Magic, version, vendor ID, device ID, driver version, reserved, data size and data checksum.
+ */
+static constexpr size_t PIPELINE_CACHE_HEADER_SIZE = 40;
+
+template <typename T>
+static T readField(const char *data, size_t offset)
+{
+    T value;
+
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+template <typename T>
+static void writeField(std::vector<char>& data, size_t offset, T value)
+{
+    std::memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+/**
+ * @brief FNV-1a over the pipeline data, catching truncated or corrupted files.
+ */
+static uint64_t computeChecksum(const char *data, size_t size)
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ static_cast<uint8_t>(data[i])) * 1099511628211ull;
+    }
+    return hash;
+}
+
+////////////////////
+// Public methods //
+////////////////////
+
+maverik::PipelineCache::PipelineCache(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, const std::string& path)
+    : _logicalDevice(logicalDevice), _path(path)
+{
+    vkGetPhysicalDeviceProperties(physicalDevice, &_deviceProperties);
+
+    std::vector<char> initialData;
+    std::ifstream file(_path, std::ios::ate | std::ios::binary);
+    if (file.is_open()) {
+        std::vector<char> content(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(content.data(), static_cast<std::streamsize>(content.size()));
+        if (file.good()) {
+            initialData = this->validate(content);
+        }
+    }
+
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = initialData.size();
+    cacheInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+    if (vkCreatePipelineCache(_logicalDevice, &cacheInfo, nullptr, &_cache) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create pipeline cache !");
+    }
+    _seeded = !initialData.empty();
+}
+
+maverik::PipelineCache::~PipelineCache()
+{
+    try {
+        this->save();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+    }
+    vkDestroyPipelineCache(_logicalDevice, _cache, nullptr);
+}
+
+void maverik::PipelineCache::save() const
+{
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(_logicalDevice, _cache, &dataSize, nullptr) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to get the pipeline cache size !");
+    }
+
+    std::vector<char> content(PIPELINE_CACHE_HEADER_SIZE + dataSize, 0);
+    if (vkGetPipelineCacheData(_logicalDevice, _cache, &dataSize, content.data() + PIPELINE_CACHE_HEADER_SIZE) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to get the pipeline cache data !");
+    }
+    content.resize(PIPELINE_CACHE_HEADER_SIZE + dataSize);
+
+    std::memcpy(content.data(), PIPELINE_CACHE_MAGIC, sizeof(PIPELINE_CACHE_MAGIC));
+    writeField<uint32_t>(content, 4, PIPELINE_CACHE_VERSION);
+    writeField<uint32_t>(content, 8, _deviceProperties.vendorID);
+    writeField<uint32_t>(content, 12, _deviceProperties.deviceID);
+    writeField<uint32_t>(content, 16, _deviceProperties.driverVersion);
+    writeField<uint64_t>(content, 24, static_cast<uint64_t>(dataSize));
+    writeField<uint64_t>(content, 32, computeChecksum(content.data() + PIPELINE_CACHE_HEADER_SIZE, dataSize));
+
+    // Readers only ever see the previous file or the complete new one
+    std::string temporaryPath = _path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file for writing: " + temporaryPath);
+        }
+        file.write(content.data(), static_cast<std::streamsize>(content.size()));
+        file.flush();
+        if (!file.good()) {
+            throw std::runtime_error("Failed to write pipeline cache: " + temporaryPath);
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, _path, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        throw std::runtime_error("Failed to replace pipeline cache: " + _path);
+    }
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+std::vector<char> maverik::PipelineCache::validate(const std::vector<char>& file) const
+{
+    if (file.size() < PIPELINE_CACHE_HEADER_SIZE || std::memcmp(file.data(), PIPELINE_CACHE_MAGIC, sizeof(PIPELINE_CACHE_MAGIC)) != 0
+        || readField<uint32_t>(file.data(), 4) != PIPELINE_CACHE_VERSION) {
+        return {};
+    }
+
+    // Written for another GPU or driver
+    if (readField<uint32_t>(file.data(), 8) != _deviceProperties.vendorID || readField<uint32_t>(file.data(), 12) != _deviceProperties.deviceID
+        || readField<uint32_t>(file.data(), 16) != _deviceProperties.driverVersion) {
+        return {};
+    }
+
+    uint64_t dataSize = readField<uint64_t>(file.data(), 24);
+    const char *data = file.data() + PIPELINE_CACHE_HEADER_SIZE;
+    if (dataSize != file.size() - PIPELINE_CACHE_HEADER_SIZE || computeChecksum(data, dataSize) != readField<uint64_t>(file.data(), 32)) {
+        return {};
+    }
+
+    // The header Vulkan puts in front of the data, see VkPipelineCacheHeaderVersionOne
+    if (dataSize < sizeof(VkPipelineCacheHeaderVersionOne)) {
+        return {};
+    }
+    VkPipelineCacheHeaderVersionOne header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.headerSize < sizeof(VkPipelineCacheHeaderVersionOne) || header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+        || header.vendorID != _deviceProperties.vendorID || header.deviceID != _deviceProperties.deviceID
+        || std::memcmp(header.pipelineCacheUUID, _deviceProperties.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+        return {};
+    }
+    return std::vector<char>(data, data + dataSize);
+}
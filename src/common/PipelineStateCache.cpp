@@ -0,0 +1,286 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** PipelineStateCache
+*/
+
+#include "PipelineStateCache.hpp"
+#include "Utils.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+static uint32_t floatBits(float value)
+{
+    uint32_t bits;
+
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static void appendHandle(std::vector<uint32_t>& key, uint64_t handle)
+{
+    key.push_back(static_cast<uint32_t>(handle));
+    key.push_back(static_cast<uint32_t>(handle >> 32));
+}
+
+static void appendString(std::vector<uint32_t>& key, const std::string& string)
+{
+    size_t first = key.size();
+
+    // Length first, so that two strings never flatten to the same words as another pair
+    key.push_back(static_cast<uint32_t>(string.size()));
+    key.resize(first + 1 + (string.size() + 3) / 4, 0);
+    std::memcpy(key.data() + first + 1, string.data(), string.size());
+}
+
+////////////////////
+// Public methods //
+////////////////////
+
+maverik::PipelineStateCache::PipelineStateCache(const PipelineStateCacheCreationProperties& properties)
+    : _properties(properties)
+{
+    if (_properties._threadPool == nullptr) {
+        _ownedThreadPool = std::make_unique<ThreadPool>(DEFAULT_COMPILE_THREADS);
+        _properties._threadPool = _ownedThreadPool.get();
+    }
+}
+
+maverik::PipelineStateCache::~PipelineStateCache()
+{
+    for (auto& [key, entry] : _entries) {
+        this->poll(entry, true);
+        if (entry._pipeline != VK_NULL_HANDLE) {
+            vkDestroyPipeline(_properties._logicalDevice, entry._pipeline, nullptr);
+        }
+    }
+}
+
+VkPipeline maverik::PipelineStateCache::request(const PipelineDescription& description, VkPipeline fallback)
+{
+    auto [it, inserted] = _entries.try_emplace(makeKey(description));
+    Entry& entry = it->second;
+
+    if (inserted) {
+        VkDevice logicalDevice = _properties._logicalDevice;
+        VkPipelineCache pipelineCache = _properties._pipelineCache;
+
+        entry._status = PipelineStatus::COMPILING;
+        entry._compilation = _properties._threadPool->submit([logicalDevice, pipelineCache, description] {
+            return compile(logicalDevice, pipelineCache, description);
+        });
+        return fallback;
+    }
+    this->poll(entry, false);
+    return entry._status == PipelineStatus::READY ? entry._pipeline : fallback;
+}
+
+VkPipeline maverik::PipelineStateCache::acquire(const PipelineDescription& description)
+{
+    auto [it, inserted] = _entries.try_emplace(makeKey(description));
+    Entry& entry = it->second;
+
+    if (inserted) {
+        // Queued behind other compilations, the pipeline would take longer than compiling it here
+        try {
+            entry._pipeline = compile(_properties._logicalDevice, _properties._pipelineCache, description);
+        } catch (...) {
+            entry._status = PipelineStatus::FAILED;
+            throw;
+        }
+        entry._status = PipelineStatus::READY;
+        return entry._pipeline;
+    }
+    this->poll(entry, true);
+    if (entry._status != PipelineStatus::READY) {
+        throw std::runtime_error("Failed to compile graphics pipeline: " + description._vertexShader + ", " + description._fragmentShader + " !");
+    }
+    return entry._pipeline;
+}
+
+maverik::PipelineStatus maverik::PipelineStateCache::getStatus(const PipelineDescription& description)
+{
+    auto it = _entries.find(makeKey(description));
+
+    if (it == _entries.end()) {
+        return PipelineStatus::MISSING;
+    }
+    this->poll(it->second, false);
+    return it->second._status;
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+size_t maverik::PipelineStateCache::PipelineKeyHash::operator()(const PipelineKey& key) const
+{
+    // FNV-1a over the words
+    uint64_t hash = 14695981039346656037ull;
+
+    for (uint32_t word : key) {
+        hash = (hash ^ word) * 1099511628211ull;
+    }
+    return static_cast<size_t>(hash);
+}
+
+maverik::PipelineStateCache::PipelineKey maverik::PipelineStateCache::makeKey(const PipelineDescription& description)
+{
+    PipelineKey key;
+
+    appendString(key, description._vertexShader);
+    appendString(key, description._fragmentShader);
+    key.push_back(static_cast<uint32_t>(description._bindings.size()));
+    for (const VkVertexInputBindingDescription& binding : description._bindings) {
+        key.insert(key.end(), {binding.binding, binding.stride, static_cast<uint32_t>(binding.inputRate)});
+    }
+    key.push_back(static_cast<uint32_t>(description._attributes.size()));
+    for (const VkVertexInputAttributeDescription& attribute : description._attributes) {
+        key.insert(key.end(), {attribute.location, attribute.binding, static_cast<uint32_t>(attribute.format), attribute.offset});
+    }
+
+    const VkPipelineColorBlendAttachmentState& blend = description._blend;
+    key.insert(key.end(), {
+        static_cast<uint32_t>(description._topology), static_cast<uint32_t>(description._polygonMode),
+        description._cullMode, static_cast<uint32_t>(description._frontFace),
+        description._depthTest, description._depthWrite, static_cast<uint32_t>(description._depthCompareOp),
+        blend.blendEnable, static_cast<uint32_t>(blend.srcColorBlendFactor), static_cast<uint32_t>(blend.dstColorBlendFactor),
+        static_cast<uint32_t>(blend.colorBlendOp), static_cast<uint32_t>(blend.srcAlphaBlendFactor),
+        static_cast<uint32_t>(blend.dstAlphaBlendFactor), static_cast<uint32_t>(blend.alphaBlendOp), blend.colorWriteMask,
+        static_cast<uint32_t>(description._samples), floatBits(description._minSampleShading), description._subpass
+    });
+    appendHandle(key, reinterpret_cast<uint64_t>(description._layout));
+    appendHandle(key, reinterpret_cast<uint64_t>(description._renderPass));
+    return key;
+}
+
+VkPipeline maverik::PipelineStateCache::compile(VkDevice logicalDevice, VkPipelineCache pipelineCache, const PipelineDescription& description)
+{
+    auto vertShaderCode = Utils::readFile(description._vertexShader);
+    auto fragShaderCode = Utils::readFile(description._fragmentShader);
+
+    VkShaderModule vertShaderModule = Utils::createShaderModule(logicalDevice, vertShaderCode);
+    VkShaderModule fragShaderModule;
+    try {
+        fragShaderModule = Utils::createShaderModule(logicalDevice, fragShaderCode);
+    } catch (...) {
+        vkDestroyShaderModule(logicalDevice, vertShaderModule, nullptr);
+        throw;
+    }
+
+    std::array<VkPipelineShaderStageCreateInfo, 2> shaderStages{};
+    shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    shaderStages[0].module = vertShaderModule;
+    shaderStages[0].pName = "main";
+    shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    shaderStages[1].module = fragShaderModule;
+    shaderStages[1].pName = "main";
+
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(description._bindings.size());
+    vertexInputInfo.pVertexBindingDescriptions = description._bindings.data();
+    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(description._attributes.size());
+    vertexInputInfo.pVertexAttributeDescriptions = description._attributes.data();
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = description._topology;
+    inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.depthClampEnable = VK_FALSE;
+    rasterizer.rasterizerDiscardEnable = VK_FALSE;
+    rasterizer.polygonMode = description._polygonMode;
+    rasterizer.lineWidth = 1.0f;
+    rasterizer.cullMode = description._cullMode;
+    rasterizer.frontFace = description._frontFace;
+    rasterizer.depthBiasEnable = VK_FALSE;
+
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.rasterizationSamples = description._samples;
+    multisampling.sampleShadingEnable = description._minSampleShading > 0.0f ? VK_TRUE : VK_FALSE;
+    multisampling.minSampleShading = description._minSampleShading;
+
+    VkPipelineColorBlendStateCreateInfo colorBlending{};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.logicOpEnable = VK_FALSE;
+    colorBlending.logicOp = VK_LOGIC_OP_COPY;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &description._blend;
+
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = description._depthTest;
+    depthStencil.depthWriteEnable = description._depthWrite;
+    depthStencil.depthCompareOp = description._depthCompareOp;
+    depthStencil.depthBoundsTestEnable = VK_FALSE;
+    depthStencil.minDepthBounds = 0.0f;
+    depthStencil.maxDepthBounds = 1.0f;
+    depthStencil.stencilTestEnable = VK_FALSE;
+
+    std::array<VkDynamicState, 2> dynamicStates = {
+        VK_DYNAMIC_STATE_VIEWPORT,
+        VK_DYNAMIC_STATE_SCISSOR
+    };
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+    dynamicState.pDynamicStates = dynamicStates.data();
+
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
+    pipelineInfo.pStages = shaderStages.data();
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = description._layout;
+    pipelineInfo.renderPass = description._renderPass;
+    pipelineInfo.subpass = description._subpass;
+    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+
+    VkPipeline pipeline;
+    VkResult result = vkCreateGraphicsPipelines(logicalDevice, pipelineCache, 1, &pipelineInfo, nullptr, &pipeline);
+    vkDestroyShaderModule(logicalDevice, fragShaderModule, nullptr);
+    vkDestroyShaderModule(logicalDevice, vertShaderModule, nullptr);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create graphics pipeline !");
+    }
+    return pipeline;
+}
+
+void maverik::PipelineStateCache::poll(Entry& entry, bool wait)
+{
+    if (entry._status != PipelineStatus::COMPILING) {
+        return;
+    }
+    if (!wait && entry._compilation.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+    try {
+        entry._pipeline = entry._compilation.get();
+        entry._status = PipelineStatus::READY;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        entry._status = PipelineStatus::FAILED;
+    }
+}
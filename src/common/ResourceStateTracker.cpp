@@ -0,0 +1,382 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** ResourceStateTracker
+*/
+
+#include "ResourceStateTracker.hpp"
+
+/*
+ * Every access flag that writes memory, a write always requires a barrier
+ * before any further access to the same subresource.
+ */
+static constexpr VkAccessFlags2 WRITE_ACCESS_MASK =
+    VK_ACCESS_2_SHADER_WRITE_BIT |
+    VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT |
+    VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+    VK_ACCESS_2_TRANSFER_WRITE_BIT |
+    VK_ACCESS_2_HOST_WRITE_BIT |
+    VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+////////////////////
+// Public methods //
+////////////////////
+
+maverik::ResourceStateTracker::ResourceStateTracker(VkDevice logicalDevice, bool synchronization2)
+    : _logicalDevice(logicalDevice)
+{
+    if (synchronization2) {
+        // Core in Vulkan 1.3, exposed by VK_KHR_synchronization2 before that
+        _cmdPipelineBarrier2 = reinterpret_cast<PFN_vkCmdPipelineBarrier2>(vkGetDeviceProcAddr(_logicalDevice, "vkCmdPipelineBarrier2"));
+        if (_cmdPipelineBarrier2 == nullptr) {
+            _cmdPipelineBarrier2 = reinterpret_cast<PFN_vkCmdPipelineBarrier2>(vkGetDeviceProcAddr(_logicalDevice, "vkCmdPipelineBarrier2KHR"));
+        }
+    }
+}
+
+maverik::ResourceStateTracker::ResourceState maverik::ResourceStateTracker::getUsageState(Usage usage)
+{
+    switch (usage) {
+        case Usage::UNDEFINED:
+            return {VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_UNDEFINED};
+        case Usage::TRANSFER_SRC:
+            return {VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL};
+        case Usage::TRANSFER_DST:
+            return {VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL};
+        case Usage::VERTEX_BUFFER:
+            return {VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED};
+        case Usage::INDEX_BUFFER:
+            return {VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT, VK_ACCESS_2_INDEX_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED};
+        case Usage::INDIRECT_BUFFER:
+            return {VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED};
+        case Usage::UNIFORM_BUFFER:
+            return {VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_UNIFORM_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED};
+        case Usage::VERTEX_SHADER_READ:
+            return {VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        case Usage::FRAGMENT_SHADER_READ:
+            return {VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        case Usage::COMPUTE_SHADER_READ:
+            return {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        case Usage::COMPUTE_SHADER_WRITE:
+            return {VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL};
+        case Usage::COLOR_ATTACHMENT:
+            return {VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+        case Usage::DEPTH_STENCIL_ATTACHMENT:
+            return {VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+        case Usage::DEPTH_STENCIL_READ:
+            return {VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_SHADER_READ_BIT,
+                VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL};
+        case Usage::PRESENT:
+            return {VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR};
+        case Usage::HOST_READ:
+            return {VK_PIPELINE_STAGE_2_HOST_BIT, VK_ACCESS_2_HOST_READ_BIT, VK_IMAGE_LAYOUT_GENERAL};
+        case Usage::HOST_WRITE:
+            return {VK_PIPELINE_STAGE_2_HOST_BIT, VK_ACCESS_2_HOST_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL};
+    }
+    throw std::invalid_argument("Unknown resource usage!");
+}
+
+maverik::ResourceStateTracker::ResourceState maverik::ResourceStateTracker::getLayoutState(VkImageLayout layout)
+{
+    switch (layout) {
+        case VK_IMAGE_LAYOUT_UNDEFINED:
+            return getUsageState(Usage::UNDEFINED);
+        case VK_IMAGE_LAYOUT_PREINITIALIZED:
+            return {VK_PIPELINE_STAGE_2_HOST_BIT, VK_ACCESS_2_HOST_WRITE_BIT, layout};
+        case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+            return getUsageState(Usage::TRANSFER_SRC);
+        case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+            return getUsageState(Usage::TRANSFER_DST);
+        case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+            return getUsageState(Usage::FRAGMENT_SHADER_READ);
+        case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+            return getUsageState(Usage::COLOR_ATTACHMENT);
+        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+            return getUsageState(Usage::DEPTH_STENCIL_ATTACHMENT);
+        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+            return getUsageState(Usage::DEPTH_STENCIL_READ);
+        case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
+            return getUsageState(Usage::PRESENT);
+        default:
+            return {VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT, layout};
+    }
+}
+
+void maverik::ResourceStateTracker::registerImage(VkImage image, VkImageAspectFlags aspectMask, uint32_t mipLevels, uint32_t arrayLayers, VkImageLayout initialLayout)
+{
+    // The last access is assumed to be the one that goes with the initial layout
+    const ResourceState layoutState = getLayoutState(initialLayout);
+    TrackedState initialState{};
+
+    initialState._layout = initialLayout;
+    initialState._writeStages = layoutState._stages;
+    initialState._writeAccess = layoutState._access & WRITE_ACCESS_MASK;
+    initialState._readStages = layoutState._stages;
+    initialState._readAccess = layoutState._access;
+    _images[image] = TrackedImage{aspectMask, arrayLayers, std::vector<TrackedState>(mipLevels, initialState)};
+}
+
+void maverik::ResourceStateTracker::registerBuffer(VkBuffer buffer)
+{
+    _buffers[buffer] = TrackedState{};
+}
+
+bool maverik::ResourceStateTracker::isTracked(VkImage image) const
+{
+    return _images.find(image) != _images.end();
+}
+
+void maverik::ResourceStateTracker::forget(VkImage image)
+{
+    _images.erase(image);
+}
+
+void maverik::ResourceStateTracker::forget(VkBuffer buffer)
+{
+    _buffers.erase(buffer);
+}
+
+void maverik::ResourceStateTracker::require(VkImage image, Usage usage, uint32_t baseMipLevel, uint32_t levelCount)
+{
+    require(image, getUsageState(usage), baseMipLevel, levelCount);
+}
+
+void maverik::ResourceStateTracker::require(VkImage image, const ResourceState& state, uint32_t baseMipLevel, uint32_t levelCount)
+{
+    auto it = _images.find(image);
+
+    if (it == _images.end()) {
+        throw std::runtime_error("Image is not tracked by the resource state tracker!");
+    }
+
+    TrackedImage& tracked = it->second;
+    const uint32_t trackedLevels = static_cast<uint32_t>(tracked._levels.size());
+
+    // Compared without adding, so a huge count cannot wrap around into range
+    if (baseMipLevel >= trackedLevels || (levelCount != VK_REMAINING_MIP_LEVELS && (levelCount == 0 || levelCount > trackedLevels - baseMipLevel))) {
+        throw std::out_of_range("Mip level range is out of the tracked image!");
+    }
+    uint32_t endLevel = levelCount == VK_REMAINING_MIP_LEVELS ? trackedLevels : baseMipLevel + levelCount;
+    uint32_t level = baseMipLevel;
+
+    while (level < endLevel) {
+        // Consecutive levels sharing the same state are covered by a single barrier
+        const TrackedState previous = tracked._levels[level];
+        uint32_t runEnd = level + 1;
+
+        while (runEnd < endLevel && tracked._levels[runEnd] == previous) {
+            runEnd++;
+        }
+        if (previous._pending) {
+            throw std::logic_error("Image level already has a pending barrier, flush the tracker first!");
+        }
+
+        TrackedState next = previous;
+        VkPipelineStageFlags2 srcStages = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2 srcAccess = VK_ACCESS_2_NONE;
+
+        if (transition(next, state, true, srcStages, srcAccess)) {
+            VkImageMemoryBarrier2 barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+            barrier.srcStageMask = srcStages;
+            barrier.srcAccessMask = srcAccess;
+            barrier.dstStageMask = state._stages;
+            barrier.dstAccessMask = state._access;
+            barrier.oldLayout = previous._layout;
+            barrier.newLayout = next._layout;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = image;
+            barrier.subresourceRange.aspectMask = tracked._aspectMask;
+            barrier.subresourceRange.baseMipLevel = level;
+            barrier.subresourceRange.levelCount = runEnd - level;
+            barrier.subresourceRange.baseArrayLayer = 0;
+            barrier.subresourceRange.layerCount = tracked._arrayLayers;
+            _imageBarriers.push_back(barrier);
+            next._pending = true;
+        }
+        for (uint32_t i = level; i < runEnd; i++) {
+            tracked._levels[i] = next;
+        }
+        level = runEnd;
+    }
+}
+
+void maverik::ResourceStateTracker::require(VkBuffer buffer, Usage usage)
+{
+    auto it = _buffers.find(buffer);
+
+    if (it == _buffers.end()) {
+        throw std::runtime_error("Buffer is not tracked by the resource state tracker!");
+    }
+    if (it->second._pending) {
+        throw std::logic_error("Buffer already has a pending barrier, flush the tracker first!");
+    }
+
+    const ResourceState state = getUsageState(usage);
+    VkPipelineStageFlags2 srcStages = VK_PIPELINE_STAGE_2_NONE;
+    VkAccessFlags2 srcAccess = VK_ACCESS_2_NONE;
+
+    if (transition(it->second, state, false, srcStages, srcAccess)) {
+        VkBufferMemoryBarrier2 barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+        barrier.srcStageMask = srcStages;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstStageMask = state._stages;
+        barrier.dstAccessMask = state._access;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = buffer;
+        barrier.offset = 0;
+        barrier.size = VK_WHOLE_SIZE;
+        _bufferBarriers.push_back(barrier);
+        it->second._pending = true;
+    }
+}
+
+void maverik::ResourceStateTracker::flush(VkCommandBuffer commandBuffer)
+{
+    if (_imageBarriers.empty() && _bufferBarriers.empty()) {
+        return;
+    }
+
+    if (_cmdPipelineBarrier2 != nullptr) {
+        VkDependencyInfo dependencyInfo{};
+        dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(_bufferBarriers.size());
+        dependencyInfo.pBufferMemoryBarriers = _bufferBarriers.data();
+        dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(_imageBarriers.size());
+        dependencyInfo.pImageMemoryBarriers = _imageBarriers.data();
+        _cmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+    } else {
+        // Legacy path: the stage masks of every barrier are merged into one call.
+        // Only stage and access bits shared with synchronization2 are ever used,
+        // so truncating them to 32 bits is lossless.
+        VkPipelineStageFlags srcStageMask = 0;
+        VkPipelineStageFlags dstStageMask = 0;
+        std::vector<VkImageMemoryBarrier> imageBarriers;
+        std::vector<VkBufferMemoryBarrier> bufferBarriers;
+
+        imageBarriers.reserve(_imageBarriers.size());
+        for (const auto& barrier2 : _imageBarriers) {
+            VkImageMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcAccessMask = static_cast<VkAccessFlags>(barrier2.srcAccessMask);
+            barrier.dstAccessMask = static_cast<VkAccessFlags>(barrier2.dstAccessMask);
+            barrier.oldLayout = barrier2.oldLayout;
+            barrier.newLayout = barrier2.newLayout;
+            barrier.srcQueueFamilyIndex = barrier2.srcQueueFamilyIndex;
+            barrier.dstQueueFamilyIndex = barrier2.dstQueueFamilyIndex;
+            barrier.image = barrier2.image;
+            barrier.subresourceRange = barrier2.subresourceRange;
+            imageBarriers.push_back(barrier);
+            srcStageMask |= static_cast<VkPipelineStageFlags>(barrier2.srcStageMask);
+            dstStageMask |= static_cast<VkPipelineStageFlags>(barrier2.dstStageMask);
+        }
+        bufferBarriers.reserve(_bufferBarriers.size());
+        for (const auto& barrier2 : _bufferBarriers) {
+            VkBufferMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            barrier.srcAccessMask = static_cast<VkAccessFlags>(barrier2.srcAccessMask);
+            barrier.dstAccessMask = static_cast<VkAccessFlags>(barrier2.dstAccessMask);
+            barrier.srcQueueFamilyIndex = barrier2.srcQueueFamilyIndex;
+            barrier.dstQueueFamilyIndex = barrier2.dstQueueFamilyIndex;
+            barrier.buffer = barrier2.buffer;
+            barrier.offset = barrier2.offset;
+            barrier.size = barrier2.size;
+            bufferBarriers.push_back(barrier);
+            srcStageMask |= static_cast<VkPipelineStageFlags>(barrier2.srcStageMask);
+            dstStageMask |= static_cast<VkPipelineStageFlags>(barrier2.dstStageMask);
+        }
+        if (srcStageMask == 0) {
+            srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        }
+        if (dstStageMask == 0) {
+            dstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+        }
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            srcStageMask, dstStageMask,
+            0,
+            0, nullptr,
+            static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(),
+            static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data()
+        );
+    }
+
+    for (const auto& barrier : _imageBarriers) {
+        auto it = _images.find(barrier.image);
+
+        if (it == _images.end()) {
+            continue;
+        }
+        for (uint32_t i = 0; i < barrier.subresourceRange.levelCount; i++) {
+            it->second._levels[barrier.subresourceRange.baseMipLevel + i]._pending = false;
+        }
+    }
+    for (const auto& barrier : _bufferBarriers) {
+        auto it = _buffers.find(barrier.buffer);
+
+        if (it != _buffers.end()) {
+            it->second._pending = false;
+        }
+    }
+    _imageBarriers.clear();
+    _bufferBarriers.clear();
+}
+
+VkImageLayout maverik::ResourceStateTracker::getLayout(VkImage image, uint32_t mipLevel) const
+{
+    auto it = _images.find(image);
+
+    if (it == _images.end()) {
+        throw std::runtime_error("Image is not tracked by the resource state tracker!");
+    }
+    return it->second._levels.at(mipLevel)._layout;
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+bool maverik::ResourceStateTracker::transition(TrackedState& state, const ResourceState& next, bool isImage, VkPipelineStageFlags2& srcStages, VkAccessFlags2& srcAccess)
+{
+    // Discarding the content never needs a barrier, the next transition starts from UNDEFINED
+    if (isImage && next._layout == VK_IMAGE_LAYOUT_UNDEFINED) {
+        state._layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        return false;
+    }
+
+    const bool layoutChange = isImage && next._layout != state._layout;
+    const bool nextWrites = (next._access & WRITE_ACCESS_MASK) != 0;
+
+    if (!layoutChange && !nextWrites) {
+        const bool alreadyVisible = (next._stages & ~state._readStages) == 0 && (next._access & ~state._readAccess) == 0;
+        const bool hazard = state._writeStages != VK_PIPELINE_STAGE_2_NONE && !alreadyVisible;
+
+        // Read after write: make the write visible to the new readers
+        srcStages = state._writeStages;
+        srcAccess = state._writeAccess;
+        state._readStages |= next._stages;
+        state._readAccess |= next._access;
+        return hazard;
+    }
+
+    // Write after read/write or layout transition: wait for every previous access
+    srcStages = state._writeStages | state._readStages;
+    srcAccess = state._writeAccess;
+    if (isImage) {
+        state._layout = next._layout;
+    }
+    state._writeStages = next._stages;
+    state._writeAccess = next._access & WRITE_ACCESS_MASK;
+    state._readStages = next._stages;
+    state._readAccess = next._access;
+    return true;
+}
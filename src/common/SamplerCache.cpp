@@ -0,0 +1,118 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** SamplerCache
+*/
+
+#include "SamplerCache.hpp"
+
+#include <cstring>
+
+static uint32_t floatBits(float value)
+{
+    uint32_t bits;
+
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+////////////////////
+// Public methods //
+////////////////////
+
+maverik::SamplerCache::SamplerCache(VkDevice logicalDevice)
+    : _logicalDevice(logicalDevice)
+{
+}
+
+maverik::SamplerCache::~SamplerCache()
+{
+    for (const auto& [key, entry] : _entries) {
+        vkDestroySampler(_logicalDevice, entry._sampler, nullptr);
+    }
+}
+
+VkSampler maverik::SamplerCache::acquire(const VkSamplerCreateInfo& samplerInfo)
+{
+    if (samplerInfo.pNext != nullptr) {
+        throw std::runtime_error("Sampler states with extension structures cannot be cached !");
+    }
+
+    SamplerKey key = makeKey(samplerInfo);
+    auto it = _entries.find(key);
+
+    if (it != _entries.end()) {
+        it->second._refCount++;
+        return it->second._sampler;
+    }
+
+    VkSampler sampler;
+    if (vkCreateSampler(_logicalDevice, &samplerInfo, nullptr, &sampler) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create sampler !");
+    }
+    _entries[key] = {sampler, 1};
+    _keys[sampler] = key;
+    return sampler;
+}
+
+void maverik::SamplerCache::release(VkSampler sampler)
+{
+    auto keyIt = _keys.find(sampler);
+
+    if (keyIt == _keys.end()) {
+        return;
+    }
+
+    auto entryIt = _entries.find(keyIt->second);
+    if (--entryIt->second._refCount == 0) {
+        vkDestroySampler(_logicalDevice, sampler, nullptr);
+        _entries.erase(entryIt);
+        _keys.erase(keyIt);
+    }
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+size_t maverik::SamplerCache::SamplerKeyHash::operator()(const SamplerKey& key) const
+{
+    const uint32_t fields[] = {
+        key._flags, static_cast<uint32_t>(key._magFilter), static_cast<uint32_t>(key._minFilter),
+        static_cast<uint32_t>(key._mipmapMode), static_cast<uint32_t>(key._addressModeU),
+        static_cast<uint32_t>(key._addressModeV), static_cast<uint32_t>(key._addressModeW),
+        key._mipLodBias, key._anisotropyEnable, key._maxAnisotropy, key._compareEnable,
+        static_cast<uint32_t>(key._compareOp), key._minLod, key._maxLod,
+        static_cast<uint32_t>(key._borderColor), key._unnormalizedCoordinates
+    };
+    // FNV-1a over the fields
+    uint64_t hash = 14695981039346656037ull;
+
+    for (uint32_t field : fields) {
+        hash = (hash ^ field) * 1099511628211ull;
+    }
+    return static_cast<size_t>(hash);
+}
+
+maverik::SamplerCache::SamplerKey maverik::SamplerCache::makeKey(const VkSamplerCreateInfo& samplerInfo)
+{
+    return {
+        ._flags = samplerInfo.flags,
+        ._magFilter = samplerInfo.magFilter,
+        ._minFilter = samplerInfo.minFilter,
+        ._mipmapMode = samplerInfo.mipmapMode,
+        ._addressModeU = samplerInfo.addressModeU,
+        ._addressModeV = samplerInfo.addressModeV,
+        ._addressModeW = samplerInfo.addressModeW,
+        ._mipLodBias = floatBits(samplerInfo.mipLodBias),
+        ._anisotropyEnable = samplerInfo.anisotropyEnable,
+        ._maxAnisotropy = floatBits(samplerInfo.maxAnisotropy),
+        ._compareEnable = samplerInfo.compareEnable,
+        ._compareOp = samplerInfo.compareOp,
+        ._minLod = floatBits(samplerInfo.minLod),
+        ._maxLod = floatBits(samplerInfo.maxLod),
+        ._borderColor = samplerInfo.borderColor,
+        ._unnormalizedCoordinates = samplerInfo.unnormalizedCoordinates
+    };
+}
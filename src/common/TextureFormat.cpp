@@ -0,0 +1,328 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** TextureFormat
+*/
+
+#include "TextureFormat.hpp"
+
+#include <cstring>
+#include <vector>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    // The library is built for the baseline ISA: the SSSE3 and F16C paths are compiled
+    // for their own target and only taken when the CPU running them supports it
+    #include <immintrin.h>
+    #define MAVERIK_FORMAT_SSSE3
+    #define MAVERIK_FORMAT_F16C
+    #define MAVERIK_FORMAT_TARGET(features) __attribute__((target(features)))
+#else
+    #if defined(__SSSE3__)
+        #include <tmmintrin.h>
+        #define MAVERIK_FORMAT_SSSE3
+    #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        #include <arm_neon.h>
+        #define MAVERIK_FORMAT_NEON
+    #endif
+
+    #if defined(__F16C__)
+        #include <immintrin.h>
+        #define MAVERIK_FORMAT_F16C
+    #elif defined(__aarch64__) && defined(MAVERIK_FORMAT_NEON)
+        #define MAVERIK_FORMAT_NEON_F16
+    #endif
+    #define MAVERIK_FORMAT_TARGET(features)
+#endif
+
+/*
+ * Marks a destination channel that is not read from the source.
+ */
+static constexpr uint32_t NO_CHANNEL = UINT32_MAX;
+
+/*
+ * Source channel a destination channel is read from: grey sources replicate their
+ * luminance to the color channels, and alpha is always the last source channel.
+ */
+static uint32_t getSourceChannel(uint32_t channel, uint32_t sourceChannels, uint32_t destinationChannels)
+{
+    if (destinationChannels == 4 && channel == 3) {
+        return sourceChannels == 2 || sourceChannels == 4 ? sourceChannels - 1 : NO_CHANNEL;
+    }
+    return sourceChannels <= 2 ? 0 : channel;
+}
+
+template <typename T>
+static void remapChannels(const T *source, uint32_t sourceChannels, T *destination, uint32_t destinationChannels, size_t pixelCount, T one)
+{
+    uint32_t channels[4];
+
+    for (uint32_t c = 0; c < destinationChannels; c++) {
+        channels[c] = getSourceChannel(c, sourceChannels, destinationChannels);
+    }
+    for (size_t i = 0; i < pixelCount; i++) {
+        const T *pixel = source + i * sourceChannels;
+
+        for (uint32_t c = 0; c < destinationChannels; c++) {
+            *destination++ = channels[c] == NO_CHANNEL ? one : pixel[channels[c]];
+        }
+    }
+}
+
+static uint16_t floatToHalfScalar(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t exponent = (bits >> 23) & 0xFF;
+    uint32_t mantissa = bits & 0x7FFFFF;
+    int32_t halfExponent = static_cast<int32_t>(exponent) - 127 + 15;
+
+    if (exponent == 0xFF) {
+        return static_cast<uint16_t>(sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0));
+    }
+    if (halfExponent >= 0x1F) {
+        return static_cast<uint16_t>(sign | 0x7C00);
+    }
+    if (halfExponent <= 0) {
+        // Subnormal half, the implicit bit is shifted into the mantissa
+        if (halfExponent < -10) {
+            return static_cast<uint16_t>(sign);
+        }
+        mantissa |= 0x800000;
+        uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+
+        if (remainder > halfway || (remainder == halfway && (half & 1))) {
+            half++;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    // A carry out of the mantissa correctly bumps the exponent, up to infinity
+    uint32_t half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1FFF;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+        half++;
+    }
+    return static_cast<uint16_t>(sign | half);
+}
+
+#if defined(MAVERIK_FORMAT_SSSE3)
+static bool cpuSupportsSsse3()
+{
+#if defined(__SSSE3__)
+    return true;
+#else
+    static const bool supported = __builtin_cpu_supports("ssse3");
+
+    return supported;
+#endif
+}
+
+/*
+ * Expands 16 pixels per iteration: three 16-byte loads hold the 48 RGB bytes, each
+ * shuffle spreads 4 pixels over a register and the alpha bytes are or-ed in.
+ * Returns the number of pixels expanded, the remaining ones are left to the caller.
+ */
+MAVERIK_FORMAT_TARGET("ssse3")
+static size_t expandRgbToRgbaSsse3(const uint8_t *source, uint8_t *destination, size_t pixelCount, uint8_t alpha)
+{
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(alpha) << 24));
+    size_t i = 0;
+
+    for (; i + 16 <= pixelCount; i += 16) {
+        const __m128i *in = reinterpret_cast<const __m128i *>(source + i * 3);
+        __m128i *out = reinterpret_cast<__m128i *>(destination + i * 4);
+        __m128i in0 = _mm_loadu_si128(in);
+        __m128i in1 = _mm_loadu_si128(in + 1);
+        __m128i in2 = _mm_loadu_si128(in + 2);
+
+        _mm_storeu_si128(out, _mm_or_si128(_mm_shuffle_epi8(in0, shuffle), alphaMask));
+        _mm_storeu_si128(out + 1, _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(in1, in0, 12), shuffle), alphaMask));
+        _mm_storeu_si128(out + 2, _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(in2, in1, 8), shuffle), alphaMask));
+        _mm_storeu_si128(out + 3, _mm_or_si128(_mm_shuffle_epi8(_mm_srli_si128(in2, 4), shuffle), alphaMask));
+    }
+    return i;
+}
+#endif
+
+#if defined(MAVERIK_FORMAT_F16C)
+static bool cpuSupportsF16c()
+{
+#if defined(__F16C__)
+    return true;
+#else
+    // The 8-wide conversion loads its floats with AVX
+    static const bool supported = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+
+    return supported;
+#endif
+}
+
+/*
+ * Converts 8 floats per iteration, returns the number of values converted.
+ */
+MAVERIK_FORMAT_TARGET("avx,f16c")
+static size_t floatToHalfF16c(const float *source, uint16_t *destination, size_t count)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m128i halves = _mm256_cvtps_ph(_mm256_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i), halves);
+    }
+    return i;
+}
+#endif
+
+static VkFormat getFormat(uint32_t channels, maverik::TextureFormat::Precision precision, bool srgb)
+{
+    using Precision = maverik::TextureFormat::Precision;
+    static constexpr VkFormat FORMATS[3][3] = {
+        {VK_FORMAT_R8_UNORM, VK_FORMAT_R8G8_UNORM, VK_FORMAT_R8G8B8A8_UNORM},
+        {VK_FORMAT_R16_UNORM, VK_FORMAT_R16G16_UNORM, VK_FORMAT_R16G16B16A16_UNORM},
+        {VK_FORMAT_R16_SFLOAT, VK_FORMAT_R16G16_SFLOAT, VK_FORMAT_R16G16B16A16_SFLOAT}
+    };
+    static constexpr VkFormat SRGB_FORMATS[3] = {VK_FORMAT_R8_SRGB, VK_FORMAT_R8G8_SRGB, VK_FORMAT_R8G8B8A8_SRGB};
+    uint32_t column = channels == 4 ? 2 : channels - 1;
+
+    if (srgb && precision == Precision::UNORM8) {
+        return SRGB_FORMATS[column];
+    }
+    return FORMATS[static_cast<int>(precision)][column];
+}
+
+////////////////////
+// Public methods //
+////////////////////
+
+maverik::TextureFormat::Selection maverik::TextureFormat::select(uint32_t sourceChannels, Usage usage, Precision sourcePrecision)
+{
+    Selection selection = {};
+
+    selection._precision = sourcePrecision;
+    switch (usage) {
+        case Usage::COLOR:
+            if (sourcePrecision == Precision::UNORM16) {
+                selection._precision = Precision::UNORM8;
+            }
+            selection._channels = sourceChannels >= 3 ? 4 : sourceChannels;
+            if (sourceChannels == 1) {
+                selection._swizzle = {VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_ONE};
+            } else if (sourceChannels == 2) {
+                selection._swizzle = {VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G};
+            }
+            break;
+        case Usage::DATA:
+            selection._channels = sourceChannels >= 3 ? 4 : sourceChannels;
+            break;
+        case Usage::NORMAL:
+            selection._channels = 2;
+            break;
+        case Usage::MASK:
+            selection._channels = 1;
+            selection._swizzle = {VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R};
+            break;
+    }
+    selection._format = getFormat(selection._channels, selection._precision, usage == Usage::COLOR);
+    return selection;
+}
+
+maverik::TextureFormat::Selection maverik::TextureFormat::widen(const Selection& selection)
+{
+    Selection widened = selection;
+    bool srgb = selection._format == VK_FORMAT_R8_SRGB || selection._format == VK_FORMAT_R8G8_SRGB || selection._format == VK_FORMAT_R8G8B8A8_SRGB;
+
+    // Grey is replicated and alpha kept last by convert(), the color swizzles are no longer needed
+    if (selection._swizzle.a != VK_COMPONENT_SWIZZLE_R) {
+        widened._swizzle = {};
+    }
+    widened._channels = 4;
+    widened._format = getFormat(4, selection._precision, srgb);
+    return widened;
+}
+
+void maverik::TextureFormat::convert(const void *source, uint32_t sourceChannels, const Selection& selection, size_t pixelCount, void *destination)
+{
+    switch (selection._precision) {
+        case Precision::UNORM8:
+            if (sourceChannels == 3 && selection._channels == 4) {
+                expandRgbToRgba(static_cast<const uint8_t *>(source), static_cast<uint8_t *>(destination), pixelCount);
+            } else if (sourceChannels == selection._channels) {
+                std::memcpy(destination, source, pixelCount * sourceChannels);
+            } else {
+                remapChannels(static_cast<const uint8_t *>(source), sourceChannels, static_cast<uint8_t *>(destination), selection._channels, pixelCount, static_cast<uint8_t>(0xFF));
+            }
+            break;
+        case Precision::UNORM16:
+            if (sourceChannels == selection._channels) {
+                std::memcpy(destination, source, pixelCount * sourceChannels * sizeof(uint16_t));
+            } else {
+                remapChannels(static_cast<const uint16_t *>(source), sourceChannels, static_cast<uint16_t *>(destination), selection._channels, pixelCount, static_cast<uint16_t>(0xFFFF));
+            }
+            break;
+        case Precision::FLOAT:
+            if (sourceChannels == selection._channels) {
+                floatToHalf(static_cast<const float *>(source), static_cast<uint16_t *>(destination), pixelCount * sourceChannels);
+            } else {
+                std::vector<float> remapped(pixelCount * selection._channels);
+
+                remapChannels(static_cast<const float *>(source), sourceChannels, remapped.data(), selection._channels, pixelCount, 1.0f);
+                floatToHalf(remapped.data(), static_cast<uint16_t *>(destination), remapped.size());
+            }
+            break;
+    }
+}
+
+void maverik::TextureFormat::expandRgbToRgba(const uint8_t *source, uint8_t *destination, size_t pixelCount, uint8_t alpha)
+{
+    size_t i = 0;
+
+#if defined(MAVERIK_FORMAT_SSSE3)
+    if (cpuSupportsSsse3()) {
+        i = expandRgbToRgbaSsse3(source, destination, pixelCount, alpha);
+    }
+#elif defined(MAVERIK_FORMAT_NEON)
+    // 16 pixels per iteration, de-interleaved by the structure load and re-interleaved with alpha
+    const uint8x16_t alphaVector = vdupq_n_u8(alpha);
+
+    for (; i + 16 <= pixelCount; i += 16) {
+        uint8x16x3_t rgb = vld3q_u8(source + i * 3);
+        uint8x16x4_t rgba = {{rgb.val[0], rgb.val[1], rgb.val[2], alphaVector}};
+
+        vst4q_u8(destination + i * 4, rgba);
+    }
+#endif
+    for (; i < pixelCount; i++) {
+        destination[i * 4] = source[i * 3];
+        destination[i * 4 + 1] = source[i * 3 + 1];
+        destination[i * 4 + 2] = source[i * 3 + 2];
+        destination[i * 4 + 3] = alpha;
+    }
+}
+
+void maverik::TextureFormat::floatToHalf(const float *source, uint16_t *destination, size_t count)
+{
+    size_t i = 0;
+
+#if defined(MAVERIK_FORMAT_F16C)
+    if (cpuSupportsF16c()) {
+        i = floatToHalfF16c(source, destination, count);
+    }
+#elif defined(MAVERIK_FORMAT_NEON_F16)
+    for (; i + 4 <= count; i += 4) {
+        float16x4_t halves = vcvt_f16_f32(vld1q_f32(source + i));
+
+        vst1_u16(destination + i, vreinterpret_u16_f16(halves));
+    }
+#endif
+    for (; i < count; i++) {
+        destination[i] = floatToHalfScalar(source[i]);
+    }
+}
@@ -0,0 +1,102 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** TextureRegistry
+*/
+
+#include "TextureRegistry.hpp"
+
+////////////////////
+// Public methods //
+////////////////////
+
+maverik::TextureHandle maverik::TextureRegistry::add(const Texture& texture)
+{
+    if (_slotsByName.contains(texture._name)) {
+        throw std::runtime_error("Texture " + texture._name + " is already registered !");
+    }
+
+    uint32_t slot;
+    if (_freeSlots.empty()) {
+        slot = static_cast<uint32_t>(_slots.size());
+        _slots.push_back({TextureHandle::INVALID_INDEX, 0});
+    } else {
+        slot = _freeSlots.back();
+        _freeSlots.pop_back();
+    }
+
+    _slots[slot]._denseIndex = static_cast<uint32_t>(_textures.size());
+    _textures.push_back(texture);
+    _denseToSlot.push_back(slot);
+    _slotsByName[texture._name] = slot;
+    return {slot, _slots[slot]._generation};
+}
+
+maverik::Texture maverik::TextureRegistry::remove(TextureHandle handle)
+{
+    uint32_t denseIndex = this->resolve(handle);
+    uint32_t lastIndex = static_cast<uint32_t>(_textures.size() - 1);
+    Texture texture = std::move(_textures[denseIndex]);
+
+    // Keep the array packed by moving the last texture into the hole
+    if (denseIndex != lastIndex) {
+        _textures[denseIndex] = std::move(_textures[lastIndex]);
+        _denseToSlot[denseIndex] = _denseToSlot[lastIndex];
+        _slots[_denseToSlot[denseIndex]]._denseIndex = denseIndex;
+    }
+    _textures.pop_back();
+    _denseToSlot.pop_back();
+
+    _slots[handle._index]._denseIndex = TextureHandle::INVALID_INDEX;
+    _slots[handle._index]._generation++;
+    _freeSlots.push_back(handle._index);
+    _slotsByName.erase(texture._name);
+    return texture;
+}
+
+bool maverik::TextureRegistry::contains(TextureHandle handle) const
+{
+    return handle._index < _slots.size()
+        && _slots[handle._index]._generation == handle._generation
+        && _slots[handle._index]._denseIndex != TextureHandle::INVALID_INDEX;
+}
+
+maverik::Texture& maverik::TextureRegistry::get(TextureHandle handle)
+{
+    return _textures[this->resolve(handle)];
+}
+
+const maverik::Texture& maverik::TextureRegistry::get(TextureHandle handle) const
+{
+    return _textures[this->resolve(handle)];
+}
+
+maverik::TextureHandle maverik::TextureRegistry::find(const std::string& name) const
+{
+    auto it = _slotsByName.find(name);
+
+    if (it == _slotsByName.end()) {
+        return {};
+    }
+    return {it->second, _slots[it->second]._generation};
+}
+
+maverik::TextureHandle maverik::TextureRegistry::getHandle(size_t denseIndex) const
+{
+    uint32_t slot = _denseToSlot.at(denseIndex);
+
+    return {slot, _slots[slot]._generation};
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+uint32_t maverik::TextureRegistry::resolve(TextureHandle handle) const
+{
+    if (!this->contains(handle)) {
+        throw std::runtime_error("Texture handle does not refer to a registered texture !");
+    }
+    return _slots[handle._index]._denseIndex;
+}
@@ -0,0 +1,399 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** TextureStreamer
+*/
+
+#include "TextureStreamer.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+/*
+ * Alignment of the levels in the staging buffer, a multiple of every texel block size.
+ */
+static constexpr VkDeviceSize STAGING_LEVEL_ALIGNMENT = 16;
+
+////////////////////
+// Public methods //
+////////////////////
+
+maverik::TextureStreamer::TextureStreamer(const TextureStreamerProperties& properties)
+    : _properties(properties)
+{
+    if (_properties._resourceStateTracker == nullptr) {
+        _ownedResourceStateTracker = std::make_unique<ResourceStateTracker>(_properties._logicalDevice, false);
+        _properties._resourceStateTracker = _ownedResourceStateTracker.get();
+    }
+}
+
+maverik::TextureStreamer::~TextureStreamer()
+{
+    for (auto& [name, texture] : _textures) {
+        if (texture._upload) {
+            vkWaitForFences(_properties._logicalDevice, 1, &texture._upload->_fence, VK_TRUE, UINT64_MAX);
+            this->completeUpload(texture);
+        }
+        _retired.push_back({texture._allocation, _frame});
+    }
+    _textures.clear();
+    this->releaseRetired(true);
+}
+
+void maverik::TextureStreamer::addTexture(const std::string& name, const std::string& path)
+{
+    StreamedTexture texture;
+
+    if (CookedTexture::isCookedPath(path)) {
+        texture._cooked = std::make_unique<CookedTexture>(path);
+        texture._format = static_cast<VkFormat>(texture._cooked->getFormat());
+        texture._levelCount = texture._cooked->getLevelCount();
+    } else if (KtxTexture::isKtx2Path(path)) {
+        texture._ktx = std::make_unique<KtxTexture>(KtxTexture::fromFile(path));
+        texture._format = texture._ktx->getFormat();
+        texture._levelCount = texture._ktx->getLevelCount();
+    } else {
+        throw std::runtime_error("Only .mvktex and .ktx2 textures can be streamed: " + path);
+    }
+    if (!Utils::isFormatSampleable(_properties._physicalDevice, texture._format)) {
+        throw std::runtime_error("Texture format of " + path + " is not supported by the device !");
+    }
+
+    texture._tailLevel = texture._levelCount - 1;
+    for (uint32_t level = 0; level < texture._levelCount; level++) {
+        VkDeviceSize size;
+        VkExtent3D extent;
+
+        getLevel(texture, level, size, extent);
+        if (extent.width <= _properties._tailSize && extent.height <= _properties._tailSize) {
+            texture._tailLevel = level;
+            break;
+        }
+    }
+    texture._residentLevel = texture._levelCount;
+    texture._targetLevel = texture._levelCount;
+    texture._requestedLevel = texture._levelCount;
+
+    this->removeTexture(name);
+    StreamedTexture& inserted = _textures.emplace(name, std::move(texture)).first->second;
+
+    // The tail is small, waiting for it makes the texture usable as soon as this returns
+    this->beginUpload(inserted, inserted._tailLevel);
+    vkWaitForFences(_properties._logicalDevice, 1, &inserted._upload->_fence, VK_TRUE, UINT64_MAX);
+    this->completeUpload(inserted);
+}
+
+void maverik::TextureStreamer::removeTexture(const std::string& name)
+{
+    auto it = _textures.find(name);
+
+    if (it == _textures.end()) {
+        return;
+    }
+    if (it->second._upload) {
+        vkWaitForFences(_properties._logicalDevice, 1, &it->second._upload->_fence, VK_TRUE, UINT64_MAX);
+        this->completeUpload(it->second);
+    }
+    _committedBytes -= getWindowBytes(it->second, it->second._targetLevel);
+    _retired.push_back({it->second._allocation, _frame + _properties._framesInFlight});
+    _textures.erase(it);
+}
+
+void maverik::TextureStreamer::requestLevel(const std::string& name, uint32_t level)
+{
+    StreamedTexture& texture = _textures.at(name);
+
+    texture._requestedLevel = std::min({texture._requestedLevel, level, texture._levelCount - 1});
+    texture._lastRequestFrame = _frame;
+}
+
+void maverik::TextureStreamer::requestLevelForDistance(const std::string& name, float distance, float worldSize, float fovY, uint32_t viewportHeight)
+{
+    const StreamedTexture& texture = _textures.at(name);
+    VkDeviceSize size;
+    VkExtent3D extent;
+
+    getLevel(texture, 0, size, extent);
+
+    // Pixels covered on screen by the texture, and the level whose size matches it
+    float screenPixels = worldSize / (2.0f * std::max(distance, 1e-4f) * std::tan(fovY * 0.5f)) * viewportHeight;
+    float texels = static_cast<float>(std::max(extent.width, extent.height));
+    float level = screenPixels > 0.0f ? std::floor(std::log2(texels / screenPixels)) : static_cast<float>(texture._levelCount - 1);
+
+    this->requestLevel(name, static_cast<uint32_t>(std::clamp(level, 0.0f, static_cast<float>(texture._levelCount - 1))));
+}
+
+std::vector<std::string> maverik::TextureStreamer::update()
+{
+    std::vector<std::string> changed;
+    std::vector<StreamedTexture *> wanted;
+
+    this->releaseRetired(false);
+
+    for (auto& [name, texture] : _textures) {
+        if (texture._upload && vkGetFenceStatus(_properties._logicalDevice, texture._upload->_fence) == VK_SUCCESS) {
+            this->completeUpload(texture);
+            changed.push_back(name);
+        }
+        if (!texture._upload && texture._requestedLevel < texture._residentLevel) {
+            wanted.push_back(&texture);
+        }
+    }
+
+    // Textures missing the most levels are streamed in first
+    std::sort(wanted.begin(), wanted.end(), [](const StreamedTexture *a, const StreamedTexture *b) {
+        return a->_residentLevel - a->_requestedLevel > b->_residentLevel - b->_requestedLevel;
+    });
+
+    uint32_t uploadCount = 0;
+    for (StreamedTexture *texture : wanted) {
+        if (uploadCount == _properties._maxUploadsPerUpdate) {
+            break;
+        }
+        VkDeviceSize extraBytes = getWindowBytes(*texture, texture->_requestedLevel) - getWindowBytes(*texture, texture->_targetLevel);
+        if (!this->makeRoom(extraBytes, texture)) {
+            continue;
+        }
+        this->beginUpload(*texture, texture->_requestedLevel);
+        uploadCount++;
+    }
+
+    for (auto& [name, texture] : _textures) {
+        texture._requestedLevel = texture._levelCount;
+    }
+    _frame++;
+    return changed;
+}
+
+VkImageView maverik::TextureStreamer::getImageView(const std::string& name) const
+{
+    return _textures.at(name)._allocation._view;
+}
+
+uint32_t maverik::TextureStreamer::getResidentLevel(const std::string& name) const
+{
+    return _textures.at(name)._residentLevel;
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+const char *maverik::TextureStreamer::getLevel(const StreamedTexture& texture, uint32_t level, VkDeviceSize& size, VkExtent3D& extent)
+{
+    if (texture._cooked) {
+        const CookedTexture::Level& cookedLevel = texture._cooked->getLevels()[level];
+
+        size = cookedLevel._size;
+        extent = {cookedLevel._width, cookedLevel._height, 1};
+        return texture._cooked->getData() + cookedLevel._offset;
+    }
+    size = texture._ktx->getLevels()[level]._byteLength;
+    extent = {std::max(texture._ktx->getWidth() >> level, 1u), std::max(texture._ktx->getHeight() >> level, 1u), 1};
+    return texture._ktx->getLevelData(level);
+}
+
+VkDeviceSize maverik::TextureStreamer::getWindowBytes(const StreamedTexture& texture, uint32_t baseLevel)
+{
+    VkDeviceSize bytes = 0;
+
+    for (uint32_t level = baseLevel; level < texture._levelCount; level++) {
+        VkDeviceSize size;
+        VkExtent3D extent;
+
+        getLevel(texture, level, size, extent);
+        bytes += size;
+    }
+    return bytes;
+}
+
+VkCommandBuffer maverik::TextureStreamer::allocateCommandBuffer()
+{
+    // Uploads span several frames, so they never come from the per-frame pools
+    if (_properties._commandAllocator != nullptr) {
+        return _properties._commandAllocator->allocateImmediate();
+    }
+
+    VkCommandBuffer commandBuffer;
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandPool = _properties._commandPool;
+    allocInfo.commandBufferCount = 1;
+    if (vkAllocateCommandBuffers(_properties._logicalDevice, &allocInfo, &commandBuffer) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate texture streaming command buffer!");
+    }
+    return commandBuffer;
+}
+
+void maverik::TextureStreamer::releaseCommandBuffer(VkCommandBuffer commandBuffer)
+{
+    if (_properties._commandAllocator != nullptr) {
+        _properties._commandAllocator->recycle(commandBuffer);
+    } else {
+        vkFreeCommandBuffers(_properties._logicalDevice, _properties._commandPool, 1, &commandBuffer);
+    }
+}
+
+void maverik::TextureStreamer::beginUpload(StreamedTexture& texture, uint32_t baseLevel)
+{
+    uint32_t mipLevels = texture._levelCount - baseLevel;
+    std::vector<VkBufferImageCopy> regions(mipLevels);
+    VkDeviceSize stagingSize = 0;
+    VkExtent3D baseExtent;
+    Upload upload = {};
+
+    for (uint32_t i = 0; i < mipLevels; i++) {
+        VkDeviceSize size;
+
+        getLevel(texture, baseLevel + i, size, regions[i].imageExtent);
+        regions[i].bufferOffset = stagingSize;
+        regions[i].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        regions[i].imageSubresource.mipLevel = i;
+        regions[i].imageSubresource.layerCount = 1;
+        stagingSize = (stagingSize + size + STAGING_LEVEL_ALIGNMENT - 1) / STAGING_LEVEL_ALIGNMENT * STAGING_LEVEL_ALIGNMENT;
+    }
+    baseExtent = regions[0].imageExtent;
+
+    Utils::CreateBufferProperties stagingBufferProperties = {
+        ._logicalDevice = _properties._logicalDevice,
+        ._physicalDevice = _properties._physicalDevice,
+        ._size = stagingSize,
+        ._usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        ._properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        ._buffer = upload._stagingBuffer,
+        ._bufferMemory = upload._stagingBufferMemory
+    };
+    Utils::createBuffer(stagingBufferProperties);
+
+    char *data;
+    vkMapMemory(_properties._logicalDevice, upload._stagingBufferMemory, 0, stagingSize, 0, reinterpret_cast<void **>(&data));
+    for (uint32_t i = 0; i < mipLevels; i++) {
+        VkDeviceSize size;
+        VkExtent3D extent;
+        const char *level = getLevel(texture, baseLevel + i, size, extent);
+
+        memcpy(data + regions[i].bufferOffset, level, static_cast<size_t>(size));
+    }
+    vkUnmapMemory(_properties._logicalDevice, upload._stagingBufferMemory);
+
+    Utils::CreateImageProperties imageProperties = {
+        ._logicalDevice = _properties._logicalDevice,
+        ._physicalDevice = _properties._physicalDevice,
+        ._width = baseExtent.width,
+        ._height = baseExtent.height,
+        ._mipLevels = mipLevels,
+        ._numSamples = VK_SAMPLE_COUNT_1_BIT,
+        ._format = texture._format,
+        ._tiling = VK_IMAGE_TILING_OPTIMAL,
+        ._usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        ._properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        ._image = upload._allocation._image,
+        ._imageMemory = upload._allocation._memory
+    };
+    Utils::createImage(imageProperties);
+    upload._allocation._view = Utils::createImageView(upload._allocation._image, texture._format, VK_IMAGE_ASPECT_COLOR_BIT, _properties._logicalDevice, mipLevels);
+
+    upload._commandBuffer = this->allocateCommandBuffer();
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (vkBeginCommandBuffer(upload._commandBuffer, &beginInfo) != VK_SUCCESS) {
+        this->releaseCommandBuffer(upload._commandBuffer);
+        throw std::runtime_error("failed to begin texture streaming command buffer!");
+    }
+
+    ResourceStateTracker *tracker = _properties._resourceStateTracker;
+    tracker->registerImage(upload._allocation._image, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels);
+    tracker->require(upload._allocation._image, ResourceStateTracker::Usage::TRANSFER_DST);
+    tracker->flush(upload._commandBuffer);
+    vkCmdCopyBufferToImage(upload._commandBuffer, upload._stagingBuffer, upload._allocation._image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+    tracker->require(upload._allocation._image, ResourceStateTracker::Usage::FRAGMENT_SHADER_READ);
+    tracker->flush(upload._commandBuffer);
+
+    if (vkEndCommandBuffer(upload._commandBuffer) != VK_SUCCESS) {
+        this->releaseCommandBuffer(upload._commandBuffer);
+        throw std::runtime_error("failed to record texture streaming command buffer!");
+    }
+
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    if (vkCreateFence(_properties._logicalDevice, &fenceInfo, nullptr, &upload._fence) != VK_SUCCESS) {
+        this->releaseCommandBuffer(upload._commandBuffer);
+        throw std::runtime_error("failed to create texture streaming fence!");
+    }
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &upload._commandBuffer;
+    if (vkQueueSubmit(_properties._graphicsQueue, 1, &submitInfo, upload._fence) != VK_SUCCESS) {
+        vkDestroyFence(_properties._logicalDevice, upload._fence, nullptr);
+        this->releaseCommandBuffer(upload._commandBuffer);
+        throw std::runtime_error("failed to submit texture streaming upload!");
+    }
+
+    upload._baseLevel = baseLevel;
+    _committedBytes += getWindowBytes(texture, baseLevel);
+    if (texture._targetLevel < texture._levelCount) {
+        _committedBytes -= getWindowBytes(texture, texture._targetLevel);
+    }
+    texture._targetLevel = baseLevel;
+    texture._upload = upload;
+}
+
+void maverik::TextureStreamer::completeUpload(StreamedTexture& texture)
+{
+    Upload& upload = *texture._upload;
+
+    vkDestroyFence(_properties._logicalDevice, upload._fence, nullptr);
+    this->releaseCommandBuffer(upload._commandBuffer);
+    vkDestroyBuffer(_properties._logicalDevice, upload._stagingBuffer, nullptr);
+    vkFreeMemory(_properties._logicalDevice, upload._stagingBufferMemory, nullptr);
+
+    if (texture._allocation._image != VK_NULL_HANDLE) {
+        _retired.push_back({texture._allocation, _frame + _properties._framesInFlight});
+    }
+    texture._allocation = upload._allocation;
+    texture._residentLevel = upload._baseLevel;
+    texture._upload.reset();
+}
+
+bool maverik::TextureStreamer::makeRoom(VkDeviceSize bytes, const StreamedTexture *requester)
+{
+    while (_committedBytes + bytes > _properties._budget) {
+        StreamedTexture *victim = nullptr;
+
+        for (auto& [name, texture] : _textures) {
+            if (&texture == requester || texture._upload || texture._residentLevel >= texture._tailLevel || texture._lastRequestFrame == _frame) {
+                continue;
+            }
+            if (victim == nullptr || texture._lastRequestFrame < victim->_lastRequestFrame) {
+                victim = &texture;
+            }
+        }
+        if (victim == nullptr) {
+            return false;
+        }
+        this->beginUpload(*victim, victim->_tailLevel);
+    }
+    return true;
+}
+
+void maverik::TextureStreamer::releaseRetired(bool all)
+{
+    while (!_retired.empty() && (all || _retired.front()._releaseFrame <= _frame)) {
+        const Allocation& allocation = _retired.front()._allocation;
+
+        if (allocation._image != VK_NULL_HANDLE) {
+            _properties._resourceStateTracker->forget(allocation._image);
+            vkDestroyImageView(_properties._logicalDevice, allocation._view, nullptr);
+            vkDestroyImage(_properties._logicalDevice, allocation._image, nullptr);
+            vkFreeMemory(_properties._logicalDevice, allocation._memory, nullptr);
+        }
+        _retired.pop_front();
+    }
+}
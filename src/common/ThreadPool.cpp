@@ -0,0 +1,60 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** ThreadPool
+*/
+
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+////////////////////
+// Public methods //
+////////////////////
+
+maverik::ThreadPool::ThreadPool(size_t threadCount)
+{
+    // hardware_concurrency() may return 0 when it cannot be determined
+    threadCount = std::max<size_t>(threadCount, 1);
+
+    _workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++) {
+        _workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+maverik::ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _condition.notify_all();
+
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+/////////////////////
+// Private methods //
+/////////////////////
+
+void maverik::ThreadPool::workerLoop()
+{
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this] { return _stopping || !_tasks.empty(); });
+
+            if (_tasks.empty()) {
+                return;
+            }
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+        task();
+    }
+}
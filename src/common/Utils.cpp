@@ -7,6 +7,28 @@
 
 #include "Utils.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+/*
+ * Device-local host-visible heaps up to this size are the legacy 256 MiB BAR window of a
+ * discrete GPU, larger ones expose the whole video memory (resizable BAR).
+ */
+static constexpr VkDeviceSize SMALL_BAR_HEAP_SIZE = 256ull * 1024 * 1024;
+
+/*
+ * Largest allocation written directly through a legacy BAR window: the window is scarce,
+ * and above this size the copy engine amortizes its submission.
+ */
+static constexpr VkDeviceSize SMALL_BAR_DIRECT_WRITE_LIMIT = 256ull * 1024;
+
+/*
+ * Fraction of a resizable BAR heap a single directly written allocation may take, so that
+ * static geometry does not crowd out the resources that must live in video memory.
+ */
+static constexpr VkDeviceSize LARGE_BAR_DIRECT_WRITE_DIVISOR = 8;
+
 /**
  * @brief Reads the contents of a binary file into a vector of characters.
  *
@@ -180,6 +202,47 @@ uint32_t maverik::Utils::findMemoryType(VkPhysicalDevice physicalDevice, uint32_
     throw std::runtime_error("Failed to find suitable memory type!");
 }
 
+/**
+* @brief Finds a device-local host-visible memory type worth writing an allocation to directly.
+*
+* On unified memory architectures (integrated GPUs, software rasterizers) video memory is
+* system memory, so every allocation is written directly. On discrete GPUs, direct writes
+* go over the bus: they are used for allocations small enough for the BAR window, any
+* allocation up to a fraction of the heap with resizable BAR, and never without a BAR.
+*
+* @param physicalDevice The Vulkan physical device to query for memory properties.
+* @param typeFilter A bitmask specifying the acceptable memory types.
+* @param size The size of the allocation in bytes.
+* @param memoryTypeIndex The index of the memory type, set when one is found.
+* @return true if the allocation should be written directly, false if it should go through staging.
+*/
+bool maverik::Utils::findDirectWriteMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkDeviceSize size, uint32_t& memoryTypeIndex)
+{
+    const VkMemoryPropertyFlags directWriteProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    VkPhysicalDeviceMemoryProperties memProperties;
+    VkPhysicalDeviceProperties deviceProperties;
+
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+    vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+    bool unifiedMemory = deviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU
+        || deviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU;
+
+    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+        if (!(typeFilter & (1 << i)) || (memProperties.memoryTypes[i].propertyFlags & directWriteProperties) != directWriteProperties) {
+            continue;
+        }
+
+        VkDeviceSize heapSize = memProperties.memoryHeaps[memProperties.memoryTypes[i].heapIndex].size;
+        bool worthWriting = unifiedMemory
+            || (heapSize <= SMALL_BAR_HEAP_SIZE ? size <= SMALL_BAR_DIRECT_WRITE_LIMIT : size <= heapSize / LARGE_BAR_DIRECT_WRITE_DIVISOR);
+        if (worthWriting) {
+            memoryTypeIndex = i;
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
 * @brief Finds a suitable depth format for a Vulkan physical device.
 *
@@ -248,6 +311,7 @@ void maverik::Utils::createImage(const CreateImageProperties& properties)
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     imageInfo.mipLevels = properties._mipLevels;
     imageInfo.samples = properties._numSamples;
+    imageInfo.flags = properties._flags;
 
     if (vkCreateImage(properties._logicalDevice, &imageInfo, nullptr, &properties._image) != VK_SUCCESS) {
         throw std::runtime_error("failed to create image!");
@@ -272,86 +336,185 @@ void maverik::Utils::createImage(const CreateImageProperties& properties)
 * @brief Transitions the layout of a Vulkan image.
 *
 * This function is used to transition a Vulkan image from one layout to another.
-* It sets up the necessary image memory barriers and pipeline stages to ensure
-* proper synchronization during the transition.
+* The stages and accesses of both layouts are derived by the ResourceStateTracker,
+* so any pair of layouts is supported. Layouts without a well-known usage fall back
+* to a conservative all-commands dependency.
 *
 * @param logicalDevice The Vulkan logical device.
 * @param commandPool The command pool used to allocate the command buffer.
 * @param graphicsQueue The graphics queue used to submit the command buffer.
 * @param image The Vulkan image to transition.
 * @param format The format of the image, used to determine if it has a stencil component.
-* @param oldLayout The current layout of the image.
+* @param oldLayout The current layout of the image, only used when the tracker does not know the image yet.
 * @param newLayout The desired layout of the image.
 * @param mipLevels The number of mipmap levels in the image.
-*
-* @throws std::invalid_argument If the layout transition is unsupported.
+* @param resourceStateTracker The tracker of the context, a temporary one is used when null.
 *
 * @note This function assumes that the image is not being used concurrently
 *       by other operations during the transition.
 */
 void maverik::Utils::transitionImageLayout(const TransitionImageLayoutProperties& properties)
 {
-    VkCommandBuffer commandBuffer = Utils::beginSingleTimeCommands(properties._logicalDevice, properties._commandPool);
+    VkCommandBuffer commandBuffer = Utils::beginSingleTimeCommands(properties._logicalDevice, properties._commandPool, properties._commandAllocator);
+    std::unique_ptr<ResourceStateTracker> localTracker;
+    ResourceStateTracker *tracker = properties._resourceStateTracker;
 
-    VkImageMemoryBarrier barrier{};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.oldLayout = properties._oldLayout;
-    barrier.newLayout = properties._newLayout;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image = properties._image;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-    barrier.subresourceRange.levelCount = properties._mipLevels;
+    if (tracker == nullptr) {
+        localTracker = std::make_unique<ResourceStateTracker>(properties._logicalDevice, false);
+        tracker = localTracker.get();
+    }
+    if (!tracker->isTracked(properties._image)) {
+        tracker->registerImage(properties._image, Utils::getImageAspectMask(properties._format), properties._mipLevels, 1, properties._oldLayout);
+    }
+    tracker->require(properties._image, ResourceStateTracker::getLayoutState(properties._newLayout));
+    tracker->flush(commandBuffer);
 
-    VkPipelineStageFlags sourceStage;
-    VkPipelineStageFlags destinationStage;
+    Utils::endSingleTimeCommands(properties._logicalDevice, properties._commandPool, properties._graphicsQueue, commandBuffer, properties._commandAllocator);
+}
 
-    if (properties._oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && properties._newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+/**
+ * @brief Returns the image aspects matching a format.
+ *
+ * @param format The format of the image.
+ * @return VkImageAspectFlags The depth (and stencil) aspects for depth formats, the color aspect otherwise.
+ */
+VkImageAspectFlags maverik::Utils::getImageAspectMask(VkFormat format)
+{
+    switch (format) {
+        case VK_FORMAT_D16_UNORM:
+        case VK_FORMAT_X8_D24_UNORM_PACK32:
+        case VK_FORMAT_D32_SFLOAT:
+            return VK_IMAGE_ASPECT_DEPTH_BIT;
+        case VK_FORMAT_S8_UINT:
+            return VK_IMAGE_ASPECT_STENCIL_BIT;
+        case VK_FORMAT_D16_UNORM_S8_UINT:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:
+            return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+        default:
+            return VK_IMAGE_ASPECT_COLOR_BIT;
+    }
+}
 
-        sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    } else if (properties._oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && properties._newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+/**
+ * @brief Queries the optional features a physical device supports.
+ *
+ * Features reported through `vkGetPhysicalDeviceFeatures2` are only queried when
+ * the device supports Vulkan 1.1, as the call is not available before that.
+ *
+ * @param physicalDevice The Vulkan physical device to query.
+ * @return DeviceCapabilities The optional features supported by the device.
+ */
+maverik::Utils::DeviceCapabilities maverik::Utils::queryDeviceCapabilities(VkPhysicalDevice physicalDevice)
+{
+    DeviceCapabilities capabilities{};
+    VkPhysicalDeviceProperties deviceProperties;
+    VkPhysicalDeviceFeatures deviceFeatures;
+
+    vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+    vkGetPhysicalDeviceFeatures(physicalDevice, &deviceFeatures);
+    capabilities._apiVersion = deviceProperties.apiVersion;
+    capabilities._textureCompressionBC = deviceFeatures.textureCompressionBC == VK_TRUE;
+    capabilities._textureCompressionETC2 = deviceFeatures.textureCompressionETC2 == VK_TRUE;
+    capabilities._textureCompressionASTC = deviceFeatures.textureCompressionASTC_LDR == VK_TRUE;
+    capabilities._multiDrawIndirect = deviceFeatures.multiDrawIndirect == VK_TRUE && deviceFeatures.drawIndirectFirstInstance == VK_TRUE;
+    // The extension is used even on 1.2 devices, so that the drawIndirectCount feature never has to be chained
+    capabilities._drawIndirectCount = capabilities._multiDrawIndirect
+        && Utils::isDeviceExtensionSupported(physicalDevice, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+    if (capabilities._apiVersion < VK_API_VERSION_1_1) {
+        return capabilities;
+    }
 
-        sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-    } else if (properties._oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && properties._newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL) {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    bool synchronization2Exposed = capabilities._apiVersion >= VK_API_VERSION_1_3
+        || Utils::isDeviceExtensionSupported(physicalDevice, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+    bool descriptorIndexingExposed = capabilities._apiVersion >= VK_API_VERSION_1_2
+        || Utils::isDeviceExtensionSupported(physicalDevice, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+    // The extension depends on copy_commands2 and format_feature_flags2, both core in 1.3
+    bool hostImageCopyExposed = Utils::isDeviceExtensionSupported(physicalDevice, VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME)
+        && (capabilities._apiVersion >= VK_API_VERSION_1_3
+            || (Utils::isDeviceExtensionSupported(physicalDevice, VK_KHR_COPY_COMMANDS_2_EXTENSION_NAME)
+                && Utils::isDeviceExtensionSupported(physicalDevice, VK_KHR_FORMAT_FEATURE_FLAGS_2_EXTENSION_NAME)));
+
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+
+    VkPhysicalDeviceSynchronization2Features synchronization2Features{};
+    synchronization2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES;
+    if (synchronization2Exposed) {
+        synchronization2Features.pNext = features2.pNext;
+        features2.pNext = &synchronization2Features;
+    }
 
-        sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        destinationStage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-    } else {
-        throw std::invalid_argument("unsupported layout transition!");
+    VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures{};
+    descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+    if (descriptorIndexingExposed) {
+        descriptorIndexingFeatures.pNext = features2.pNext;
+        features2.pNext = &descriptorIndexingFeatures;
     }
 
-    if (properties._newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL) {
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+    VkPhysicalDeviceHostImageCopyFeaturesEXT hostImageCopyFeatures{};
+    hostImageCopyFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT;
+    if (hostImageCopyExposed) {
+        hostImageCopyFeatures.pNext = features2.pNext;
+        features2.pNext = &hostImageCopyFeatures;
+    }
 
-        if (Utils::hasStencilComponent(properties._format)) {
-            barrier.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
-        }
-    } else {
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+
+    capabilities._synchronization2 = synchronization2Exposed && synchronization2Features.synchronization2 == VK_TRUE;
+    capabilities._descriptorIndexing = descriptorIndexingExposed
+        && descriptorIndexingFeatures.runtimeDescriptorArray == VK_TRUE
+        && descriptorIndexingFeatures.descriptorBindingPartiallyBound == VK_TRUE
+        && descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE
+        && descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing == VK_TRUE;
+    capabilities._hostImageCopy = hostImageCopyExposed && hostImageCopyFeatures.hostImageCopy == VK_TRUE;
+
+    if (capabilities._descriptorIndexing) {
+        VkPhysicalDeviceDescriptorIndexingProperties descriptorIndexingProperties{};
+        descriptorIndexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+
+        VkPhysicalDeviceProperties2 properties2{};
+        properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties2.pNext = &descriptorIndexingProperties;
+        vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+
+        // A combined image sampler counts against both the sampler and the sampled image limits
+        capabilities._maxBindlessTextures = std::min({
+            descriptorIndexingProperties.maxDescriptorSetUpdateAfterBindSamplers,
+            descriptorIndexingProperties.maxDescriptorSetUpdateAfterBindSampledImages,
+            descriptorIndexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers,
+            descriptorIndexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages
+        });
     }
+    return capabilities;
+}
 
-    vkCmdPipelineBarrier(
-        commandBuffer,
-        sourceStage, destinationStage,
-        0,
-        0, nullptr,
-        0, nullptr,
-        1, &barrier
-    );
+/**
+ * @brief Checks whether images of a format can be uploaded to and sampled with optimal tiling.
+ *
+ * @param physicalDevice The Vulkan physical device to query.
+ * @param format The format to check.
+ * @return true if the format supports sampling and transfer destination with optimal tiling.
+ */
+bool maverik::Utils::isFormatSampleable(VkPhysicalDevice physicalDevice, VkFormat format)
+{
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &formatProperties);
 
-    Utils::endSingleTimeCommands(properties._logicalDevice, properties._commandPool, properties._graphicsQueue, commandBuffer);
+    VkFormatFeatureFlags required = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+    return (formatProperties.optimalTilingFeatures & required) == required;
+}
+
+/**
+ * @brief Checks if a Vulkan physical device supports a single extension.
+ *
+ * @param device The Vulkan physical device to check.
+ * @param extensionName The name of the extension.
+ * @return true if the extension is supported, false otherwise.
+ */
+bool maverik::Utils::isDeviceExtensionSupported(VkPhysicalDevice device, const char *extensionName)
+{
+    return Utils::checkDeviceExtensionSupport(device, {extensionName});
 }
 
 /**
@@ -446,10 +609,18 @@ void maverik::Utils::createBuffer(const CreateBufferProperties& properties)
  * @param image The Vulkan image to which the data will be copied.
  * @param width The width of the image in pixels.
  * @param height The height of the image in pixels.
+ * @param regions Optional copy regions (e.g. one per mip level), the whole base level is copied when empty.
  */
 void maverik::Utils::copyBufferToImage(const CopyBufferToImageProperties& properties)
 {
-    VkCommandBuffer commandBuffer = Utils::beginSingleTimeCommands(properties._logicalDevice, properties._commandPool);
+    VkCommandBuffer commandBuffer = Utils::beginSingleTimeCommands(properties._logicalDevice, properties._commandPool, properties._commandAllocator);
+
+    if (!properties._regions.empty()) {
+        vkCmdCopyBufferToImage(commandBuffer, properties._buffer, properties._image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            static_cast<uint32_t>(properties._regions.size()), properties._regions.data());
+        Utils::endSingleTimeCommands(properties._logicalDevice, properties._commandPool, properties._graphicsQueue, commandBuffer, properties._commandAllocator);
+        return;
+    }
 
     VkBufferImageCopy region{};
     region.bufferOffset = 0;
@@ -468,7 +639,7 @@ void maverik::Utils::copyBufferToImage(const CopyBufferToImageProperties& proper
 
     vkCmdCopyBufferToImage(commandBuffer, properties._buffer, properties._image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
 
-    Utils::endSingleTimeCommands(properties._logicalDevice, properties._commandPool, properties._graphicsQueue, commandBuffer);
+    Utils::endSingleTimeCommands(properties._logicalDevice, properties._commandPool, properties._graphicsQueue, commandBuffer, properties._commandAllocator);
 }
 
 /**
@@ -499,8 +670,26 @@ void maverik::Utils::generateMipmaps(const GenerateMipmapsProperties& properties
         throw std::runtime_error("texture image format does not support linear blitting!");
     }
 
-    VkCommandBuffer commandBuffer = Utils::beginSingleTimeCommands(properties._logicalDevice, properties._commandPool);
+    VkCommandBuffer commandBuffer = Utils::beginSingleTimeCommands(properties._logicalDevice, properties._commandPool, properties._commandAllocator);
+
+    Utils::recordGenerateMipmaps(commandBuffer, properties);
+
+    Utils::endSingleTimeCommands(properties._logicalDevice, properties._commandPool, properties._graphicsQueue, commandBuffer, properties._commandAllocator);
+}
 
+/**
+ * @brief Records the mipmap generation of a Vulkan image into a command buffer.
+ *
+ * Every mip level of the image must be in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, with
+ * the base level already filled. Once the command buffer has executed, every level is in
+ * VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL. Only the image, format, size and mip count of
+ * the properties are used; the caller is responsible for checking linear blit support.
+ *
+ * @param commandBuffer The command buffer, in the recording state.
+ * @param properties The image to generate the mipmaps of.
+ */
+void maverik::Utils::recordGenerateMipmaps(VkCommandBuffer commandBuffer, const GenerateMipmapsProperties& properties)
+{
     VkImageMemoryBarrier barrier{};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     barrier.image = properties._image;
@@ -573,8 +762,6 @@ void maverik::Utils::generateMipmaps(const GenerateMipmapsProperties& properties
         0, nullptr,
         0, nullptr,
         1, &barrier);
-
-    Utils::endSingleTimeCommands(properties._logicalDevice, properties._commandPool, properties._graphicsQueue, commandBuffer);
 }
 
 /**
@@ -590,16 +777,105 @@ void maverik::Utils::generateMipmaps(const GenerateMipmapsProperties& properties
  * @param srcBuffer The source buffer containing the data to be copied.
  * @param dstBuffer The destination buffer where the data will be copied to.
  * @param size The size of the data to copy, in bytes.
+ * @param regions Optional copy regions (e.g. one per sub-allocation), the first size bytes are copied when empty.
  */
 void maverik::Utils::copyBuffer(const CopyBufferProperties& properties)
 {
-    VkCommandBuffer commandBuffer = Utils::beginSingleTimeCommands(properties._logicalDevice, properties._commandPool);
+    VkCommandBuffer commandBuffer = Utils::beginSingleTimeCommands(properties._logicalDevice, properties._commandPool, properties._commandAllocator);
+
+    if (!properties._regions.empty()) {
+        vkCmdCopyBuffer(commandBuffer, properties._srcBuffer, properties._dstBuffer, static_cast<uint32_t>(properties._regions.size()), properties._regions.data());
+    } else {
+        VkBufferCopy copyRegion{};
+        copyRegion.size = properties._size;
+        vkCmdCopyBuffer(commandBuffer, properties._srcBuffer, properties._dstBuffer, 1, &copyRegion);
+    }
+
+    Utils::endSingleTimeCommands(properties._logicalDevice, properties._commandPool, properties._graphicsQueue, commandBuffer, properties._commandAllocator);
+}
+
+/**
+ * @brief Creates a device-local buffer and fills it with host data.
+ *
+ * When findDirectWriteMemoryType() selects a device-local host-visible memory type for
+ * the buffer, the data is copied into it through a mapping, skipping the staging buffer
+ * and the copy submission. Otherwise the data is uploaded through a staging buffer.
+ *
+ * @param properties The properties of the buffer and the data to fill it with.
+ *
+ * @throws std::runtime_error If the buffer creation or memory allocation fails.
+ */
+void maverik::Utils::createDeviceLocalBuffer(const CreateDeviceLocalBufferProperties& properties)
+{
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = properties._size;
+    bufferInfo.usage = properties._usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-    VkBufferCopy copyRegion{};
-    copyRegion.size = properties._size;
-    vkCmdCopyBuffer(commandBuffer, properties._srcBuffer, properties._dstBuffer, 1, &copyRegion);
+    if (vkCreateBuffer(properties._logicalDevice, &bufferInfo, nullptr, &properties._buffer) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create buffer!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(properties._logicalDevice, properties._buffer, &memRequirements);
 
-    Utils::endSingleTimeCommands(properties._logicalDevice, properties._commandPool, properties._graphicsQueue, commandBuffer);
+    uint32_t memoryTypeIndex;
+    bool directWrite = Utils::findDirectWriteMemoryType(properties._physicalDevice, memRequirements.memoryTypeBits, properties._size, memoryTypeIndex);
+    if (!directWrite) {
+        memoryTypeIndex = Utils::findMemoryType(properties._physicalDevice, memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    if (vkAllocateMemory(properties._logicalDevice, &allocInfo, nullptr, &properties._bufferMemory) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate buffer memory!");
+    }
+    vkBindBufferMemory(properties._logicalDevice, properties._buffer, properties._bufferMemory, 0);
+
+    // Writes to coherent memory are visible to the next submission, no copy is needed
+    if (directWrite) {
+        void *data;
+        vkMapMemory(properties._logicalDevice, properties._bufferMemory, 0, properties._size, 0, &data);
+            memcpy(data, properties._data, static_cast<size_t>(properties._size));
+        vkUnmapMemory(properties._logicalDevice, properties._bufferMemory);
+        return;
+    }
+
+    VkBuffer stagingBuffer;
+    VkDeviceMemory stagingBufferMemory;
+    Utils::CreateBufferProperties stagingBufferProperties = {
+        ._logicalDevice = properties._logicalDevice,
+        ._physicalDevice = properties._physicalDevice,
+        ._size = properties._size,
+        ._usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        ._properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        ._buffer = stagingBuffer,
+        ._bufferMemory = stagingBufferMemory
+    };
+    Utils::createBuffer(stagingBufferProperties);
+
+    void *data;
+    vkMapMemory(properties._logicalDevice, stagingBufferMemory, 0, properties._size, 0, &data);
+        memcpy(data, properties._data, static_cast<size_t>(properties._size));
+    vkUnmapMemory(properties._logicalDevice, stagingBufferMemory);
+
+    Utils::CopyBufferProperties copyBufferProperties = {
+        ._logicalDevice = properties._logicalDevice,
+        ._commandPool = properties._commandPool,
+        ._graphicsQueue = properties._graphicsQueue,
+        ._srcBuffer = stagingBuffer,
+        ._dstBuffer = properties._buffer,
+        ._size = properties._size,
+        ._commandAllocator = properties._commandAllocator
+    };
+    Utils::copyBuffer(copyBufferProperties);
+
+    vkDestroyBuffer(properties._logicalDevice, stagingBuffer, nullptr);
+    vkFreeMemory(properties._logicalDevice, stagingBufferMemory, nullptr);
 }
 
 /**
@@ -763,13 +1039,19 @@ VkFormat maverik::Utils::findSupportedDepthFormat(VkPhysicalDevice physicalDevic
  * @throws std::runtime_error If the image view creation fails.
  */
 
-VkImageView maverik::Utils::createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, VkDevice logicalDevice, uint32_t mipLevels)
+VkImageView maverik::Utils::createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, VkDevice logicalDevice, uint32_t mipLevels, VkImageUsageFlags usage, VkComponentMapping components)
 {
+    VkImageViewUsageCreateInfo usageInfo{};
+    usageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO;
+    usageInfo.usage = usage;
+
     VkImageViewCreateInfo viewInfo{};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.pNext = usage != 0 ? &usageInfo : nullptr;
     viewInfo.image = image;
     viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
     viewInfo.format = format;
+    viewInfo.components = components;
     viewInfo.subresourceRange.aspectMask = aspectFlags;
     viewInfo.subresourceRange.baseMipLevel = 0;
     viewInfo.subresourceRange.levelCount = 1;
@@ -841,27 +1123,34 @@ bool maverik::Utils::hasStencilComponent(VkFormat format)
 *
 * This function allocates and begins recording a command buffer that is intended
 * for short-lived operations, such as resource transfers or one-off commands.
-* The command buffer is allocated from the specified command pool and is configured
-* with the `VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT` flag, indicating that it
-* will be submitted only once before being reset or freed.
+* When a frame-scoped command allocator is given, the command buffer is one of its
+* recycled one-shot command buffers; otherwise it is allocated from the specified command pool.
+* The command buffer is configured with the `VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT`
+* flag, indicating that it will be submitted only once before being reset or freed.
 *
 * @param logicalDevice The Vulkan logical device used to allocate the command buffer.
 * @param commandPool The command pool from which the command buffer will be allocated.
+* @param commandAllocator Optional frame-scoped allocator handing out recycled command buffers.
 * @return VkCommandBuffer The allocated and begun command buffer ready for recording commands.
 *
 * @note The caller is responsible for ending the command buffer recording and submitting
 *       it to a queue, as well as cleaning up resources after use.
 */
-VkCommandBuffer maverik::Utils::beginSingleTimeCommands(VkDevice logicalDevice, VkCommandPool commandPool)
+VkCommandBuffer maverik::Utils::beginSingleTimeCommands(VkDevice logicalDevice, VkCommandPool commandPool, CommandAllocator *commandAllocator)
 {
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandPool = commandPool;
-    allocInfo.commandBufferCount = 1;
-
     VkCommandBuffer commandBuffer;
-    vkAllocateCommandBuffers(logicalDevice, &allocInfo, &commandBuffer);
+
+    if (commandAllocator != nullptr) {
+        commandBuffer = commandAllocator->allocateImmediate();
+    } else {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = commandPool;
+        allocInfo.commandBufferCount = 1;
+
+        vkAllocateCommandBuffers(logicalDevice, &allocInfo, &commandBuffer);
+    }
 
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -877,14 +1166,16 @@ VkCommandBuffer maverik::Utils::beginSingleTimeCommands(VkDevice logicalDevice,
  *
  * This function finalizes the execution of a single-time command buffer by
  * submitting it to the specified graphics queue, waiting for the queue to
- * become idle, and then freeing the command buffer resources.
+ * become idle, and then freeing the command buffer resources. Command buffers
+ * handed out by a frame-scoped allocator are given back to it for reuse.
  *
  * @param logicalDevice The Vulkan logical device used to free the command buffer.
  * @param commandPool The command pool from which the command buffer was allocated.
  * @param graphicsQueue The Vulkan queue to which the command buffer is submitted.
  * @param commandBuffer The command buffer to be ended, submitted, and freed.
+ * @param commandAllocator The frame-scoped allocator the command buffer comes from, if any.
  */
-void maverik::Utils::endSingleTimeCommands(VkDevice logicalDevice, VkCommandPool commandPool, VkQueue graphicsQueue, VkCommandBuffer commandBuffer)
+void maverik::Utils::endSingleTimeCommands(VkDevice logicalDevice, VkCommandPool commandPool, VkQueue graphicsQueue, VkCommandBuffer commandBuffer, CommandAllocator *commandAllocator)
 {
     vkEndCommandBuffer(commandBuffer);
 
@@ -896,7 +1187,11 @@ void maverik::Utils::endSingleTimeCommands(VkDevice logicalDevice, VkCommandPool
     vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
     vkQueueWaitIdle(graphicsQueue);
 
-    vkFreeCommandBuffers(logicalDevice, commandPool, 1, &commandBuffer);
+    if (commandAllocator != nullptr) {
+        commandAllocator->recycle(commandBuffer);
+    } else {
+        vkFreeCommandBuffers(logicalDevice, commandPool, 1, &commandBuffer);
+    }
 }
 
 /**
@@ -0,0 +1,62 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** VertexLayout
+*/
+
+#include "VertexLayout.hpp"
+#include "TextureFormat.hpp"
+
+#include <cmath>
+
+////////////////////
+// Public methods //
+////////////////////
+
+uint16_t maverik::VertexQuantization::toHalf(float value)
+{
+    uint16_t half;
+
+    TextureFormat::floatToHalf(&value, &half, 1);
+    return half;
+}
+
+int16_t maverik::VertexQuantization::toSnorm16(float value)
+{
+    return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+uint8_t maverik::VertexQuantization::toUnorm8(float value)
+{
+    return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+
+glm::vec2 maverik::VertexQuantization::encodeOctahedral(const glm::vec3& normal)
+{
+    float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+
+    if (length <= 0.0f) {
+        return glm::vec2(0.0f, 0.0f);
+    }
+
+    glm::vec2 encoded(normal.x / length, normal.y / length);
+    // The lower hemisphere is folded over the diagonals onto the corners of the square
+    if (normal.z < 0.0f) {
+        encoded = glm::vec2(
+            (1.0f - std::abs(encoded.y)) * (encoded.x >= 0.0f ? 1.0f : -1.0f),
+            (1.0f - std::abs(encoded.x)) * (encoded.y >= 0.0f ? 1.0f : -1.0f)
+        );
+    }
+    return encoded;
+}
+
+glm::vec3 maverik::VertexQuantization::decodeOctahedral(const glm::vec2& encoded)
+{
+    glm::vec3 normal(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+    float fold = std::max(-normal.z, 0.0f);
+
+    normal.x += normal.x >= 0.0f ? -fold : fold;
+    normal.y += normal.y >= 0.0f ? -fold : fold;
+    return glm::normalize(normal);
+}
@@ -24,7 +24,7 @@ std::shared_ptr<maverik::FileAsset> maverik::vk::AssetsManager::add(const std::s
     file.seekg(0, std::ios::beg);
     file.read(&content[0], content.size());
     file.close();
-    _assets[path] = std::make_shared<maverik::FileAsset>(content);
+    _assets[path] = std::make_shared<maverik::FileAsset>(std::move(content));
     if (!_assets[path]) {
         std::cerr << "Failed to create FileAsset for: " << path << std::endl;
         return nullptr;
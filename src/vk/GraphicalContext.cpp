@@ -47,7 +47,14 @@ maverik::vk::GraphicalContext::GraphicalContext()
         ._msaaSamples = vulkanContext->msaaSamples,
         ._commandPool = vulkanContext->commandPool,
         ._graphicsQueue = vulkanContext->graphicsQueue,
-        ._instance = _instance
+        ._instance = _instance,
+        ._commandAllocator = vulkanContext->commandAllocator.get(),
+        ._bindlessTextureTable = vulkanContext->bindlessTextureTable.get(),
+        ._samplerCache = vulkanContext->samplerCache.get(),
+        ._hostImageCopy = vulkanContext->hostImageCopy.get(),
+        ._pipelineCache = vulkanContext->pipelineCache->getHandle(),
+        ._resourceStateTracker = vulkanContext->resourceStateTracker.get(),
+        ._computeMipGenerator = vulkanContext->computeMipGenerator.get()
     };
 
     _swapchainContext = std::make_shared<maverik::vk::SwapchainContext>(swapchainProperties);
@@ -78,7 +85,14 @@ maverik::vk::GraphicalContext::GraphicalContext(const std::string &appName, cons
         ._msaaSamples = vulkanContext->msaaSamples,
         ._commandPool = vulkanContext->commandPool,
         ._graphicsQueue = vulkanContext->graphicsQueue,
-        ._instance = _instance
+        ._instance = _instance,
+        ._commandAllocator = vulkanContext->commandAllocator.get(),
+        ._bindlessTextureTable = vulkanContext->bindlessTextureTable.get(),
+        ._samplerCache = vulkanContext->samplerCache.get(),
+        ._hostImageCopy = vulkanContext->hostImageCopy.get(),
+        ._pipelineCache = vulkanContext->pipelineCache->getHandle(),
+        ._resourceStateTracker = vulkanContext->resourceStateTracker.get(),
+        ._computeMipGenerator = vulkanContext->computeMipGenerator.get()
     };
 
     _swapchainContext = std::make_shared<maverik::vk::SwapchainContext>(swapchainProperties);
@@ -110,7 +124,7 @@ void maverik::vk::GraphicalContext::createInstance()
     appInfo.applicationVersion = _appVersion->to_uint32_t();
     appInfo.pEngineName = _engineName.c_str();
     appInfo.engineVersion = _engineVersion->to_uint32_t();
-    appInfo.apiVersion = VK_API_VERSION_1_0;
+    appInfo.apiVersion = VK_API_VERSION_1_3;
 
     VkInstanceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -42,9 +42,15 @@ maverik::vk::RenderingContext::RenderingContext(const WindowProperties &windowPr
     this->pickPhysicalDevice(instance);
     this->createLogicalDevice();
     this->createCommandPool();
-    this->createVertexBuffer();
-    this->createIndexBuffer();
-    this->createCommandBuffers();
+    this->createCommandAllocator(MAX_FRAMES_IN_FLIGHT);
+    this->createBindlessTextureTable(MAX_FRAMES_IN_FLIGHT);
+    this->createSamplerCache();
+    this->createHostImageCopy();
+    this->createDynamicGeometry(MAX_FRAMES_IN_FLIGHT);
+    this->createPipelineCache();
+    this->createResourceStateTracker();
+    this->createComputeMipGenerator();
+    this->allocateMesh();
     this->createSyncObjects();
 
     // Initialize VulkanContext (used to setup the rest of the engine)
@@ -57,12 +63,50 @@ maverik::vk::RenderingContext::RenderingContext(const WindowProperties &windowPr
     _vulkanContext->surface = _surface;
     _vulkanContext->window = _window;
     _vulkanContext->msaaSamples = _msaaSamples;
+    _vulkanContext->commandAllocator = _commandAllocator;
+    _vulkanContext->capabilities = _capabilities;
+    _vulkanContext->bindlessTextureTable = _bindlessTextureTable;
+    _vulkanContext->samplerCache = _samplerCache;
+    _vulkanContext->hostImageCopy = _hostImageCopy;
+    _vulkanContext->dynamicGeometry = _dynamicGeometry;
+    _vulkanContext->pipelineCache = _pipelineCache;
+    _vulkanContext->resourceStateTracker = _resourceStateTracker;
+    _vulkanContext->computeMipGenerator = _computeMipGenerator;
 }
 
 maverik::vk::RenderingContext::~RenderingContext()
 {
 }
 
+VkCommandBuffer maverik::vk::RenderingContext::beginFrame(uint32_t currentFrame)
+{
+    _commandAllocator->beginFrame(currentFrame, _inFlightFences[currentFrame]);
+    _dynamicGeometry->beginFrame(currentFrame);
+    if (_bindlessTextureTable != nullptr) {
+        _bindlessTextureTable->beginFrame();
+    }
+    return _commandAllocator->allocate();
+}
+
+void maverik::vk::RenderingContext::setMesh(MeshData mesh, bool optimize, uint32_t lodCount)
+{
+    if (optimize) {
+        MeshOptimizer::optimize(mesh);
+    }
+    _lods = MeshSimplifier::generateLods(mesh, lodCount);
+    vkDeviceWaitIdle(_logicalDevice);
+
+    this->getGeometryPool()->free(_mesh);
+    _vertices = std::move(mesh._vertices);
+    _indices = std::move(mesh._indices);
+    this->allocateMesh();
+}
+
+void maverik::vk::RenderingContext::bindGeometryBuffers(VkCommandBuffer commandBuffer) const
+{
+    this->getGeometryPool()->bind(commandBuffer);
+}
+
 void maverik::vk::RenderingContext::initWindow(unsigned int width, unsigned int height, const std::string &title)
 {
     if (!glfwInit()) {
@@ -146,20 +190,72 @@ void maverik::vk::RenderingContext::createLogicalDevice()
         queueCreateInfos.push_back(queueCreateInfo);
     }
 
+    // Optional features are enabled only when the device supports them
+    _capabilities = Utils::queryDeviceCapabilities(_physicalDevice);
+
     VkPhysicalDeviceFeatures deviceFeatures{};
     deviceFeatures.samplerAnisotropy = VK_TRUE;
     deviceFeatures.sampleRateShading = VK_TRUE;
+    deviceFeatures.textureCompressionBC = _capabilities._textureCompressionBC ? VK_TRUE : VK_FALSE;
+    deviceFeatures.textureCompressionETC2 = _capabilities._textureCompressionETC2 ? VK_TRUE : VK_FALSE;
+    deviceFeatures.textureCompressionASTC_LDR = _capabilities._textureCompressionASTC ? VK_TRUE : VK_FALSE;
+    deviceFeatures.multiDrawIndirect = _capabilities._multiDrawIndirect ? VK_TRUE : VK_FALSE;
+    deviceFeatures.drawIndirectFirstInstance = _capabilities._multiDrawIndirect ? VK_TRUE : VK_FALSE;
+    std::vector<const char*> enabledExtensions = deviceExtensions;
+    if (_capabilities._drawIndirectCount) {
+        enabledExtensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+    }
+    void *featuresChain = nullptr;
+
+    VkPhysicalDeviceSynchronization2Features synchronization2Features{};
+    synchronization2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES;
+    if (_capabilities._synchronization2) {
+        synchronization2Features.synchronization2 = VK_TRUE;
+        synchronization2Features.pNext = featuresChain;
+        featuresChain = &synchronization2Features;
+        if (_capabilities._apiVersion < VK_API_VERSION_1_3) {
+            enabledExtensions.push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+        }
+    }
+
+    VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures{};
+    descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+    if (_capabilities._descriptorIndexing) {
+        descriptorIndexingFeatures.runtimeDescriptorArray = VK_TRUE;
+        descriptorIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+        descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+        descriptorIndexingFeatures.pNext = featuresChain;
+        featuresChain = &descriptorIndexingFeatures;
+        if (_capabilities._apiVersion < VK_API_VERSION_1_2) {
+            enabledExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+        }
+    }
+
+    VkPhysicalDeviceHostImageCopyFeaturesEXT hostImageCopyFeatures{};
+    hostImageCopyFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT;
+    if (_capabilities._hostImageCopy) {
+        hostImageCopyFeatures.hostImageCopy = VK_TRUE;
+        hostImageCopyFeatures.pNext = featuresChain;
+        featuresChain = &hostImageCopyFeatures;
+        enabledExtensions.push_back(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME);
+        if (_capabilities._apiVersion < VK_API_VERSION_1_3) {
+            enabledExtensions.push_back(VK_KHR_COPY_COMMANDS_2_EXTENSION_NAME);
+            enabledExtensions.push_back(VK_KHR_FORMAT_FEATURE_FLAGS_2_EXTENSION_NAME);
+        }
+    }
 
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    createInfo.pNext = featuresChain;
 
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
     createInfo.pEnabledFeatures = &deviceFeatures;
 
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
+    createInfo.ppEnabledExtensionNames = enabledExtensions.data();
 
     if (enableValidationLayers) {
         createInfo.enabledLayerCount = static_cast<uint32_t>(validationLayers.size());
@@ -190,111 +286,26 @@ void maverik::vk::RenderingContext::createCommandPool()
     }
 }
 
-void maverik::vk::RenderingContext::createVertexBuffer()
+void maverik::vk::RenderingContext::allocateMesh()
 {
-    VkDeviceSize bufferSize = sizeof(_vertices[0]) * _vertices.size();
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-
-    Utils::CreateBufferProperties stagingBufferProperties = {
-        ._logicalDevice = _logicalDevice,
-        ._physicalDevice = _physicalDevice,
-        ._size = bufferSize,
-        ._usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        ._buffer = stagingBuffer,
-        ._bufferMemory = stagingBufferMemory
-    };
-
-    Utils::createBuffer(stagingBufferProperties);
-
-    void* data;
-    vkMapMemory(_logicalDevice, stagingBufferMemory, 0, bufferSize, 0, &data);
-        memcpy(data, _vertices.data(), (size_t) bufferSize);
-    vkUnmapMemory(_logicalDevice, stagingBufferMemory);
-
-    Utils::CreateBufferProperties vertexBufferProperties = {
-        ._logicalDevice = _logicalDevice,
-        ._physicalDevice = _physicalDevice,
-        ._size = bufferSize,
-        ._usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        ._buffer = _vertexBuffer,
-        ._bufferMemory = _vertexBufferMemory
-    };
-    Utils::createBuffer(vertexBufferProperties);
-
-    Utils::CopyBufferProperties copyBufferProperties = {
-        ._logicalDevice = _logicalDevice,
-        ._commandPool = _commandPool,
-        ._graphicsQueue = _graphicsQueue,
-        ._srcBuffer = stagingBuffer,
-        ._dstBuffer = _vertexBuffer,
-        ._size = bufferSize
-    };
-    Utils::copyBuffer(copyBufferProperties);
-
-    vkDestroyBuffer(_logicalDevice, stagingBuffer, nullptr);
-    vkFreeMemory(_logicalDevice, stagingBufferMemory, nullptr);
-}
-
-void maverik::vk::RenderingContext::createIndexBuffer()
-{
-    VkDeviceSize bufferSize = sizeof(_indices[0]) * _indices.size();
-
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-    Utils::CreateBufferProperties stagingBufferProperties = {
-        ._logicalDevice = _logicalDevice,
-        ._physicalDevice = _physicalDevice,
-        ._size = bufferSize,
-        ._usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        ._buffer = stagingBuffer,
-        ._bufferMemory = stagingBufferMemory
-    };
-
-    Utils::createBuffer(stagingBufferProperties);
-
-    void* data;
-    vkMapMemory(_logicalDevice, stagingBufferMemory, 0, bufferSize, 0, &data);
-    memcpy(data, _indices.data(), (size_t) bufferSize);
-    vkUnmapMemory(_logicalDevice, stagingBufferMemory);
-
-    Utils::CreateBufferProperties indexBufferProperties = {
-        ._logicalDevice = _logicalDevice,
-        ._physicalDevice = _physicalDevice,
-        ._size = bufferSize,
-        ._usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-        ._buffer = _indexBuffer,
-        ._bufferMemory = _indexBufferMemory
-    };
-    Utils::createBuffer(indexBufferProperties);
-
-    Utils::CopyBufferProperties copyBufferProperties = {
-        ._logicalDevice = _logicalDevice,
-        ._commandPool = _commandPool,
-        ._graphicsQueue = _graphicsQueue,
-        ._srcBuffer = stagingBuffer,
-        ._dstBuffer = _indexBuffer,
-        ._size = bufferSize
-    };
-    Utils::copyBuffer(copyBufferProperties);
-
-    vkDestroyBuffer(_logicalDevice, stagingBuffer, nullptr);
-    vkFreeMemory(_logicalDevice, stagingBufferMemory, nullptr);
-}
-
-void maverik::vk::RenderingContext::createCommandBuffers()
-{
-    _commandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
-
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.commandPool = _commandPool;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandBufferCount = (uint32_t) _commandBuffers.size();
-
-    if (vkAllocateCommandBuffers(_logicalDevice, &allocInfo, _commandBuffers.data()) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to allocate command buffers!");
+    _meshIndexType = MeshOptimizer::selectIndexType(_vertices.size());
+
+    std::shared_ptr<GeometryPool>& geometryPool = _geometryPools[_meshIndexType];
+    if (geometryPool == nullptr) {
+        GeometryPool::GeometryPoolCreationProperties geometryPoolProperties = {
+            ._physicalDevice = _physicalDevice,
+            ._logicalDevice = _logicalDevice,
+            ._commandPool = _commandPool,
+            ._graphicsQueue = _graphicsQueue,
+            ._vertexStride = sizeof(Vertex),
+            ._indexType = _meshIndexType,
+            ._vertexCapacity = std::max(static_cast<uint32_t>(_vertices.size()), 1u << 16),
+            ._indexCapacity = std::max(static_cast<uint32_t>(_indices.size()), 1u << 18),
+            ._commandAllocator = _commandAllocator.get()
+        };
+        geometryPool = std::make_shared<GeometryPool>(geometryPoolProperties);
     }
+    _mesh = geometryPool->allocate(_vertices, _indices);
 }
 
 void maverik::vk::RenderingContext::createSyncObjects()
@@ -6,6 +6,15 @@
 */
 
 #include "vk/SwapchainContext.hpp"
+#include "KtxTexture.hpp"
+#include "CookedTexture.hpp"
+#include "TextureFormat.hpp"
+#include "vk/AssetsManager.hpp"
+
+#include <deque>
+#include <mutex>
+#include <climits>
+#include <condition_variable>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -16,6 +25,22 @@
     const bool enableValidationLayers = true;
 #endif
 
+/*
+ * Number of texture uploads createTextureImages lets in flight on the GPU, each one
+ * keeping its staging buffer alive until its fence is signaled.
+ */
+static constexpr size_t MAX_PENDING_TEXTURE_UPLOADS = 4;
+
+/*
+ * Pixels of an image decoded and converted to the format selected for its usage.
+ */
+struct DecodedTexture {
+    std::vector<uint8_t> _pixels;
+    uint32_t _width = 0;
+    uint32_t _height = 0;
+    maverik::TextureFormat::Selection _selection = {};
+};
+
 
 ////////////////////
 // Static methods //
@@ -41,6 +66,146 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL defaultDebugCallback(VkDebugUtilsMessageSe
     return VK_FALSE;
 }
 
+/**
+ * @brief Checks whether the mip chain of a format can be generated with linear-filter blits.
+ *
+ * @param physicalDevice The Vulkan physical device to query.
+ * @param format The format of the texture.
+ * @return true if images of the format can be blitted with linear filtering.
+ */
+static bool supportsLinearBlit(VkPhysicalDevice physicalDevice, VkFormat format)
+{
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &formatProperties);
+    return (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) != 0;
+}
+
+/**
+ * @brief Checks whether textures of a format can be sampled and get their mipmaps generated.
+ *
+ * @param physicalDevice The Vulkan physical device to query.
+ * @param format The format of the texture.
+ * @param computeMipGenerator The compute mip generator, if any, tried before linear blits.
+ * @return true if the format is sampleable and its mip chain can be generated.
+ */
+static bool canGenerateTextureMipmaps(VkPhysicalDevice physicalDevice, VkFormat format, maverik::ComputeMipGenerator *computeMipGenerator)
+{
+    if (!maverik::Utils::isFormatSampleable(physicalDevice, format)) {
+        return false;
+    }
+    if (computeMipGenerator != nullptr && maverik::ComputeMipGenerator::isFormatSupported(physicalDevice, format)) {
+        return true;
+    }
+    return supportsLinearBlit(physicalDevice, format);
+}
+
+/**
+ * @brief Get the copy region of the base level of a tightly packed image.
+ */
+static VkBufferImageCopy getBaseLevelRegion(uint32_t width, uint32_t height)
+{
+    VkBufferImageCopy region{};
+
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = {width, height, 1};
+    return region;
+}
+
+/**
+ * @brief Reads a texture file, through an asset manager if any.
+ *
+ * Without an asset manager, the file is read by a temporary one so every texture goes
+ * through the same I/O path, the asset is then only kept alive by its users.
+ *
+ * @param texturePath The file path to the texture.
+ * @param assetManager The asset manager the file is read through and cached in, if any.
+ * @return std::shared_ptr<maverik::FileAsset> The asset holding the content of the file.
+ *
+ * @throws std::runtime_error If the file cannot be read.
+ */
+static std::shared_ptr<maverik::FileAsset> loadTextureAsset(const std::string& texturePath, maverik::AAssetManager *assetManager)
+{
+    std::shared_ptr<maverik::FileAsset> asset;
+
+    if (assetManager != nullptr) {
+        asset = assetManager->add(texturePath);
+    } else {
+        maverik::vk::AssetsManager temporaryManager;
+        asset = temporaryManager.add(texturePath);
+    }
+    if (asset == nullptr) {
+        throw std::runtime_error("Failed to read texture file " + texturePath + " !");
+    }
+    return asset;
+}
+
+/**
+ * @brief Decodes an image into the smallest format its channels and usage allow.
+ *
+ * The format is selected from the channel count and bit depth of the file, then widened
+ * to four channels if the device cannot sample it or generate its mipmaps. The image is
+ * decoded from the content of its asset, which is only read, so this is safe to call from
+ * worker threads.
+ *
+ * @param asset The asset holding the encoded image.
+ * @param physicalDevice The Vulkan physical device the texture is created on.
+ * @param usage What the texture is used for.
+ * @param computeMipGenerator The compute mip generator the mipmaps are generated with, if any.
+ * @param texture The decoded texture.
+ * @return true on success, false if the image cannot be decoded or no format is supported.
+ */
+static bool decodeTexture(const maverik::FileAsset& asset, VkPhysicalDevice physicalDevice, maverik::TextureFormat::Usage usage, maverik::ComputeMipGenerator *computeMipGenerator, DecodedTexture& texture)
+{
+    using maverik::TextureFormat;
+    const stbi_uc *buffer = reinterpret_cast<const stbi_uc *>(asset.content().data());
+    int length = static_cast<int>(asset.content().size());
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+
+    if (asset.content().size() > static_cast<size_t>(INT_MAX) || !stbi_info_from_memory(buffer, length, &width, &height, &channels)) {
+        return false;
+    }
+
+    TextureFormat::Precision sourcePrecision = stbi_is_hdr_from_memory(buffer, length) ? TextureFormat::Precision::FLOAT
+        : stbi_is_16_bit_from_memory(buffer, length) ? TextureFormat::Precision::UNORM16
+        : TextureFormat::Precision::UNORM8;
+    texture._selection = TextureFormat::select(static_cast<uint32_t>(channels), usage, sourcePrecision);
+    if (!canGenerateTextureMipmaps(physicalDevice, texture._selection._format, computeMipGenerator)) {
+        texture._selection = TextureFormat::widen(texture._selection);
+        if (!canGenerateTextureMipmaps(physicalDevice, texture._selection._format, computeMipGenerator)) {
+            return false;
+        }
+    }
+
+    // Channels are kept as stored in the file, the conversion expands or drops them
+    void *pixels = nullptr;
+    switch (texture._selection._precision) {
+        case TextureFormat::Precision::UNORM8:
+            pixels = stbi_load_from_memory(buffer, length, &width, &height, &channels, 0);
+            break;
+        case TextureFormat::Precision::UNORM16:
+            pixels = stbi_load_16_from_memory(buffer, length, &width, &height, &channels, 0);
+            break;
+        case TextureFormat::Precision::FLOAT:
+            pixels = stbi_loadf_from_memory(buffer, length, &width, &height, &channels, 0);
+            break;
+    }
+    if (!pixels) {
+        return false;
+    }
+
+    size_t pixelCount = static_cast<size_t>(width) * height;
+    texture._width = static_cast<uint32_t>(width);
+    texture._height = static_cast<uint32_t>(height);
+    texture._pixels.resize(pixelCount * texture._selection.getBytesPerPixel());
+    TextureFormat::convert(pixels, static_cast<uint32_t>(channels), texture._selection, pixelCount, texture._pixels.data());
+    stbi_image_free(pixels);
+    return true;
+}
+
 ////////////////////
 // Public methods //
 ////////////////////
@@ -52,9 +217,13 @@ maverik::vk::SwapchainContext::SwapchainContext(const SwapchainContextCreationPr
         properties._logicalDevice,
         properties._commandPool,
         properties._msaaSamples,
-        properties._graphicsQueue
+        properties._graphicsQueue,
+        properties._commandAllocator
     };
 
+    textureImageProperties._computeMipGenerator = properties._computeMipGenerator;
+    textureImageProperties._resourceStateTracker = properties._resourceStateTracker;
+
     this->_creationProperties = properties;
 
     this->setupDebugMessenger(properties._instance);
@@ -72,7 +241,7 @@ maverik::vk::SwapchainContext::SwapchainContext(const SwapchainContextCreationPr
     this->createUniformBuffers(properties._logicalDevice, properties._physicalDevice);
     this->createDescriptorPool(properties._logicalDevice);
     this->createDescriptorSets(properties._logicalDevice, {
-        {this->_textureImageView.begin()->second, this->_textureSampler.begin()->second}
+        {_textures.getTextures().front()._view, _textures.getTextures().front()._sampler}
     });
 
     this->createGraphicsPipeline();
@@ -91,9 +260,13 @@ void maverik::vk::SwapchainContext::recreate(const SwapchainContextCreationPrope
         properties._logicalDevice,
         properties._commandPool,
         properties._msaaSamples,
-        properties._graphicsQueue
+        properties._graphicsQueue,
+        properties._commandAllocator
     };
 
+    textureImageProperties._computeMipGenerator = properties._computeMipGenerator;
+    textureImageProperties._resourceStateTracker = properties._resourceStateTracker;
+
     while (width == 0 || height == 0) {
         glfwGetFramebufferSize(properties._window, &width, &height);
         glfwWaitEvents();
@@ -109,6 +282,37 @@ void maverik::vk::SwapchainContext::recreate(const SwapchainContextCreationPrope
     this->createFramebuffers(properties._logicalDevice, _renderPass);
 }
 
+VkPipeline maverik::vk::SwapchainContext::getGraphicsPipeline(bool instanced) const
+{
+    if (!instanced) {
+        return _graphicsPipeline;
+    }
+    return _pipelineStateCache->request(this->getPipelineDescription(true), _graphicsPipeline);
+}
+
+maverik::PipelineDescription maverik::vk::SwapchainContext::getPipelineDescription(bool instanced) const
+{
+    PipelineDescription description;
+    auto attributeDescriptions = Vertex::getAttributeDescriptions();
+
+    description._vertexShader = _creationProperties._shaderDirectory + (instanced ? "/instanced.vert.spv" : "/vert.spv");
+    // In bindless mode the fragment shader samples the array of set 1 instead of the texture of set 0
+    description._fragmentShader = _creationProperties._shaderDirectory + (_creationProperties._bindlessTextureTable != nullptr ? "/bindless.frag.spv" : "/frag.spv");
+    description._bindings = {Vertex::getBindingDescription()};
+    description._attributes.assign(attributeDescriptions.begin(), attributeDescriptions.end());
+    // Same states, with the per-instance binding and the vertex shader reading it
+    if (instanced) {
+        auto instanceAttributes = InstanceData::getAttributeDescriptions();
+        description._bindings.push_back(InstanceData::getBindingDescription());
+        description._attributes.insert(description._attributes.end(), instanceAttributes.begin(), instanceAttributes.end());
+    }
+    description._samples = _creationProperties._msaaSamples;
+    description._minSampleShading = .2f;
+    description._layout = _pipelineLayout;
+    description._renderPass = _renderPass;
+    return description;
+}
+
 ///////////////////////
 // Protected methods //
 ///////////////////////
@@ -240,7 +444,7 @@ void maverik::vk::SwapchainContext::createImageViews(VkDevice logicalDevice)
     _imageViews.resize(_swapchainImages.size());
 
     for (uint32_t i = 0; i < _swapchainImages.size(); i++) {
-        _imageViews[i] = Utils::createImageView(_swapchainImages[i], _swapchainColorFormat, VK_IMAGE_ASPECT_COLOR_BIT, logicalDevice, _mipLevels);
+        _imageViews[i] = Utils::createImageView(_swapchainImages[i], _swapchainColorFormat, VK_IMAGE_ASPECT_COLOR_BIT, logicalDevice, 1);
     }
 }
 
@@ -283,51 +487,374 @@ void maverik::vk::SwapchainContext::cleanup(VkDevice logicalDevice)
     vkDestroySwapchainKHR(logicalDevice, _swapchain.swapchain, nullptr);
 }
 
-void maverik::vk::SwapchainContext::createTextureImage(const std::string& texturePath, const TextureImageCreationProperties& properties)
+maverik::TextureHandle maverik::vk::SwapchainContext::createTextureImage(const std::string& texturePath, const TextureImageCreationProperties& properties)
 {
-    int texWidth = 0;
-    int texHeight = 0;
-    int texChannels = 0;
-    stbi_uc* pixels = stbi_load(texturePath.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-    VkDeviceSize imageSize = texWidth * texHeight * 4;
+    if (_textures.find(texturePath).isValid()) {
+        throw std::runtime_error("Texture " + texturePath + " is already loaded !");
+    }
+
+    std::shared_ptr<FileAsset> asset = loadTextureAsset(texturePath, properties._assetManager);
+
+    if (KtxTexture::isKtx2Path(texturePath)) {
+        return this->createKtxTextureImage(texturePath, asset, properties);
+    }
+    if (CookedTexture::isCookedPath(texturePath)) {
+        return this->createCookedTextureImage(texturePath, asset, properties);
+    }
+
+    DecodedTexture decoded;
+    VkBuffer stagingBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory stagingBufferMemory = VK_NULL_HANDLE;
+
+    if (!decodeTexture(*asset, properties._physicalDevice, properties._usage, properties._computeMipGenerator, decoded)) {
+        throw std::runtime_error("Failed to load texture image " + texturePath + " !");
+    }
+
+    // Formats without linear-filter blit support get their mip chain from the compute generator
+    if (!supportsLinearBlit(properties._physicalDevice, decoded._selection._format)
+        && this->usesComputeMipGeneration(properties, decoded._selection._format)) {
+        TextureUpload upload = this->submitTextureUpload(texturePath, properties, decoded._selection, decoded._pixels.data(), decoded._width, decoded._height);
+
+        this->retireTextureUpload(upload, properties);
+        return _textures.find(texturePath);
+    }
+
+    uint32_t texWidth = decoded._width;
+    uint32_t texHeight = decoded._height;
+    VkFormat format = decoded._selection._format;
+    VkDeviceSize imageSize = decoded._pixels.size();
+    uint32_t mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
+    Texture texture = {
+        ._name = texturePath,
+        ._format = format,
+        ._width = texWidth,
+        ._height = texHeight,
+        ._mipLevels = mipLevels,
+        ._swizzle = decoded._selection._swizzle
+    };
+
+    // The base level is copied from the host when possible, only mip generation then runs on the GPU
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    bool hostCopy = properties._hostImageCopy != nullptr
+        && properties._hostImageCopy->isSupported(format, usage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+    if (!hostCopy) {
+        Utils::CreateBufferProperties stagingBufferProperties = {
+            ._logicalDevice = properties._logicalDevice,
+            ._physicalDevice = properties._physicalDevice,
+            ._size = imageSize,
+            ._usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            ._properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            ._buffer = stagingBuffer,
+            ._bufferMemory = stagingBufferMemory
+        };
+
+        Utils::createBuffer(stagingBufferProperties);
+
+        void* data;
+        vkMapMemory(properties._logicalDevice, stagingBufferMemory, 0, imageSize, 0, &data);
+            memcpy(data, decoded._pixels.data(), static_cast<size_t>(imageSize));
+        vkUnmapMemory(properties._logicalDevice, stagingBufferMemory);
+    }
+
+    Utils::CreateImageProperties imageProperties = {
+        ._logicalDevice = properties._logicalDevice,
+        ._physicalDevice = properties._physicalDevice,
+        ._width = texWidth,
+        ._height = texHeight,
+        ._mipLevels = mipLevels,
+        ._numSamples = VK_SAMPLE_COUNT_1_BIT,
+        ._format = format,
+        ._tiling = VK_IMAGE_TILING_OPTIMAL,
+        ._usage = hostCopy ? usage | VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT : usage,
+        ._properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        ._image = texture._image,
+        ._imageMemory = texture._memory
+    };
+    Utils::createImage(imageProperties);
+
+    if (hostCopy) {
+        properties._hostImageCopy->transitionLayout(texture._image, mipLevels, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        properties._hostImageCopy->copyToImage(texture._image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            reinterpret_cast<const char *>(decoded._pixels.data()), {getBaseLevelRegion(texWidth, texHeight)});
+    } else {
+        Utils::TransitionImageLayoutProperties transitionProperties = {
+            ._logicalDevice = properties._logicalDevice,
+            ._commandPool = properties._commandPool,
+            ._graphicsQueue = properties._graphicsQueue,
+            ._image = texture._image,
+            ._format = format,
+            ._oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            ._newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            ._mipLevels = mipLevels,
+            ._commandAllocator = properties._commandAllocator,
+            ._resourceStateTracker = this->getResourceStateTracker(properties)
+        };
+        Utils::transitionImageLayout(transitionProperties);
+
+        Utils::CopyBufferToImageProperties copyProperties = {
+            ._logicalDevice = properties._logicalDevice,
+            ._commandPool = properties._commandPool,
+            ._graphicsQueue = properties._graphicsQueue,
+            ._buffer = stagingBuffer,
+            ._image = texture._image,
+            ._width = texWidth,
+            ._height = texHeight,
+            ._commandAllocator = properties._commandAllocator
+        };
+        Utils::copyBufferToImage(copyProperties);
+    }
+
+    Utils::GenerateMipmapsProperties propertiesMipmap = {
+        ._physicalDevice = properties._physicalDevice,
+        ._logicalDevice = properties._logicalDevice,
+        ._commandPool = properties._commandPool,
+        ._graphicsQueue = properties._graphicsQueue,
+        ._image = texture._image,
+        ._imageFormat = format,
+        ._texWidth = texWidth,
+        ._texHeight = texHeight,
+        ._mipLevels = mipLevels,
+        ._commandAllocator = properties._commandAllocator
+    };
+    Utils::generateMipmaps(propertiesMipmap);
+    // The blits record their own barriers, every level ends up sampled
+    this->getResourceStateTracker(properties)->registerImage(texture._image, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 1, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    vkDestroyBuffer(properties._logicalDevice, stagingBuffer, nullptr);
+    vkFreeMemory(properties._logicalDevice, stagingBufferMemory, nullptr);
+    return _textures.add(texture);
+}
+
+std::vector<maverik::TextureHandle> maverik::vk::SwapchainContext::createTextureImages(const std::vector<std::string>& texturePaths, const TextureImageCreationProperties& properties, ThreadPool *threadPool)
+{
+    struct DecodedImage {
+        std::string _path;
+        bool _decoded;
+        DecodedTexture _texture;
+    };
+
+    std::unique_ptr<ThreadPool> ownedThreadPool;
+    std::mutex decodedMutex;
+    std::condition_variable decodedCondition;
+    std::deque<DecodedImage> decodedImages;
+    std::vector<std::shared_ptr<FileAsset>> assets;
+    size_t decodeCount = 0;
+
+    for (const auto& texturePath : texturePaths) {
+        if (_textures.find(texturePath).isValid()) {
+            throw std::runtime_error("Texture " + texturePath + " is already loaded !");
+        }
+    }
+    // Asset managers are not thread-safe, files are read here and only decoded by the workers
+    assets.reserve(texturePaths.size());
+    for (const auto& texturePath : texturePaths) {
+        assets.push_back(loadTextureAsset(texturePath, properties._assetManager));
+    }
+    if (threadPool == nullptr) {
+        ownedThreadPool = std::make_unique<ThreadPool>();
+        threadPool = ownedThreadPool.get();
+    }
+
+    for (size_t i = 0; i < texturePaths.size(); i++) {
+        const std::string& texturePath = texturePaths[i];
+
+        if (KtxTexture::isKtx2Path(texturePath) || CookedTexture::isCookedPath(texturePath)) {
+            continue;
+        }
+        decodeCount++;
+        threadPool->submit([&decodedMutex, &decodedCondition, &decodedImages, &properties, texturePath, asset = assets[i]] {
+            DecodedImage image = {texturePath, false, {}};
+
+            image._decoded = decodeTexture(*asset, properties._physicalDevice, properties._usage, properties._computeMipGenerator, image._texture);
+
+            // Notified under the lock: once the last image is taken the caller may return and destroy the queue
+            std::lock_guard<std::mutex> lock(decodedMutex);
+            decodedImages.push_back(std::move(image));
+            decodedCondition.notify_one();
+        });
+    }
+
+    auto waitDecodedImage = [&]() {
+        std::unique_lock<std::mutex> lock(decodedMutex);
+        decodedCondition.wait(lock, [&] { return !decodedImages.empty(); });
+        DecodedImage image = std::move(decodedImages.front());
+        decodedImages.pop_front();
+        return image;
+    };
+
+    std::deque<TextureUpload> pendingUploads;
+    std::string failedPaths;
+    size_t retrievedCount = 0;
+
+    try {
+        // Pre-encoded textures only need a copy, upload them while the pool decodes the others
+        for (size_t i = 0; i < texturePaths.size(); i++) {
+            if (KtxTexture::isKtx2Path(texturePaths[i])) {
+                this->createKtxTextureImage(texturePaths[i], assets[i], properties);
+            } else if (CookedTexture::isCookedPath(texturePaths[i])) {
+                this->createCookedTextureImage(texturePaths[i], assets[i], properties);
+            }
+            assets[i].reset();
+        }
+
+        // Images are taken in completion order, not in the order of the paths
+        for (; retrievedCount < decodeCount; retrievedCount++) {
+            DecodedImage image = waitDecodedImage();
+
+            if (!image._decoded) {
+                failedPaths += " " + image._path;
+                continue;
+            }
+            if (pendingUploads.size() >= MAX_PENDING_TEXTURE_UPLOADS) {
+                this->retireTextureUpload(pendingUploads.front(), properties);
+                pendingUploads.pop_front();
+            }
+            try {
+                const DecodedTexture& texture = image._texture;
+                pendingUploads.push_back(this->submitTextureUpload(image._path, properties, texture._selection, texture._pixels.data(), texture._width, texture._height));
+            } catch (...) {
+                retrievedCount++;
+                throw;
+            }
+        }
+    } catch (...) {
+        // Decoding tasks reference the local queue, wait for all of them before leaving
+        for (; retrievedCount < decodeCount; retrievedCount++) {
+            waitDecodedImage();
+        }
+        for (const auto& upload : pendingUploads) {
+            this->retireTextureUpload(upload, properties);
+        }
+        throw;
+    }
+
+    for (const auto& upload : pendingUploads) {
+        this->retireTextureUpload(upload, properties);
+    }
+    if (!failedPaths.empty()) {
+        throw std::runtime_error("Failed to load texture images:" + failedPaths);
+    }
+
+    // Uploads complete in decoding order, handles are returned in the order of the paths
+    std::vector<TextureHandle> handles;
+    handles.reserve(texturePaths.size());
+    for (const auto& texturePath : texturePaths) {
+        handles.push_back(_textures.find(texturePath));
+    }
+    return handles;
+}
+
+maverik::TextureHandle maverik::vk::SwapchainContext::createKtxTextureImage(const std::string& texturePath, const std::shared_ptr<FileAsset>& asset, const TextureImageCreationProperties& properties)
+{
+    KtxTexture texture(asset);
+    const std::vector<KtxTexture::Level>& levels = texture.getLevels();
+
+    if (!Utils::isFormatSampleable(properties._physicalDevice, texture.getFormat())) {
+        throw std::runtime_error("Texture format of " + texturePath + " is not supported by the device !");
+    }
+
+    // Levels are stored with the alignment vkCmdCopyBufferToImage expects, so the
+    // whole payload is copied at once and offsets are kept relative to its start.
+    uint64_t payloadBegin = levels[0]._byteOffset;
+    uint64_t payloadEnd = 0;
+    for (const auto& level : levels) {
+        payloadBegin = std::min(payloadBegin, level._byteOffset);
+        payloadEnd = std::max(payloadEnd, level._byteOffset + level._byteLength);
+    }
+
+    std::vector<VkBufferImageCopy> regions(levels.size());
+    for (uint32_t i = 0; i < levels.size(); i++) {
+        regions[i].bufferOffset = levels[i]._byteOffset - payloadBegin;
+        regions[i].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        regions[i].imageSubresource.mipLevel = i;
+        regions[i].imageSubresource.layerCount = 1;
+        regions[i].imageExtent = {
+            std::max(texture.getWidth() >> i, 1u),
+            std::max(texture.getHeight() >> i, 1u),
+            1
+        };
+    }
+
+    const char *payload = texture.getLevelData(0) - (levels[0]._byteOffset - payloadBegin);
+    return this->uploadTextureLevels(texturePath, properties, texture.getFormat(), texture.getWidth(), texture.getHeight(), payload, payloadEnd - payloadBegin, regions);
+}
+
+maverik::TextureHandle maverik::vk::SwapchainContext::createCookedTextureImage(const std::string& texturePath, const std::shared_ptr<FileAsset>& asset, const TextureImageCreationProperties& properties)
+{
+    CookedTexture texture(asset, texturePath);
+    const std::vector<CookedTexture::Level>& levels = texture.getLevels();
+    VkFormat format = static_cast<VkFormat>(texture.getFormat());
+
+    if (!Utils::isFormatSampleable(properties._physicalDevice, format)) {
+        throw std::runtime_error("Texture format of " + texturePath + " is not supported by the device !");
+    }
+
+    // Levels are stored one after the other on page boundaries, the span of the asset
+    // from the first level to the end of the last one goes to staging in one copy.
+    uint64_t payloadBegin = levels.front()._offset;
+    uint64_t payloadEnd = levels.back()._offset + levels.back()._size;
+
+    std::vector<VkBufferImageCopy> regions(levels.size());
+    for (uint32_t i = 0; i < levels.size(); i++) {
+        regions[i].bufferOffset = levels[i]._offset - payloadBegin;
+        regions[i].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        regions[i].imageSubresource.mipLevel = i;
+        regions[i].imageSubresource.layerCount = 1;
+        regions[i].imageExtent = {levels[i]._width, levels[i]._height, 1};
+    }
+
+    return this->uploadTextureLevels(texturePath, properties, format, texture.getWidth(), texture.getHeight(), texture.getData() + payloadBegin, payloadEnd - payloadBegin, regions);
+}
+
+maverik::TextureHandle maverik::vk::SwapchainContext::uploadTextureLevels(const std::string& textureName, const TextureImageCreationProperties& properties, VkFormat format, uint32_t width, uint32_t height, const char *payload, VkDeviceSize payloadSize, const std::vector<VkBufferImageCopy>& regions)
+{
+    uint32_t mipLevels = static_cast<uint32_t>(regions.size());
     VkBuffer stagingBuffer;
     VkDeviceMemory stagingBufferMemory;
 
-    if (!pixels) {
-        throw std::runtime_error("Failed to load texture image !");
+    if (properties._hostImageCopy != nullptr
+        && properties._hostImageCopy->isSupported(format, VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)) {
+        return this->copyTextureLevelsFromHost(textureName, properties, format, width, height, payload, regions);
     }
 
-    _mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
-
     Utils::CreateBufferProperties stagingBufferProperties = {
         ._logicalDevice = properties._logicalDevice,
         ._physicalDevice = properties._physicalDevice,
-        ._size = imageSize,
+        ._size = payloadSize,
         ._usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        ._properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
         ._buffer = stagingBuffer,
         ._bufferMemory = stagingBufferMemory
     };
-
     Utils::createBuffer(stagingBufferProperties);
 
     void* data;
-    vkMapMemory(properties._logicalDevice, stagingBufferMemory, 0, imageSize, 0, &data);
-        memcpy(data, pixels, static_cast<size_t>(imageSize));
+    vkMapMemory(properties._logicalDevice, stagingBufferMemory, 0, payloadSize, 0, &data);
+        memcpy(data, payload, static_cast<size_t>(payloadSize));
     vkUnmapMemory(properties._logicalDevice, stagingBufferMemory);
 
-    stbi_image_free(pixels);
+    Texture texture = {
+        ._name = textureName,
+        ._format = format,
+        ._width = width,
+        ._height = height,
+        ._mipLevels = mipLevels
+    };
 
     Utils::CreateImageProperties imageProperties = {
         ._logicalDevice = properties._logicalDevice,
         ._physicalDevice = properties._physicalDevice,
-        ._width = (uint32_t)texWidth,
-        ._height = (uint32_t)texHeight,
-        ._mipLevels = _mipLevels,
-        ._format = VK_FORMAT_R8G8B8A8_SRGB,
+        ._width = width,
+        ._height = height,
+        ._mipLevels = mipLevels,
+        ._numSamples = VK_SAMPLE_COUNT_1_BIT,
+        ._format = format,
         ._tiling = VK_IMAGE_TILING_OPTIMAL,
-        ._usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-        ._image = _textureImage[texturePath],
-        ._imageMemory = _textureImageMemory
+        ._usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        ._properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        ._image = texture._image,
+        ._imageMemory = texture._memory
     };
     Utils::createImage(imageProperties);
 
@@ -335,11 +862,13 @@ void maverik::vk::SwapchainContext::createTextureImage(const std::string& textur
         ._logicalDevice = properties._logicalDevice,
         ._commandPool = properties._commandPool,
         ._graphicsQueue = properties._graphicsQueue,
-        ._image = _textureImage[texturePath],
-        ._format = VK_FORMAT_R8G8B8A8_SRGB,
+        ._image = texture._image,
+        ._format = format,
         ._oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
         ._newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        ._mipLevels = _mipLevels
+        ._mipLevels = mipLevels,
+        ._commandAllocator = properties._commandAllocator,
+        ._resourceStateTracker = this->getResourceStateTracker(properties)
     };
     Utils::transitionImageLayout(transitionProperties);
 
@@ -348,37 +877,296 @@ void maverik::vk::SwapchainContext::createTextureImage(const std::string& textur
         ._commandPool = properties._commandPool,
         ._graphicsQueue = properties._graphicsQueue,
         ._buffer = stagingBuffer,
-        ._image = _textureImage[texturePath],
-        ._width = (uint32_t)texWidth,
-        ._height = (uint32_t)texHeight
+        ._image = texture._image,
+        ._width = width,
+        ._height = height,
+        ._commandAllocator = properties._commandAllocator,
+        ._regions = regions
     };
     Utils::copyBufferToImage(copyProperties);
 
-    Utils::GenerateMipmapsProperties propertiesMipmap = {
+    // The tracker knows the layout left by the copy
+    transitionProperties._newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    Utils::transitionImageLayout(transitionProperties);
+
+    vkDestroyBuffer(properties._logicalDevice, stagingBuffer, nullptr);
+    vkFreeMemory(properties._logicalDevice, stagingBufferMemory, nullptr);
+    return _textures.add(texture);
+}
+
+maverik::TextureHandle maverik::vk::SwapchainContext::copyTextureLevelsFromHost(const std::string& textureName, const TextureImageCreationProperties& properties, VkFormat format, uint32_t width, uint32_t height, const char *payload, const std::vector<VkBufferImageCopy>& regions)
+{
+    uint32_t mipLevels = static_cast<uint32_t>(regions.size());
+    Texture texture = {
+        ._name = textureName,
+        ._format = format,
+        ._width = width,
+        ._height = height,
+        ._mipLevels = mipLevels
+    };
+
+    Utils::CreateImageProperties imageProperties = {
+        ._logicalDevice = properties._logicalDevice,
         ._physicalDevice = properties._physicalDevice,
+        ._width = width,
+        ._height = height,
+        ._mipLevels = mipLevels,
+        ._numSamples = VK_SAMPLE_COUNT_1_BIT,
+        ._format = format,
+        ._tiling = VK_IMAGE_TILING_OPTIMAL,
+        ._usage = VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        ._properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        ._image = texture._image,
+        ._imageMemory = texture._memory
+    };
+    Utils::createImage(imageProperties);
+
+    // Copied straight into the layout it is sampled in, the device never touches the upload
+    try {
+        properties._hostImageCopy->transitionLayout(texture._image, mipLevels, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        properties._hostImageCopy->copyToImage(texture._image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, payload, regions);
+    } catch (...) {
+        vkDestroyImage(properties._logicalDevice, texture._image, nullptr);
+        vkFreeMemory(properties._logicalDevice, texture._memory, nullptr);
+        throw;
+    }
+    this->getResourceStateTracker(properties)->registerImage(texture._image, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 1, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    return _textures.add(texture);
+}
+
+maverik::vk::SwapchainContext::TextureUpload maverik::vk::SwapchainContext::submitTextureUpload(const std::string& textureName, const TextureImageCreationProperties& properties, const TextureFormat::Selection& selection, const unsigned char *pixels, uint32_t width, uint32_t height)
+{
+    VkFormat format = selection._format;
+    VkDeviceSize imageSize = static_cast<VkDeviceSize>(width) * height * selection.getBytesPerPixel();
+    uint32_t mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+    TextureUpload upload = {};
+
+    // Compute generation writes sRGB images through UNORM storage views
+    bool computeMips = this->usesComputeMipGeneration(properties, format);
+    VkImageUsageFlags usage = computeMips
+        ? VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT
+        : VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    bool hostCopy = properties._hostImageCopy != nullptr
+        && properties._hostImageCopy->isSupported(format, usage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+    if (!hostCopy) {
+        Utils::CreateBufferProperties stagingBufferProperties = {
+            ._logicalDevice = properties._logicalDevice,
+            ._physicalDevice = properties._physicalDevice,
+            ._size = imageSize,
+            ._usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            ._properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            ._buffer = upload._stagingBuffer,
+            ._bufferMemory = upload._stagingBufferMemory
+        };
+        Utils::createBuffer(stagingBufferProperties);
+
+        void* data;
+        vkMapMemory(properties._logicalDevice, upload._stagingBufferMemory, 0, imageSize, 0, &data);
+            memcpy(data, pixels, static_cast<size_t>(imageSize));
+        vkUnmapMemory(properties._logicalDevice, upload._stagingBufferMemory);
+    }
+
+    Texture texture = {
+        ._name = textureName,
+        ._format = format,
+        ._width = width,
+        ._height = height,
+        ._mipLevels = mipLevels,
+        ._swizzle = selection._swizzle
+    };
+
+    Utils::CreateImageProperties imageProperties = {
         ._logicalDevice = properties._logicalDevice,
-        ._commandPool = properties._commandPool,
-        ._graphicsQueue = properties._graphicsQueue,
-        ._image = _textureImage[texturePath],
-        ._mipLevels = _mipLevels,
-        ._texWidth = (uint32_t)texWidth,
-        ._texHeight = (uint32_t)texHeight,
-        ._imageFormat = VK_FORMAT_R8G8B8A8_SRGB
+        ._physicalDevice = properties._physicalDevice,
+        ._width = width,
+        ._height = height,
+        ._mipLevels = mipLevels,
+        ._numSamples = VK_SAMPLE_COUNT_1_BIT,
+        ._format = format,
+        ._tiling = VK_IMAGE_TILING_OPTIMAL,
+        ._usage = hostCopy ? usage | VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT : usage,
+        ._properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        ._image = texture._image,
+        ._imageMemory = texture._memory,
+        ._flags = computeMips ? VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT : 0u
     };
-    Utils::generateMipmaps(propertiesMipmap);
+    Utils::createImage(imageProperties);
 
-    vkDestroyBuffer(properties._logicalDevice, stagingBuffer, nullptr);
-    vkFreeMemory(properties._logicalDevice, stagingBufferMemory, nullptr);
+    // The base level written from the host is made visible to the device by the submission
+    VkBufferImageCopy region = getBaseLevelRegion(width, height);
+    ResourceStateTracker *tracker = this->getResourceStateTracker(properties);
+    if (hostCopy) {
+        properties._hostImageCopy->transitionLayout(texture._image, mipLevels, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        properties._hostImageCopy->copyToImage(texture._image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, reinterpret_cast<const char *>(pixels), {region});
+        tracker->registerImage(texture._image, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    } else {
+        tracker->registerImage(texture._image, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels);
+    }
+
+    // The upload outlives the frame, so it never comes from the per-frame pools
+    if (properties._commandAllocator != nullptr) {
+        upload._commandBuffer = properties._commandAllocator->allocateImmediate();
+    } else {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = properties._commandPool;
+        allocInfo.commandBufferCount = 1;
+        vkAllocateCommandBuffers(properties._logicalDevice, &allocInfo, &upload._commandBuffer);
+    }
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(upload._commandBuffer, &beginInfo);
+
+    if (!hostCopy) {
+        tracker->require(texture._image, ResourceStateTracker::Usage::TRANSFER_DST);
+        tracker->flush(upload._commandBuffer);
+
+        vkCmdCopyBufferToImage(upload._commandBuffer, upload._stagingBuffer, texture._image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+    }
+
+    if (computeMips) {
+        ComputeMipGenerator::MipGenerationProperties generationProperties = {
+            ._image = texture._image,
+            ._format = format,
+            ._width = width,
+            ._height = height,
+            ._mipLevels = mipLevels,
+            ._alphaWeighted = properties._usage == TextureFormat::Usage::COLOR,
+            ._resourceStateTracker = tracker
+        };
+        upload._mipGeneration = properties._computeMipGenerator->record(upload._commandBuffer, generationProperties);
+    } else {
+        Utils::GenerateMipmapsProperties propertiesMipmap = {
+            ._physicalDevice = properties._physicalDevice,
+            ._logicalDevice = properties._logicalDevice,
+            ._commandPool = properties._commandPool,
+            ._graphicsQueue = properties._graphicsQueue,
+            ._image = texture._image,
+            ._imageFormat = format,
+            ._texWidth = width,
+            ._texHeight = height,
+            ._mipLevels = mipLevels,
+            ._commandAllocator = nullptr
+        };
+        Utils::recordGenerateMipmaps(upload._commandBuffer, propertiesMipmap);
+        tracker->registerImage(texture._image, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 1, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+
+    vkEndCommandBuffer(upload._commandBuffer);
+
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    if (vkCreateFence(properties._logicalDevice, &fenceInfo, nullptr, &upload._fence) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create texture upload fence!");
+    }
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &upload._commandBuffer;
+    if (vkQueueSubmit(properties._graphicsQueue, 1, &submitInfo, upload._fence) != VK_SUCCESS) {
+        throw std::runtime_error("failed to submit texture upload!");
+    }
+    _textures.add(texture);
+    return upload;
+}
+
+void maverik::vk::SwapchainContext::retireTextureUpload(const TextureUpload& upload, const TextureImageCreationProperties& properties)
+{
+    vkWaitForFences(properties._logicalDevice, 1, &upload._fence, VK_TRUE, UINT64_MAX);
+    vkDestroyFence(properties._logicalDevice, upload._fence, nullptr);
+    if (properties._commandAllocator != nullptr) {
+        properties._commandAllocator->recycle(upload._commandBuffer);
+    } else {
+        vkFreeCommandBuffers(properties._logicalDevice, properties._commandPool, 1, &upload._commandBuffer);
+    }
+    vkDestroyBuffer(properties._logicalDevice, upload._stagingBuffer, nullptr);
+    vkFreeMemory(properties._logicalDevice, upload._stagingBufferMemory, nullptr);
+    if (properties._computeMipGenerator != nullptr) {
+        properties._computeMipGenerator->release(upload._mipGeneration);
+    }
+}
+
+bool maverik::vk::SwapchainContext::usesComputeMipGeneration(const TextureImageCreationProperties& properties, VkFormat format) const
+{
+    return properties._computeMipGenerator != nullptr
+        && ComputeMipGenerator::isFormatSupported(properties._physicalDevice, format);
+}
+
+maverik::ResourceStateTracker *maverik::vk::SwapchainContext::getResourceStateTracker(const TextureImageCreationProperties& properties)
+{
+    if (properties._resourceStateTracker != nullptr) {
+        return properties._resourceStateTracker;
+    }
+    if (_ownedResourceStateTracker == nullptr) {
+        _ownedResourceStateTracker = std::make_unique<ResourceStateTracker>(properties._logicalDevice, false);
+    }
+    return _ownedResourceStateTracker.get();
+}
+
+uint32_t maverik::vk::SwapchainContext::registerBindlessTexture(TextureHandle texture)
+{
+    if (_creationProperties._bindlessTextureTable == nullptr) {
+        throw std::runtime_error("Bindless textures are not supported by the device !");
+    }
+
+    Texture& registered = _textures.get(texture);
+    if (registered._view == VK_NULL_HANDLE || registered._sampler == VK_NULL_HANDLE) {
+        throw std::runtime_error("Texture " + registered._name + " has no image view or sampler !");
+    }
+
+    if (registered._bindlessSlot != UINT32_MAX) {
+        _creationProperties._bindlessTextureTable->updateTexture(registered._bindlessSlot, registered._view, registered._sampler);
+    } else {
+        registered._bindlessSlot = _creationProperties._bindlessTextureTable->registerTexture(registered._view, registered._sampler);
+    }
+    return registered._bindlessSlot;
+}
+
+void maverik::vk::SwapchainContext::bindDescriptorSets(VkCommandBuffer commandBuffer, uint32_t currentFrame)
+{
+    std::vector<VkDescriptorSet> descriptorSets = {_descriptorSets[currentFrame]};
+
+    if (_creationProperties._bindlessTextureTable != nullptr) {
+        descriptorSets.push_back(_creationProperties._bindlessTextureTable->getDescriptorSet());
+    }
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _pipelineLayout, 0, static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(), 0, nullptr);
+}
+
+void maverik::vk::SwapchainContext::setMaterial(VkCommandBuffer commandBuffer, uint32_t textureSlot)
+{
+    vkCmdPushConstants(commandBuffer, _pipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uint32_t), &textureSlot);
+}
+
+void maverik::vk::SwapchainContext::setMaterial(VkCommandBuffer commandBuffer, TextureHandle texture)
+{
+    const Texture& registered = _textures.get(texture);
+
+    if (registered._bindlessSlot == UINT32_MAX) {
+        throw std::runtime_error("Texture " + registered._name + " is not registered as a bindless texture !");
+    }
+    this->setMaterial(commandBuffer, registered._bindlessSlot);
+}
+
+maverik::TextureHandle maverik::vk::SwapchainContext::getTextureHandle(const std::string& textureName) const
+{
+    return _textures.find(textureName);
 }
 
 void maverik::vk::SwapchainContext::createTextureImageView(VkDevice logicalDevice)
 {
-    for (const auto& [textureName, textureImage] : _textureImage) {
-        _textureImageView[textureName] = Utils::createImageView(textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT, logicalDevice, _mipLevels);
+    for (auto& texture : _textures.getTextures()) {
+        if (texture._view == VK_NULL_HANDLE) {
+            texture._view = Utils::createImageView(texture._image, texture._format, VK_IMAGE_ASPECT_COLOR_BIT, logicalDevice, texture._mipLevels, VK_IMAGE_USAGE_SAMPLED_BIT, texture._swizzle);
+        }
     }
 }
 
-void maverik::vk::SwapchainContext::createTextureSampler(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, const std::string& textureName, VkSamplerCreateInfo samplerInfo)
+void maverik::vk::SwapchainContext::createTextureSampler(VkDevice logicalDevice, VkPhysicalDevice physicalDevice, TextureHandle texture, VkSamplerCreateInfo samplerInfo)
 {
     VkPhysicalDeviceProperties properties{};
     vkGetPhysicalDeviceProperties(physicalDevice, &properties);
@@ -389,8 +1177,20 @@ void maverik::vk::SwapchainContext::createTextureSampler(VkDevice logicalDevice,
         samplerInfo = this->getDefaultSamplerInfo(properties);
     }
 
-    if (vkCreateSampler(logicalDevice, &samplerInfo, nullptr, &_textureSampler[textureName]) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create texture sampler for " + textureName + " !");
+    Texture& registered = _textures.get(texture);
+    SamplerCache *samplerCache = _creationProperties._samplerCache;
+    if (samplerCache != nullptr) {
+        VkSampler sampler = samplerCache->acquire(samplerInfo);
+
+        if (registered._sampler != VK_NULL_HANDLE) {
+            samplerCache->release(registered._sampler);
+        }
+        registered._sampler = sampler;
+        return;
+    }
+
+    if (vkCreateSampler(logicalDevice, &samplerInfo, nullptr, &registered._sampler) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create texture sampler for " + registered._name + " !");
     }
 }
 
@@ -473,132 +1273,36 @@ void maverik::vk::SwapchainContext::createRenderPass()
 
 void maverik::vk::SwapchainContext::createGraphicsPipeline()
 {
-    auto vertShaderCode = Utils::readFile("shaders/vert.spv");
-    auto fragShaderCode = Utils::readFile("shaders/frag.spv");
-
-    VkShaderModule vertShaderModule = Utils::createShaderModule(_creationProperties._logicalDevice, vertShaderCode);
-    VkShaderModule fragShaderModule = Utils::createShaderModule(_creationProperties._logicalDevice, fragShaderCode);
-
-    VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
-    vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vertShaderStageInfo.module = vertShaderModule;
-    vertShaderStageInfo.pName = "main";
-
-    VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
-    fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    fragShaderStageInfo.module = fragShaderModule;
-    fragShaderStageInfo.pName = "main";
-
-    VkPipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageInfo, fragShaderStageInfo};
-
-    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-
-    auto bindingDescription = Vertex::getBindingDescription();
-    auto attributeDescriptions = Vertex::getAttributeDescriptions();
-
-    vertexInputInfo.vertexBindingDescriptionCount = 1;
-    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-    vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
-
-    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
-    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-    inputAssembly.primitiveRestartEnable = VK_FALSE;
-
-    VkPipelineViewportStateCreateInfo viewportState{};
-    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-    viewportState.viewportCount = 1;
-    viewportState.scissorCount = 1;
-
-    VkPipelineRasterizationStateCreateInfo rasterizer{};
-    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-    rasterizer.depthClampEnable = VK_FALSE;
-    rasterizer.rasterizerDiscardEnable = VK_FALSE;
-    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-    rasterizer.lineWidth = 1.0f;
-    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-    rasterizer.depthBiasEnable = VK_FALSE;
-
-    VkPipelineMultisampleStateCreateInfo multisampling{};
-    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    multisampling.sampleShadingEnable = VK_FALSE;
-    multisampling.rasterizationSamples = _creationProperties._msaaSamples;
-    multisampling.sampleShadingEnable = VK_TRUE;
-    multisampling.minSampleShading = .2f;
-
-    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    colorBlendAttachment.blendEnable = VK_FALSE;
-
-    VkPipelineColorBlendStateCreateInfo colorBlending{};
-    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-    colorBlending.logicOpEnable = VK_FALSE;
-    colorBlending.logicOp = VK_LOGIC_OP_COPY;
-    colorBlending.attachmentCount = 1;
-    colorBlending.pAttachments = &colorBlendAttachment;
-    colorBlending.blendConstants[0] = 0.0f;
-    colorBlending.blendConstants[1] = 0.0f;
-    colorBlending.blendConstants[2] = 0.0f;
-    colorBlending.blendConstants[3] = 0.0f;
-
-    std::vector<VkDynamicState> dynamicStates = {
-        VK_DYNAMIC_STATE_VIEWPORT,
-        VK_DYNAMIC_STATE_SCISSOR
-    };
-    VkPipelineDynamicStateCreateInfo dynamicState{};
-    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-    dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
-    dynamicState.pDynamicStates = dynamicStates.data();
+    std::vector<VkDescriptorSetLayout> setLayouts = {_descriptorSetLayout};
+    VkPushConstantRange materialRange{};
+    materialRange.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    materialRange.offset = 0;
+    materialRange.size = sizeof(uint32_t);
 
     VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
     pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 1;
-    pipelineLayoutInfo.pSetLayouts = &_descriptorSetLayout;
+    // In bindless mode, set 1 is the texture array and the material index is a push constant
+    if (_creationProperties._bindlessTextureTable != nullptr) {
+        setLayouts.push_back(_creationProperties._bindlessTextureTable->getDescriptorSetLayout());
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &materialRange;
+    }
+    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+    pipelineLayoutInfo.pSetLayouts = setLayouts.data();
 
     if (vkCreatePipelineLayout(_creationProperties._logicalDevice, &pipelineLayoutInfo, nullptr, &_pipelineLayout) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create pipeline layout !");
     }
 
-    VkPipelineDepthStencilStateCreateInfo depthStencil{};
-    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-    depthStencil.depthTestEnable = VK_TRUE;
-    depthStencil.depthWriteEnable = VK_TRUE;
-    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
-    depthStencil.depthBoundsTestEnable = VK_FALSE;
-    depthStencil.minDepthBounds = 0.0f;
-    depthStencil.maxDepthBounds = 1.0f;
-    depthStencil.stencilTestEnable = VK_FALSE;
-    depthStencil.front = {};
-    depthStencil.back = {};
-
-    VkGraphicsPipelineCreateInfo pipelineInfo{};
-    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.stageCount = 2;
-    pipelineInfo.pStages = shaderStages;
-    pipelineInfo.pVertexInputState = &vertexInputInfo;
-    pipelineInfo.pInputAssemblyState = &inputAssembly;
-    pipelineInfo.pViewportState = &viewportState;
-    pipelineInfo.pRasterizationState = &rasterizer;
-    pipelineInfo.pMultisampleState = &multisampling;
-    pipelineInfo.pColorBlendState = &colorBlending;
-    pipelineInfo.pDynamicState = &dynamicState;
-    pipelineInfo.layout = _pipelineLayout;
-    pipelineInfo.renderPass = _renderPass;
-    pipelineInfo.subpass = 0;
-    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
-    pipelineInfo.pDepthStencilState = &depthStencil;
-
-    if (vkCreateGraphicsPipelines(_creationProperties._logicalDevice, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &_graphicsPipeline) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create graphics pipeline !");
-    }
-
-    vkDestroyShaderModule(_creationProperties._logicalDevice, fragShaderModule, nullptr);
-    vkDestroyShaderModule(_creationProperties._logicalDevice, vertShaderModule, nullptr);
+    PipelineStateCache::PipelineStateCacheCreationProperties pipelineStateCacheProperties = {
+        ._logicalDevice = _creationProperties._logicalDevice,
+        ._pipelineCache = _creationProperties._pipelineCache
+    };
+    _pipelineStateCache = std::make_unique<PipelineStateCache>(pipelineStateCacheProperties);
+
+    // Only the regular pipeline is needed before the first frame, the instanced one compiles on a worker meanwhile
+    _pipelineStateCache->request(this->getPipelineDescription(true));
+    _graphicsPipeline = _pipelineStateCache->acquire(this->getPipelineDescription());
 }
 
 /////////////////////
@@ -664,7 +1368,7 @@ void maverik::vk::SwapchainContext::createColorResources(VkDevice logicalDevice,
     };
 
     Utils::createImage(imageProperties);
-    _colorImageView = Utils::createImageView(_colorImage, colorFormat, VK_IMAGE_ASPECT_COLOR_BIT, logicalDevice, _mipLevels);
+    _colorImageView = Utils::createImageView(_colorImage, colorFormat, VK_IMAGE_ASPECT_COLOR_BIT, logicalDevice, 1);
 }
 
 void maverik::vk::SwapchainContext::createDepthResources(const TextureImageCreationProperties& properties)
@@ -684,7 +1388,7 @@ void maverik::vk::SwapchainContext::createDepthResources(const TextureImageCreat
     };
 
     Utils::createImage(depthImageProperties);
-    _depthImageView = Utils::createImageView(_depthImage, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT, properties._logicalDevice, _mipLevels);
+    _depthImageView = Utils::createImageView(_depthImage, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT, properties._logicalDevice, 1);
 
     Utils::TransitionImageLayoutProperties transitionProperties = {
         ._logicalDevice = properties._logicalDevice,
@@ -694,7 +1398,9 @@ void maverik::vk::SwapchainContext::createDepthResources(const TextureImageCreat
         ._format = depthFormat,
         ._oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
         ._newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-        ._mipLevels = 1 // No mipmaps for depth attachment
+        ._mipLevels = 1, // No mipmaps for depth attachment
+        ._commandAllocator = properties._commandAllocator,
+        ._resourceStateTracker = this->getResourceStateTracker(properties)
     };
     Utils::transitionImageLayout(transitionProperties);
 }
@@ -717,7 +1423,9 @@ VkSamplerCreateInfo maverik::vk::SwapchainContext::getDefaultSamplerInfo(const V
     samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
     samplerInfo.mipLodBias = 0.0f;
     samplerInfo.minLod = 0.0f;
-    samplerInfo.maxLod = static_cast<float>(_mipLevels);
+    // The view already limits sampling to the mip levels of the texture, leaving maxLod
+    // unclamped lets textures with different mip counts share the same sampler.
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
     return samplerInfo;
 }
 
@@ -32,6 +32,8 @@ maverik::xr::GraphicalContext::GraphicalContext(const GraphicalContextProperties
     swapchainProperties._msaaSamples = vulkanContext->msaaSamples;
     swapchainProperties._commandPool = vulkanContext->commandPool;
     swapchainProperties._graphicsQueue = vulkanContext->graphicsQueue;
+    swapchainProperties._pipelineCache = vulkanContext->pipelineCache->getHandle();
+    swapchainProperties._resourceStateTracker = vulkanContext->resourceStateTracker.get();
 
     _swapchainContext = std::make_shared<maverik::xr::SwapchainContext>(swapchainProperties);
 
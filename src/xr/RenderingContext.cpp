@@ -14,9 +14,15 @@ maverik::xr::RenderingContext::RenderingContext(const RenderingContextProperties
     pickPhysicalDevice(_vulkanInstance);
     createLogicalDevice();
     createCommandPool();
+    createCommandAllocator(MAX_FRAMES_IN_FLIGHT);
+    createSamplerCache();
+    createPipelineCache();
+    createResourceStateTracker();
     _msaaSamples = getMaxUsableSampleCount();
 
-    _vulkanContext = std::make_shared<VulkanContext>(_logicalDevice, _physicalDevice, _graphicsQueue, _commandPool, Utils::findQueueFamilies(_physicalDevice).graphicsFamily.value(), _msaaSamples);
+    _vulkanContext = std::make_shared<VulkanContext>(_logicalDevice, _physicalDevice, _graphicsQueue, _commandPool, Utils::findQueueFamilies(_physicalDevice).graphicsFamily.value(), _msaaSamples, _commandAllocator, _capabilities, _bindlessTextureTable, _samplerCache);
+    _vulkanContext->pipelineCache = _pipelineCache;
+    _vulkanContext->resourceStateTracker = _resourceStateTracker;
 }
 
 maverik::xr::RenderingContext::~RenderingContext()
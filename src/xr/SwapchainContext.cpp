@@ -15,7 +15,9 @@ maverik::xr::SwapchainContext::SwapchainContext(const SwapchainContextCreationPr
     _device(properties._device),
     _msaaSamples(properties._msaaSamples),
     _commandPool(properties._commandPool),
-    _graphicsQueue(properties._graphicsQueue)
+    _graphicsQueue(properties._graphicsQueue),
+    _pipelineCache(properties._pipelineCache),
+    _resourceStateTracker(properties._resourceStateTracker)
 {
     init();
 }
@@ -115,6 +117,7 @@ std::shared_ptr<maverik::xr::SwapChainImage> maverik::xr::SwapchainContext::crea
     properties._swapchainCreateInfo = swapchainCreateInfo;
     properties._commandPool = _commandPool;
     properties._graphicsQueue = _graphicsQueue;
+    properties._resourceStateTracker = _resourceStateTracker;
 
     std::shared_ptr<maverik::xr::SwapChainImage> swapchainImage = std::make_shared<SwapChainImage>();
     swapchainImage->init(properties);
@@ -130,6 +133,7 @@ void maverik::xr::SwapChainImage::init(const SwapchainImageCreationPropertiesXR
 
     _commandPool = properties._commandPool;
     _graphicsQueue = properties._graphicsQueue;
+    _resourceStateTracker = properties._resourceStateTracker;
 
     _swapchainImageFormat = static_cast<VkFormat>(properties._swapchainCreateInfo.format);
     _swapchainExtent = {properties._swapchainCreateInfo.width, properties._swapchainCreateInfo.height};
@@ -198,7 +202,8 @@ void maverik::xr::SwapChainImage::createColorResources()
         ._format = _swapchainImageFormat,
         ._oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
         ._newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-        ._mipLevels = 1
+        ._mipLevels = 1,
+        ._resourceStateTracker = _resourceStateTracker
     };
     Utils::transitionImageLayout(transitionProperties);
 }
@@ -245,7 +250,8 @@ void maverik::xr::SwapChainImage::createDepthResources()
         ._format = depthFormat,
         ._oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
         ._newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-        ._mipLevels = 1
+        ._mipLevels = 1,
+        ._resourceStateTracker = _resourceStateTracker
     };
     Utils::transitionImageLayout(transitionProperties);
 
@@ -282,7 +288,8 @@ void maverik::xr::SwapChainImage::createFrameBuffers()
         ._format = _swapchainImageFormat,
         ._oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
         ._newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-        ._mipLevels = 1
+        ._mipLevels = 1,
+        ._resourceStateTracker = _resourceStateTracker
     };
     Utils::transitionImageLayout(transitionProperties);
 }
@@ -480,7 +487,7 @@ void maverik::xr::SwapchainContext::createGraphicsPipeline()
     pipelineInfo.subpass = 0;
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
-    if (vkCreateGraphicsPipelines(_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &_graphicsPipeline) != VK_SUCCESS) {
+    if (vkCreateGraphicsPipelines(_device, _pipelineCache, 1, &pipelineInfo, nullptr, &_graphicsPipeline) != VK_SUCCESS) {
         std::cerr << "Failed to create graphics pipeline" << std::endl;
         return;
     }
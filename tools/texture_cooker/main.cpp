@@ -0,0 +1,76 @@
+/*
+** ETIB PROJECT, 2025
+** maverik
+** File description:
+** Offline texture cooker
+*/
+
+#include "MipGenerator.hpp"
+#include "CookedTexture.hpp"
+
+#include <iostream>
+#include <string>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+static void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [--box | --kaiser] [--linear] <input_image> <output.mvktex>" << std::endl;
+    std::cerr << "  --box      Use a 2x2 box filter for the mip levels" << std::endl;
+    std::cerr << "  --kaiser   Use a Kaiser-windowed sinc filter for the mip levels (default)" << std::endl;
+    std::cerr << "  --linear   Treat the color channels as linear (normal maps, masks) instead of sRGB" << std::endl;
+}
+
+int main(int ac, char **av)
+{
+    maverik::MipGenerator::Filter filter = maverik::MipGenerator::Filter::KAISER;
+    bool srgb = true;
+    std::string input;
+    std::string output;
+
+    for (int i = 1; i < ac; i++) {
+        std::string argument = av[i];
+
+        if (argument == "--box") {
+            filter = maverik::MipGenerator::Filter::BOX;
+        } else if (argument == "--kaiser") {
+            filter = maverik::MipGenerator::Filter::KAISER;
+        } else if (argument == "--linear") {
+            srgb = false;
+        } else if (input.empty()) {
+            input = argument;
+        } else if (output.empty()) {
+            output = argument;
+        } else {
+            printUsage(av[0]);
+            return 1;
+        }
+    }
+    if (input.empty() || output.empty()) {
+        printUsage(av[0]);
+        return 1;
+    }
+
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    stbi_uc *pixels = stbi_load(input.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+
+    if (!pixels) {
+        std::cerr << "Failed to load " << input << ": " << stbi_failure_reason() << std::endl;
+        return 1;
+    }
+
+    auto levels = maverik::MipGenerator::generate(pixels, static_cast<uint32_t>(width), static_cast<uint32_t>(height), filter, srgb);
+    stbi_image_free(pixels);
+
+    try {
+        maverik::CookedTexture::write(output, srgb ? maverik::CookedTexture::FORMAT_R8G8B8A8_SRGB : maverik::CookedTexture::FORMAT_R8G8B8A8_UNORM, levels);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    std::cout << "Cooked " << input << " (" << width << "x" << height << ", " << levels.size() << " levels) into " << output << std::endl;
+    return 0;
+}